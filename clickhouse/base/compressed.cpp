@@ -1,6 +1,7 @@
 #include "compressed.h"
 #include "wire_format.h"
 #include "output.h"
+#include "stopwatch.h"
 #include "clickhouse/exceptions.h"
 
 #include <city.h>
@@ -27,8 +28,9 @@ constexpr size_t DBMS_MAX_COMPRESSED_SIZE = 0x40000000ULL;   // 1GB
 
 namespace clickhouse {
 
-CompressedInput::CompressedInput(InputStream* input)
+CompressedInput::CompressedInput(InputStream* input, ClientStats* stats)
     : input_(input)
+    , stats_(stats)
 {
 }
 
@@ -54,7 +56,39 @@ size_t CompressedInput::DoNext(const void** ptr, size_t len) {
     return mem_.Next(ptr, len);
 }
 
+size_t CompressedInput::DoRead(void* buf, size_t len) {
+    if (mem_.Exhausted()) {
+        if (!ReadChunk()) {
+            return 0;
+        }
+
+        if (original_size_ <= len) {
+            // Whole chunk fits into destination, decompress it there directly.
+            DecompressChunk(buf);
+            return original_size_;
+        }
+
+        data_.resize(original_size_);
+        DecompressChunk(data_.data());
+        mem_.Reset(data_.data(), original_size_);
+    }
+
+    return mem_.Read(buf, len);
+}
+
 bool CompressedInput::Decompress() {
+    if (!ReadChunk()) {
+        return false;
+    }
+
+    data_.resize(original_size_);
+    DecompressChunk(data_.data());
+    mem_.Reset(data_.data(), original_size_);
+
+    return true;
+}
+
+bool CompressedInput::ReadChunk() {
     cityhash::uint128 hash;
     uint32_t compressed = 0;
     uint32_t original = 0;
@@ -81,65 +115,75 @@ bool CompressedInput::Decompress() {
     if (compressed > DBMS_MAX_COMPRESSED_SIZE) {
         throw CompressionError("compressed data too big");
     }
+    if (compressed < HEADER_SIZE) {
+        throw CompressionError("compressed data too small");
+    }
 
-    Buffer tmp(compressed);
+    compressed_.resize(compressed);
 
     // Data header
     {
-        BufferOutput out(&tmp);
+        ArrayOutput out(compressed_.data(), HEADER_SIZE);
         out.Write(&method, sizeof(method));
         out.Write(&compressed, sizeof(compressed));
         out.Write(&original, sizeof(original));
-        out.Flush();
     }
 
-    if (!WireFormat::ReadBytes(*input_, tmp.data() + HEADER_SIZE, compressed - HEADER_SIZE)) {
+    if (!WireFormat::ReadBytes(*input_, compressed_.data() + HEADER_SIZE, compressed - HEADER_SIZE)) {
         return false;
     } else {
-        if (hash != cityhash::CityHash128((const char*)tmp.data(), compressed)) {
+        if (hash != cityhash::CityHash128((const char*)compressed_.data(), compressed)) {
             throw CompressionError("data was corrupted");
         }
     }
 
-    data_ = Buffer(original);
+    method_ = method;
+    original_size_ = original;
+
+    if (stats_) {
+        stats_->compressed_bytes_received += compressed + sizeof(hash);
+        stats_->uncompressed_bytes_received += original;
+    }
 
-    switch (method) {
+    return true;
+}
+
+void CompressedInput::DecompressChunk(void* dest) {
+    const size_t compressed = compressed_.size();
+    ScopedTimer timer(stats_ ? &stats_->decompression_ns : nullptr);
+
+    switch (method_) {
     case static_cast<uint8_t>(CompressionMethodByte::LZ4): {
-        if (LZ4_decompress_safe((const char*)tmp.data() + HEADER_SIZE, (char*)data_.data(), static_cast<int>(compressed - HEADER_SIZE), original) < 0) {
+        if (LZ4_decompress_safe((const char*)compressed_.data() + HEADER_SIZE, (char*)dest, static_cast<int>(compressed - HEADER_SIZE), original_size_) < 0) {
             throw CompressionError("can't decompress LZ4-encoded data");
-        } else {
-            mem_.Reset(data_.data(), original);
         }
-        return true;
+        break;
     }
 
     case static_cast<uint8_t>(CompressionMethodByte::ZSTD): {
-        size_t res = ZSTD_decompress((char*)data_.data(), original, (const char*)tmp.data() + HEADER_SIZE, static_cast<int>(compressed - HEADER_SIZE));
+        size_t res = ZSTD_decompress((char*)dest, original_size_, (const char*)compressed_.data() + HEADER_SIZE, static_cast<int>(compressed - HEADER_SIZE));
 
         if (ZSTD_isError(res)) {
             throw CompressionError("can't decompress ZSTD-encoded data, ZSTD error: " + std::string(ZSTD_getErrorName(res)));
-        } else {
-            mem_.Reset(data_.data(), original);
         }
-        return true;
+        break;
     }
 
     case static_cast<uint8_t>(CompressionMethodByte::NONE): {
-        throw CompressionError("compression method not defined" + std::to_string((method)));
+        throw CompressionError("compression method not defined" + std::to_string((method_)));
     }
     default: {
-        throw CompressionError("Unknown or unsupported compression method " + std::to_string((method)));
+        throw CompressionError("Unknown or unsupported compression method " + std::to_string((method_)));
     }
     }
-
-    return true;
 }
 
 
-CompressedOutput::CompressedOutput(OutputStream * destination, size_t max_compressed_chunk_size, CompressionMethod method)
+CompressedOutput::CompressedOutput(OutputStream * destination, size_t max_compressed_chunk_size, CompressionMethod method, ClientStats* stats)
     : destination_(destination)
     , max_compressed_chunk_size_(max_compressed_chunk_size)
     , method_(method)
+    , stats_(stats)
 {
     PreallocateCompressBuffer(max_compressed_chunk_size);
 }
@@ -170,6 +214,8 @@ void CompressedOutput::DoFlush() {
 }
 
 void CompressedOutput::Compress(const void * data, size_t len) {
+    const Stopwatch watch;
+
     switch (method_) {  
     case clickhouse::CompressionMethod::LZ4: {
         const auto compressed_size = LZ4_compress_default(
@@ -190,7 +236,10 @@ void CompressedOutput::Compress(const void * data, size_t len) {
             WriteUnaligned(header + 5, static_cast<uint32_t>(len));
         }
 
-        WireFormat::WriteFixed(*destination_, cityhash::CityHash128((const char*)compressed_buffer_.data(), compressed_size + HEADER_SIZE));
+        const auto hash = cityhash::CityHash128((const char*)compressed_buffer_.data(), compressed_size + HEADER_SIZE);
+        UpdateStats(watch, len, sizeof(hash) + compressed_size + HEADER_SIZE);
+
+        WireFormat::WriteFixed(*destination_, hash);
         WireFormat::WriteBytes(*destination_, compressed_buffer_.data(), compressed_size + HEADER_SIZE);
         break;
     }
@@ -215,7 +264,10 @@ void CompressedOutput::Compress(const void * data, size_t len) {
             WriteUnaligned(header + 5, static_cast<uint32_t>(len));
         }
 
-        WireFormat::WriteFixed(*destination_, cityhash::CityHash128((const char*)compressed_buffer_.data(), compressed_size + HEADER_SIZE));
+        const auto hash = cityhash::CityHash128((const char*)compressed_buffer_.data(), compressed_size + HEADER_SIZE);
+        UpdateStats(watch, len, sizeof(hash) + compressed_size + HEADER_SIZE);
+
+        WireFormat::WriteFixed(*destination_, hash);
         WireFormat::WriteBytes(*destination_, compressed_buffer_.data(), compressed_size + HEADER_SIZE);
         break;
     }
@@ -228,6 +280,14 @@ void CompressedOutput::Compress(const void * data, size_t len) {
     destination_->Flush();
 }
 
+void CompressedOutput::UpdateStats(const Stopwatch& watch, size_t original_size, size_t compressed_size) {
+    if (stats_) {
+        stats_->compression_ns += watch.ElapsedNanoseconds();
+        stats_->compressed_bytes_sent += compressed_size;
+        stats_->uncompressed_bytes_sent += original_size;
+    }
+}
+
 void CompressedOutput::PreallocateCompressBuffer(size_t input_size) {
     switch (method_) {  
     case clickhouse::CompressionMethod::LZ4: {
@@ -8,26 +8,43 @@
 
 namespace clickhouse {
 
+class Stopwatch;
+
 class CompressedInput : public ZeroCopyInput {
 public:
-    explicit CompressedInput(InputStream* input);
+    /// If `stats` is set, sizes of the chunks and time spent in decompression are added to it.
+    explicit CompressedInput(InputStream* input, ClientStats* stats = nullptr);
     ~CompressedInput() override;
 
 protected:
     size_t DoNext(const void** ptr, size_t len) override;
+    size_t DoRead(void* buf, size_t len) override;
 
     bool Decompress();
 
+private:
+    /// Reads and validates next compressed chunk, returns false if the input ended.
+    bool ReadChunk();
+    /// Decompresses the chunk read by ReadChunk() into `dest`, which must hold `original_size_` bytes.
+    void DecompressChunk(void* dest);
+
 private:
     InputStream* const input_;
+    ClientStats* const stats_;
 
     Buffer data_;
     ArrayInput mem_;
+
+    /// Last chunk read, including the header.
+    Buffer compressed_;
+    uint8_t method_ = 0;
+    uint32_t original_size_ = 0;
 };
 
 class CompressedOutput : public OutputStream {
 public:
-    explicit CompressedOutput(OutputStream* destination, size_t max_compressed_chunk_size = 0, CompressionMethod method = CompressionMethod::LZ4);
+    explicit CompressedOutput(OutputStream* destination, size_t max_compressed_chunk_size = 0, CompressionMethod method = CompressionMethod::LZ4,
+        ClientStats* stats = nullptr);
     ~CompressedOutput() override;
 
 protected:
@@ -37,12 +54,14 @@ protected:
 private:
     void Compress(const void * data, size_t len);
     void PreallocateCompressBuffer(size_t input_size);
+    void UpdateStats(const Stopwatch& watch, size_t original_size, size_t compressed_size);
 
 private:
     OutputStream * destination_;
     const size_t max_compressed_chunk_size_;
     Buffer compressed_buffer_;
     CompressionMethod method_;
+    ClientStats* const stats_;
 };
 
 }
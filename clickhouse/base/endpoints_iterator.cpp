@@ -1,8 +1,72 @@
 #include "endpoints_iterator.h"
 #include <clickhouse/client.h>
 
+#include <algorithm>
+
 namespace clickhouse {
 
+EndpointsStats::EndpointsStats(EndpointsStatsParams params)
+    : params_(std::move(params))
+{
+}
+
+void EndpointsStats::OnRequestStart(const Endpoint& endpoint)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++states_[{endpoint.host, endpoint.port}].outstanding;
+}
+
+void EndpointsStats::OnRequestFinish(const Endpoint& endpoint, std::chrono::nanoseconds latency, bool success)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    State& state = states_[{endpoint.host, endpoint.port}];
+    if (state.outstanding) {
+        --state.outstanding;
+    }
+
+    if (success) {
+        const double sample = static_cast<double>(latency.count());
+        state.latency_ns = state.latency_ns == 0
+            ? sample
+            : params_.latency_decay * sample + (1 - params_.latency_decay) * state.latency_ns;
+    }
+    onResult(state, success);
+}
+
+void EndpointsStats::OnConnect(const Endpoint& endpoint, bool success)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    onResult(states_[{endpoint.host, endpoint.port}], success);
+}
+
+EndpointsStats::Snapshot EndpointsStats::Get(const Endpoint& endpoint) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Snapshot snapshot;
+    auto it = states_.find({endpoint.host, endpoint.port});
+    if (it != states_.end()) {
+        snapshot.outstanding = it->second.outstanding;
+        snapshot.latency = std::chrono::nanoseconds(static_cast<int64_t>(it->second.latency_ns));
+        snapshot.consecutive_failures = it->second.consecutive_failures;
+        snapshot.ejected = Clock::now() < it->second.ejected_until;
+    }
+    return snapshot;
+}
+
+void EndpointsStats::onResult(State& state, bool success)
+{
+    if (success) {
+        state.consecutive_failures = 0;
+        return;
+    }
+
+    // After ejection time passes the endpoint gets one more chance, next failure ejects it again.
+    if (++state.consecutive_failures >= params_.max_failures) {
+        state.ejected_until = Clock::now() + params_.ejection_time;
+    }
+}
+
+
 RoundRobinEndpointsIterator::RoundRobinEndpointsIterator(const std::vector<Endpoint>& _endpoints)
    :  endpoints (_endpoints)
    , current_index (endpoints.size() - 1ull)
@@ -17,4 +81,103 @@ Endpoint RoundRobinEndpointsIterator::Next()
 
 RoundRobinEndpointsIterator::~RoundRobinEndpointsIterator() = default;
 
+
+BalancingEndpointsIterator::BalancingEndpointsIterator(const std::vector<Endpoint>& _endpoints, std::shared_ptr<EndpointsStats> _stats)
+   : endpoints (_endpoints)
+   , stats (std::move(_stats))
+   , tried (endpoints.size(), false)
+{
+}
+
+BalancingEndpointsIterator::~BalancingEndpointsIterator() = default;
+
+Endpoint BalancingEndpointsIterator::Next()
+{
+   if (std::all_of(tried.begin(), tried.end(), [](bool t) { return t; })) {
+      tried.assign(endpoints.size(), false);
+   }
+
+   std::vector<EndpointsStats::Snapshot> snapshots;
+   snapshots.reserve(endpoints.size());
+   for (const auto& endpoint : endpoints) {
+      snapshots.push_back(stats->Get(endpoint));
+   }
+
+   std::vector<size_t> candidates;
+   for (size_t i = 0; i < endpoints.size(); ++i) {
+      if (!tried[i] && !snapshots[i].ejected) {
+         candidates.push_back(i);
+      }
+   }
+   // All the endpoints left are ejected, try them anyway.
+   if (candidates.empty()) {
+      for (size_t i = 0; i < endpoints.size(); ++i) {
+         if (!tried[i]) {
+            candidates.push_back(i);
+         }
+      }
+   }
+
+   const size_t index = Choose(candidates, snapshots);
+   tried[index] = true;
+   return endpoints[index];
+}
+
+void BalancingEndpointsIterator::OnConnected(const Endpoint& /*endpoint*/)
+{
+   tried.assign(endpoints.size(), false);
+}
+
+
+size_t LeastOutstandingEndpointsIterator::Choose(const std::vector<size_t>& candidates, const std::vector<EndpointsStats::Snapshot>& stats)
+{
+   // Start from the endpoint after the previously chosen one, so ties are resolved in round-robin order.
+   const size_t count = stats.size();
+   auto distance = [&](size_t index) { return (index + count - next_index) % count; };
+
+   size_t best = candidates.front();
+   for (size_t index : candidates) {
+      if (stats[index].outstanding < stats[best].outstanding
+          || (stats[index].outstanding == stats[best].outstanding && distance(index) < distance(best))) {
+         best = index;
+      }
+   }
+
+   next_index = (best + 1) % count;
+   return best;
+}
+
+
+PowerOfTwoChoicesEndpointsIterator::PowerOfTwoChoicesEndpointsIterator(const std::vector<Endpoint>& _endpoints, std::shared_ptr<EndpointsStats> _stats)
+   : BalancingEndpointsIterator(_endpoints, std::move(_stats))
+   , random (std::random_device{}())
+{
+}
+
+size_t PowerOfTwoChoicesEndpointsIterator::Choose(const std::vector<size_t>& candidates, const std::vector<EndpointsStats::Snapshot>& stats)
+{
+   if (candidates.size() == 1) {
+      return candidates.front();
+   }
+
+   const size_t first = std::uniform_int_distribution<size_t>(0, candidates.size() - 1)(random);
+   size_t second = std::uniform_int_distribution<size_t>(0, candidates.size() - 2)(random);
+   if (second >= first) {
+      ++second;
+   }
+
+   // Endpoints without latency measured yet cost nothing, so they get requests and are measured.
+   auto cost = [&](size_t index) {
+      return static_cast<double>(stats[index].latency.count()) * static_cast<double>(stats[index].outstanding + 1);
+   };
+
+   return cost(candidates[second]) < cost(candidates[first]) ? candidates[second] : candidates[first];
+}
+
+
+size_t InOrderEndpointsIterator::Choose(const std::vector<size_t>& candidates, const std::vector<EndpointsStats::Snapshot>& /*stats*/)
+{
+   return candidates.front();
+}
+
 }
@@ -1,12 +1,71 @@
 #pragma once
 
 #include "clickhouse/client.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
 #include <vector>
 
 namespace clickhouse {
 
 struct ClientOptions;
 
+struct EndpointsStatsParams {
+    /// Weight of the latest request in the exponentially weighted moving average of latency.
+    double latency_decay = 0.3;
+    /// Number of consecutive failures (connection or network errors, or requests failed with an exception
+    /// of the server) after which the endpoint is ejected.
+    size_t max_failures = 3;
+    /// For how long the ejected endpoint is not chosen, unless all the endpoints are ejected.
+    std::chrono::milliseconds ejection_time{ 30000 };
+};
+
+/**
+ * Load and health of endpoints, fed by Client and used by balancing iterators.
+ * May be shared by clients (see ClientOptions::endpoints_stats) to balance them together.
+*/
+class EndpointsStats
+{
+ public:
+    struct Snapshot {
+        /// Number of requests in progress.
+        size_t outstanding = 0;
+        /// Zero if there were no requests yet. Time spent in query callbacks isn't included.
+        std::chrono::nanoseconds latency{ 0 };
+        size_t consecutive_failures = 0;
+        bool ejected = false;
+    };
+
+    explicit EndpointsStats(EndpointsStatsParams params = {});
+
+    void OnRequestStart(const Endpoint& endpoint);
+    void OnRequestFinish(const Endpoint& endpoint, std::chrono::nanoseconds latency, bool success);
+    void OnConnect(const Endpoint& endpoint, bool success);
+
+    Snapshot Get(const Endpoint& endpoint) const;
+
+ private:
+    using Clock = std::chrono::steady_clock;
+
+    struct State {
+        size_t outstanding = 0;
+        double latency_ns = 0;
+        size_t consecutive_failures = 0;
+        Clock::time_point ejected_until;
+    };
+
+    void onResult(State& state, bool success);
+
+ private:
+    const EndpointsStatsParams params_;
+    mutable std::mutex mutex_;
+    std::map<std::pair<std::string, uint16_t>, State> states_;
+};
+
 /**
  * Base class for iterating through endpoints.
 */
@@ -16,6 +75,9 @@ class EndpointsIteratorBase
    virtual ~EndpointsIteratorBase() = default;
 
    virtual Endpoint Next() = 0;
+
+   /// Called when connection to the endpoint returned by Next() is established.
+   virtual void OnConnected(const Endpoint& /*endpoint*/) {}
 };
 
 class RoundRobinEndpointsIterator : public EndpointsIteratorBase
@@ -31,4 +93,66 @@ class RoundRobinEndpointsIterator : public EndpointsIteratorBase
     size_t current_index;
 };
 
+/**
+ * Base class for iterators choosing endpoint by its stats.
+ *
+ * Ejected endpoints are skipped. Consecutive calls of Next() until OnConnected() don't return
+ * the same endpoint twice, unless all the endpoints were already returned.
+*/
+class BalancingEndpointsIterator : public EndpointsIteratorBase
+{
+ public:
+    BalancingEndpointsIterator(const std::vector<Endpoint>& endpoints, std::shared_ptr<EndpointsStats> stats);
+    ~BalancingEndpointsIterator() override;
+
+    Endpoint Next() override;
+    void OnConnected(const Endpoint& endpoint) override;
+
+ protected:
+    /// Chooses one of `candidates` (indices of the endpoints, never empty).
+    virtual size_t Choose(const std::vector<size_t>& candidates, const std::vector<EndpointsStats::Snapshot>& stats) = 0;
+
+ private:
+    const std::vector<Endpoint>& endpoints;
+    const std::shared_ptr<EndpointsStats> stats;
+    std::vector<bool> tried;
+};
+
+/// Chooses endpoint with the least number of requests in progress, ties are resolved in round-robin order.
+class LeastOutstandingEndpointsIterator : public BalancingEndpointsIterator
+{
+ public:
+    using BalancingEndpointsIterator::BalancingEndpointsIterator;
+
+ protected:
+    size_t Choose(const std::vector<size_t>& candidates, const std::vector<EndpointsStats::Snapshot>& stats) override;
+
+ private:
+    size_t next_index = 0;
+};
+
+/// Picks two random endpoints and chooses the one with lower latency weighted by number of requests in progress.
+class PowerOfTwoChoicesEndpointsIterator : public BalancingEndpointsIterator
+{
+ public:
+    PowerOfTwoChoicesEndpointsIterator(const std::vector<Endpoint>& endpoints, std::shared_ptr<EndpointsStats> stats);
+
+ protected:
+    size_t Choose(const std::vector<size_t>& candidates, const std::vector<EndpointsStats::Snapshot>& stats) override;
+
+ private:
+    std::minstd_rand random;
+};
+
+/// Chooses the first healthy endpoint in the order of ClientOptions::endpoints,
+/// so connections fail over to the next endpoints and get back when the first one recovers.
+class InOrderEndpointsIterator : public BalancingEndpointsIterator
+{
+ public:
+    using BalancingEndpointsIterator::BalancingEndpointsIterator;
+
+ protected:
+    size_t Choose(const std::vector<size_t>& candidates, const std::vector<EndpointsStats::Snapshot>& stats) override;
+};
+
 }
@@ -5,6 +5,22 @@
 
 namespace clickhouse {
 
+size_t InputStream::DoReadAll(void* buf, size_t len) {
+    uint8_t* p = static_cast<uint8_t*>(buf);
+    size_t total = 0;
+
+    while (total < len) {
+        const size_t ret = DoRead(p + total, len - total);
+        if (ret == 0) {
+            break;
+        }
+        total += ret;
+    }
+
+    return total;
+}
+
+
 bool ZeroCopyInput::Skip(size_t bytes) {
     while (bytes > 0) {
         const void* ptr;
@@ -56,10 +72,21 @@ size_t ArrayInput::DoNext(const void** ptr, size_t len) {
 }
 
 
-BufferedInput::BufferedInput(std::unique_ptr<InputStream> source, size_t buflen)
+namespace {
+
+/// Number of consecutive full reads after which the buffer grows.
+constexpr size_t kGrowAfterFullReads = 2;
+/// Number of consecutive small reads after which the buffer shrinks.
+constexpr size_t kShrinkAfterSmallReads = 16;
+
+}
+
+BufferedInput::BufferedInput(std::unique_ptr<InputStream> source, size_t buflen, size_t max_buflen)
     : source_(std::move(source))
     , array_input_(nullptr, 0)
     , buffer_(buflen)
+    , min_buflen_(buflen)
+    , max_buflen_(std::max(buflen, max_buflen))
 {
 }
 
@@ -71,9 +98,7 @@ void BufferedInput::Reset() {
 
 size_t BufferedInput::DoNext(const void** ptr, size_t len)  {
     if (array_input_.Exhausted()) {
-        array_input_.Reset(
-            buffer_.data(), source_->Read(buffer_.data(), buffer_.size())
-        );
+        Fill();
     }
 
     return array_input_.Next(ptr, len);
@@ -85,12 +110,59 @@ size_t BufferedInput::DoRead(void* buf, size_t len) {
             return source_->Read(buf, len);
         }
 
-        array_input_.Reset(
-            buffer_.data(), source_->Read(buffer_.data(), buffer_.size())
-        );
+        Fill();
     }
 
     return array_input_.Read(buf, len);
 }
 
+size_t BufferedInput::DoReadAll(void* buf, size_t len) {
+    uint8_t* p = static_cast<uint8_t*>(buf);
+    // Takes whatever is buffered already.
+    const size_t buffered = array_input_.Read(p, len);
+
+    if (len - buffered > buffer_.size() / 2) {
+        // Large reads (e.g. body of a column) go from the source straight into destination,
+        // instead of filling and copying the buffer over and over again.
+        return buffered + source_->ReadAll(p + buffered, len - buffered);
+    }
+
+    return buffered + InputStream::DoReadAll(p + buffered, len - buffered);
+}
+
+void BufferedInput::Fill() {
+    if (max_buflen_ > min_buflen_) {
+        Adapt();
+    }
+
+    last_read_ = source_->Read(buffer_.data(), buffer_.size());
+    array_input_.Reset(buffer_.data(), last_read_);
+}
+
+void BufferedInput::Adapt() {
+    size_t new_size = buffer_.size();
+
+    if (last_read_ == buffer_.size()) {
+        small_reads_ = 0;
+        if (++full_reads_ >= kGrowAfterFullReads && buffer_.size() < max_buflen_) {
+            new_size = std::min(buffer_.size() * 2, max_buflen_);
+        }
+    } else if (last_read_ < buffer_.size() / 4) {
+        full_reads_ = 0;
+        if (++small_reads_ >= kShrinkAfterSmallReads && buffer_.size() > min_buflen_) {
+            new_size = std::max(buffer_.size() / 2, min_buflen_);
+        }
+    } else {
+        full_reads_ = 0;
+        small_reads_ = 0;
+    }
+
+    if (new_size != buffer_.size()) {
+        // Buffer is exhausted, no need to preserve its content, and shrinking actually releases memory.
+        buffer_ = std::vector<uint8_t>(new_size);
+        full_reads_ = 0;
+        small_reads_ = 0;
+    }
+}
+
 }
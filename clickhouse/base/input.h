@@ -22,11 +22,19 @@ public:
         return DoRead(buf, len);
     }
 
+    /// Reads exactly `len` bytes from the stream, returns less only if the stream ends.
+    inline size_t ReadAll(void* buf, size_t len) {
+        return DoReadAll(buf, len);
+    }
+
     // Skips a number of bytes.  Returns false if an underlying read error occurs.
     virtual bool Skip(size_t bytes) = 0;
 
 protected:
     virtual size_t DoRead(void* buf, size_t len) = 0;
+
+    /// Calls DoRead() until all data is read, streams which can do better (e.g. with a single syscall) override it.
+    virtual size_t DoReadAll(void* buf, size_t len);
 };
 
 
@@ -83,21 +91,50 @@ private:
 };
 
 
+/**
+ * A ZeroCopyInput stream which reads data from the source in chunks of buffer size.
+ *
+ * If `max_buflen` is greater than `buflen` the buffer is adaptive: it doubles (up to `max_buflen`)
+ * while reads from the source keep filling it up, and halves (down to `buflen`) when
+ * reads return only a small portion of it, e.g. when the stream is idle.
+ */
 class BufferedInput : public ZeroCopyInput {
 public:
-    BufferedInput(std::unique_ptr<InputStream> source, size_t buflen = 8192);
+    BufferedInput(std::unique_ptr<InputStream> source, size_t buflen = 8192, size_t max_buflen = 0);
     ~BufferedInput() override;
 
     void Reset();
 
+    /// Current size of the buffer.
+    inline size_t BufferSize() const noexcept {
+        return buffer_.size();
+    }
+
 protected:
     size_t DoRead(void* buf, size_t len) override;
+    size_t DoReadAll(void* buf, size_t len) override;
     size_t DoNext(const void** ptr, size_t len) override;
 
+private:
+    /// Reads next chunk of data from the source, the buffer must be exhausted.
+    void Fill();
+
+    /// Resizes the buffer according to results of the recent reads.
+    void Adapt();
+
 private:
     std::unique_ptr<InputStream> const source_;
     ArrayInput array_input_;
     std::vector<uint8_t> buffer_;
+
+    const size_t min_buflen_;
+    const size_t max_buflen_;
+    /// Number of bytes returned by the last read from the source.
+    size_t last_read_ = 0;
+    /// Number of consecutive reads which filled the buffer up.
+    size_t full_reads_ = 0;
+    /// Number of consecutive reads which used only a small portion of the buffer.
+    size_t small_reads_ = 0;
 };
 
 }
@@ -0,0 +1,67 @@
+#include "memory_resource.h"
+
+#include <cstdint>
+
+namespace clickhouse {
+
+MemoryResource::~MemoryResource() = default;
+
+ArenaMemoryResource::ArenaMemoryResource(size_t chunk_size)
+    : chunk_size_(chunk_size ? chunk_size : DEFAULT_CHUNK_SIZE)
+{
+}
+
+ArenaMemoryResource::~ArenaMemoryResource() = default;
+
+void* ArenaMemoryResource::Allocate(size_t bytes, size_t alignment) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto align = [alignment] (char* p) {
+        const auto address = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - address % alignment) % alignment);
+    };
+
+    char* result = free_begin_ ? align(free_begin_) : nullptr;
+    if (!result || result > free_end_ || static_cast<size_t>(free_end_ - result) < bytes) {
+        // Allocations larger than a quarter of a chunk which don't fit into the current one get a chunk
+        // of their own, so the free part of the current chunk isn't wasted.
+        const size_t size = bytes + alignment;
+        const bool dedicated = size > chunk_size_ / 4;
+        Chunk chunk{std::unique_ptr<char[]>(new char[dedicated ? size : chunk_size_]), dedicated ? size : chunk_size_};
+        allocated_bytes_ += chunk.size;
+        result = align(chunk.data.get());
+
+        if (dedicated) {
+            chunks_.push_back(std::move(chunk));
+            used_bytes_ += bytes;
+            return result;
+        }
+
+        free_end_ = chunk.data.get() + chunk.size;
+        chunks_.push_back(std::move(chunk));
+    }
+
+    free_begin_ = result + bytes;
+    used_bytes_ += bytes;
+    return result;
+}
+
+void ArenaMemoryResource::Deallocate(void* /*p*/, size_t /*bytes*/, size_t /*alignment*/) noexcept {
+}
+
+size_t ArenaMemoryResource::AllocatedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocated_bytes_;
+}
+
+size_t ArenaMemoryResource::UsedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return used_bytes_;
+}
+
+size_t ArenaMemoryResource::ChunkCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunks_.size();
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace clickhouse {
+
+/** Source of memory for column buffers, a minimal substitute of C++17 std::pmr::memory_resource,
+ *  which isn't available with all the supported standard libraries.
+ *
+ *  Columns keep a reference to the resource they were created with, so it lives at least as long
+ *  as memory allocated from it is in use.
+ */
+class MemoryResource {
+public:
+    virtual ~MemoryResource();
+
+    /// Throws std::bad_alloc if memory can't be allocated.
+    virtual void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) = 0;
+    virtual void Deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept = 0;
+};
+
+/** Monotonic arena: memory is carved out of large chunks, deallocation is a no-op and all the chunks
+ *  are released at once when the arena is destroyed, i.e. when the last column using it is gone.
+ *
+ *  Meant to be used for all the columns of a single Block, see CreateColumnByTypeSettings::memory_resource
+ *  and ClientOptions::block_arena_chunk_size. Thread-safe.
+ */
+class ArenaMemoryResource : public MemoryResource {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+    explicit ArenaMemoryResource(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+    ~ArenaMemoryResource() override;
+
+    void* Allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) override;
+    void Deallocate(void* p, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept override;
+
+    /// Bytes of all the chunks obtained from the heap.
+    size_t AllocatedBytes() const;
+    /// Bytes handed out by Allocate(), including ones already deallocated.
+    size_t UsedBytes() const;
+    size_t ChunkCount() const;
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    const size_t chunk_size_;
+    mutable std::mutex mutex_;
+    std::vector<Chunk> chunks_;
+    /// Free part of the last chunk.
+    char* free_begin_ = nullptr;
+    char* free_end_ = nullptr;
+    size_t allocated_bytes_ = 0;
+    size_t used_bytes_ = 0;
+};
+
+}
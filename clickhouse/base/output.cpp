@@ -80,6 +80,13 @@ void BufferedOutput::Reset() {
 }
 
 void BufferedOutput::DoFlush() {
+    FlushBuffer();
+
+    // Even if buffer was empty, since large writes bypass it and may need to be finalized by destination.
+    destination_->Flush();
+}
+
+void BufferedOutput::FlushBuffer() {
     if (array_output_.Data() != buffer_.data()) {
         size_t len = array_output_.Data() - buffer_.data();
         const uint8_t* buf = buffer_.data();
@@ -89,15 +96,13 @@ void BufferedOutput::DoFlush() {
             len -= written;
         }
 
-        destination_->Flush();
-
         array_output_.Reset(buffer_.data(), buffer_.size());
     }
 }
 
 size_t BufferedOutput::DoNext(void** data, size_t len) {
     if (array_output_.Avail() < len) {
-        Flush();
+        FlushBuffer();
     }
 
     return array_output_.Next(data, len);
@@ -106,7 +111,7 @@ size_t BufferedOutput::DoNext(void** data, size_t len) {
 
 size_t BufferedOutput::DoWrite(const void* data, size_t len) {
     if (array_output_.Avail() < len) {
-        Flush();
+        FlushBuffer();
 
         if (len > buffer_.size() / 2) {
             return destination_->Write(data, len);
@@ -116,4 +121,9 @@ size_t BufferedOutput::DoWrite(const void* data, size_t len) {
     return array_output_.Write(data, len);
 }
 
+void BufferedOutput::DoRetain(std::shared_ptr<const void> owner) {
+    // Large writes bypass the buffer, destination may still reference them.
+    destination_->Retain(std::move(owner));
+}
+
 }
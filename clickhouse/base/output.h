@@ -23,9 +23,18 @@ public:
         return DoWrite(data, len);
     }
 
+    /// Keeps @p owner alive while the stream may still reference data written so far,
+    /// i.e. at least until the next Flush() returns.
+    inline void Retain(std::shared_ptr<const void> owner) {
+        DoRetain(std::move(owner));
+    }
+
 protected:
     virtual void DoFlush() { }
 
+    /// By default written data is copied, so nothing has to be retained.
+    virtual void DoRetain(std::shared_ptr<const void> /*owner*/) { }
+
     virtual size_t DoWrite(const void* data, size_t len) = 0;
 };
 
@@ -127,6 +136,11 @@ protected:
     void DoFlush() override;
     size_t DoNext(void** data, size_t len) override;
     size_t DoWrite(const void* data, size_t len) override;
+    void DoRetain(std::shared_ptr<const void> owner) override;
+
+private:
+    /// Writes buffered data to destination without flushing destination itself.
+    void FlushBuffer();
 
 private:
     std::unique_ptr<OutputStream> const destination_;
@@ -0,0 +1,176 @@
+#include "resolver.h"
+
+#include <algorithm>
+#include <system_error>
+#include <vector>
+
+namespace clickhouse {
+
+AddressResolver::~AddressResolver() = default;
+
+
+CachingResolver::CachingResolver(CachingResolverParams params)
+    : params_(std::move(params))
+{
+}
+
+CachingResolver::~CachingResolver() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_all();
+
+    if (refresh_thread_.joinable()) {
+        refresh_thread_.join();
+    }
+}
+
+std::shared_ptr<CachingResolver> CachingResolver::Shared() {
+    static const auto instance = std::make_shared<CachingResolver>();
+    return instance;
+}
+
+std::shared_ptr<const NetworkAddress> CachingResolver::resolve(const std::string& host, const std::string& port) {
+    const auto now = Clock::now();
+    Key key{host, port};
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            Entry& entry = it->second;
+            entry.last_used = now;
+            // Expired addresses are still valid while the refresh thread is resolving them again.
+            if (now < entry.expires_at || (params_.background_refresh && entry.address)) {
+                ++hits_;
+                if (entry.error) {
+                    std::rethrow_exception(entry.error);
+                }
+                return entry.address;
+            }
+        }
+        ++misses_;
+    }
+
+    const Entry entry = update(key, now);
+    if (entry.error) {
+        std::rethrow_exception(entry.error);
+    }
+    return entry.address;
+}
+
+size_t CachingResolver::Hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t CachingResolver::Misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t CachingResolver::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+void CachingResolver::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+std::shared_ptr<const NetworkAddress> CachingResolver::doResolve(const std::string& host, const std::string& port) {
+    return std::make_shared<const NetworkAddress>(host, port);
+}
+
+CachingResolver::Entry CachingResolver::update(const Key& key, Clock::time_point now) {
+    std::shared_ptr<const NetworkAddress> address;
+    std::exception_ptr error;
+    try {
+        address = doResolve(key.first, key.second);
+    } catch (const std::system_error&) {
+        error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto [it, inserted] = entries_.try_emplace(key);
+    Entry& entry = it->second;
+    if (inserted) {
+        entry.last_used = now;
+    }
+
+    if (address) {
+        entry.address = std::move(address);
+        entry.error = nullptr;
+        entry.expires_at = Clock::now() + params_.ttl;
+    } else if (params_.background_refresh && entry.address) {
+        // Keep serving last known addresses, retry later.
+        entry.expires_at = Clock::now() + params_.negative_ttl;
+    } else {
+        entry.address = nullptr;
+        entry.error = error;
+        entry.expires_at = Clock::now() + params_.negative_ttl;
+    }
+
+    if (params_.background_refresh && !refresh_thread_.joinable() && !stop_) {
+        startRefreshThread();
+    }
+
+    Entry result = entry;
+    lock.unlock();
+    wakeup_.notify_all();
+
+    return result;
+}
+
+void CachingResolver::startRefreshThread() {
+    refresh_thread_ = std::thread([this] { refreshLoop(); });
+}
+
+void CachingResolver::refreshLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stop_) {
+        const auto now = Clock::now();
+        auto wake_at = Clock::time_point::max();
+        std::vector<Key> expired;
+
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            const Entry& entry = it->second;
+            const auto idle_until = entry.last_used + params_.idle_timeout;
+            if (idle_until <= now) {
+                it = entries_.erase(it);
+                continue;
+            }
+            wake_at = std::min(wake_at, idle_until);
+
+            // Failed hosts are resolved again on access.
+            if (entry.address) {
+                if (entry.expires_at <= now) {
+                    expired.push_back(it->first);
+                } else {
+                    wake_at = std::min(wake_at, entry.expires_at);
+                }
+            }
+            ++it;
+        }
+
+        if (!expired.empty()) {
+            lock.unlock();
+            for (const auto& key : expired) {
+                update(key, now);
+            }
+            lock.lock();
+            continue;
+        }
+
+        if (wake_at == Clock::time_point::max()) {
+            wakeup_.wait(lock);
+        } else {
+            wakeup_.wait_until(lock, wake_at);
+        }
+    }
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "socket.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace clickhouse {
+
+/// Resolves host names for SocketFactory, see NonSecureSocketFactory.
+class AddressResolver {
+public:
+    virtual ~AddressResolver();
+
+    /// Throws std::system_error if the host can't be resolved.
+    virtual std::shared_ptr<const NetworkAddress> resolve(const std::string& host, const std::string& port) = 0;
+};
+
+struct CachingResolverParams {
+    /// How long resolved addresses are used before they are resolved again.
+    std::chrono::milliseconds ttl{ 60000 };
+    /// How long a resolution failure is remembered, resolving the host in this period throws the same error.
+    std::chrono::milliseconds negative_ttl{ 5000 };
+    /// Resolve expired entries in a background thread, so resolve() doesn't block on DNS
+    /// unless the host is resolved for the first time. Otherwise expired entries are resolved on access.
+    bool background_refresh = true;
+    /// Entries not accessed for this long are dropped instead of being refreshed.
+    std::chrono::milliseconds idle_timeout{ 600000 };
+};
+
+/** Caches resolved addresses, shared by all the clients which use it.
+ *
+ *  With background refresh, if refreshing of a host fails, its last known addresses keep
+ *  being returned and refresh is retried after `negative_ttl`.
+ */
+class CachingResolver : public AddressResolver {
+public:
+    explicit CachingResolver(CachingResolverParams params = {});
+    ~CachingResolver() override;
+
+    /// Process-wide instance with default parameters.
+    static std::shared_ptr<CachingResolver> Shared();
+
+    std::shared_ptr<const NetworkAddress> resolve(const std::string& host, const std::string& port) override;
+
+    /// Number of resolve() calls served from the cache.
+    size_t Hits() const;
+    /// Number of resolve() calls which had to resolve the host.
+    size_t Misses() const;
+    size_t Size() const;
+    void Clear();
+
+protected:
+    /// Does actual resolution, may be overridden e.g. to use another DNS client.
+    virtual std::shared_ptr<const NetworkAddress> doResolve(const std::string& host, const std::string& port);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Key = std::pair<std::string, std::string>;
+
+    struct Entry {
+        std::shared_ptr<const NetworkAddress> address;
+        /// Resolution failure, set if `address` is null.
+        std::exception_ptr error;
+        Clock::time_point expires_at;
+        Clock::time_point last_used;
+    };
+
+    /// Resolves `key` and stores result into the cache, returns the stored entry.
+    Entry update(const Key& key, Clock::time_point now);
+    void refreshLoop();
+    void startRefreshThread();
+
+private:
+    const CachingResolverParams params_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::map<Key, Entry> entries_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    bool stop_ = false;
+    std::thread refresh_thread_;
+};
+
+}
@@ -1,13 +1,17 @@
 #include "socket.h"
+#include "resolver.h"
 #include "singleton.h"
 #include "../client.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 #include <system_error>
 #include <unordered_set>
 #include <memory.h>
 #include <thread>
+#include <vector>
 
 #if !defined(_win_)
 #   include <errno.h>
@@ -18,6 +22,11 @@
 #   include <unistd.h>
 #endif
 
+#if defined(_linux_)
+#   include <linux/errqueue.h>
+#   include <netinet/in.h>
+#endif
+
 #if defined(__FreeBSD__)
 #include <netinet/in.h>
 #endif
@@ -197,68 +206,198 @@ struct SocketRAIIWrapper {
     }
 };
 
-SOCKET SocketConnect(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params) {
-    int last_err = 0;
-    for (auto res = addr.Info(); res != nullptr; res = res->ai_next) {
-        SocketRAIIWrapper s{socket(res->ai_family, res->ai_socktype, res->ai_protocol)};
-
-        if (*s == INVALID_SOCKET) {
-            continue;
-        }
-
-        SetNonBlock(*s, true);
-        SetTimeout(*s, timeout_params);
-
-        if (connect(*s, res->ai_addr, (int)res->ai_addrlen) != 0) {
-            int err = getSocketErrorCode();
-            if (
-                err == EINPROGRESS || err == EAGAIN || err == EWOULDBLOCK
+bool IsConnectInProgress(int err) {
+    return err == EINPROGRESS || err == EAGAIN || err == EWOULDBLOCK
 #if defined(_win_)
-                || err == WSAEWOULDBLOCK || err == WSAEINPROGRESS
+        || err == WSAEWOULDBLOCK || err == WSAEINPROGRESS
 #endif
-            ) {
-                pollfd fd;
-                fd.fd = *s;
-                fd.events = POLLOUT;
-                fd.revents = 0;
-                ssize_t rval = Poll(&fd, 1, static_cast<int>(timeout_params.connect_timeout.count()));
-
-                if (rval == -1) {
-                    throw std::system_error(getSocketErrorCode(), getErrorCategory(), "fail to connect");
-                }
-                if (rval == 0) {
+    ;
+}
+
+int TimedOutError() {
 #if defined(_win_)
-                    last_err = WSAETIMEDOUT;
+    return WSAETIMEDOUT;
 #else
-                    last_err = ETIMEDOUT;
+    return ETIMEDOUT;
 #endif
+}
+
+/// Connection attempts overlap, see SocketTimeoutParams::connection_attempt_delay.
+bool IsRacingEnabled(const SocketTimeoutParams& timeout_params) {
+    return timeout_params.connection_attempt_delay.count() > 0;
+}
+
+struct ConnectCandidate {
+    const struct addrinfo* info;
+    /// Index of the NetworkAddress the candidate belongs to.
+    size_t address_index;
+};
+
+/// Appends addresses of `addr` to `candidates`. If `interleave_families` is set, address families are alternated
+/// (e.g. IPv6, IPv4, IPv6, ...), starting with the family of the first one, as RFC 8305 suggests for racing
+/// connection attempts, otherwise the order of the resolver is kept.
+void AppendCandidates(const NetworkAddress& addr, size_t address_index, bool interleave_families, std::vector<ConnectCandidate>& candidates) {
+    if (!interleave_families) {
+        for (auto res = addr.Info(); res != nullptr; res = res->ai_next) {
+            candidates.push_back({res, address_index});
+        }
+        return;
+    }
+
+    std::vector<const struct addrinfo*> first_family;
+    std::vector<const struct addrinfo*> other_families;
+    for (auto res = addr.Info(); res != nullptr; res = res->ai_next) {
+        if (res->ai_family == addr.Info()->ai_family) {
+            first_family.push_back(res);
+        } else {
+            other_families.push_back(res);
+        }
+    }
+
+    for (size_t i = 0; i < std::max(first_family.size(), other_families.size()); ++i) {
+        if (i < first_family.size()) {
+            candidates.push_back({first_family[i], address_index});
+        }
+        if (i < other_families.size()) {
+            candidates.push_back({other_families[i], address_index});
+        }
+    }
+}
+
+/** Connects to the first candidate which accepts the connection, `winner` is set to its address_index.
+ *
+ *  Next candidate is tried when previous attempt fails or, if `connection_attempt_delay` is not zero,
+ *  when the delay passes, so several attempts may be in flight and the first connected wins,
+ *  all the others are closed. Each attempt is limited by `connect_timeout`.
+ */
+SOCKET RaceConnect(const std::vector<ConnectCandidate>& candidates, const SocketTimeoutParams& timeout_params, size_t* winner) {
+    using Clock = std::chrono::steady_clock;
+
+    struct Attempt {
+        SocketRAIIWrapper socket;
+        size_t candidate;
+        Clock::time_point deadline;
+    };
+
+    const auto attempt_delay = timeout_params.connection_attempt_delay;
+    std::vector<std::unique_ptr<Attempt>> attempts;
+    size_t next = 0;
+    Clock::time_point next_start = Clock::now();
+    int last_err = 0;
+
+    auto connected = [&] (std::unique_ptr<Attempt> & attempt) {
+        SetNonBlock(*attempt->socket, false);
+        if (winner) {
+            *winner = candidates[attempt->candidate].address_index;
+        }
+        return attempt->socket.release();
+    };
+
+    while (true) {
+        // Start next attempt if there is nothing in flight or it is time to start one more.
+        while (next < candidates.size()
+               && (attempts.empty() || (attempt_delay.count() > 0 && Clock::now() >= next_start))) {
+            const auto res = candidates[next].info;
+            auto attempt = std::make_unique<Attempt>();
+            attempt->socket.socket = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+            attempt->candidate = next++;
+
+            if (*attempt->socket == INVALID_SOCKET) {
+                continue;
+            }
+
+            SetNonBlock(*attempt->socket, true);
+            SetTimeout(*attempt->socket, timeout_params);
+
+            if (connect(*attempt->socket, res->ai_addr, (int)res->ai_addrlen) == 0) {
+                return connected(attempt);
+            }
+
+            const int err = getSocketErrorCode();
+            if (!IsConnectInProgress(err)) {
+                last_err = err;
+                continue;
+            }
+
+            const auto now = Clock::now();
+            // Negative timeout means no timeout.
+            attempt->deadline = timeout_params.connect_timeout.count() < 0
+                ? Clock::time_point::max()
+                : now + timeout_params.connect_timeout;
+            next_start = now + attempt_delay;
+            attempts.push_back(std::move(attempt));
+        }
+
+        if (attempts.empty()) {
+            break;
+        }
+
+        auto wake_at = attempts.front()->deadline;
+        for (const auto & attempt : attempts) {
+            wake_at = std::min(wake_at, attempt->deadline);
+        }
+        if (next < candidates.size() && attempt_delay.count() > 0) {
+            wake_at = std::min(wake_at, next_start);
+        }
+
+        std::vector<pollfd> fds(attempts.size());
+        for (size_t i = 0; i < attempts.size(); ++i) {
+            fds[i].fd = *attempts[i]->socket;
+            fds[i].events = POLLOUT;
+            fds[i].revents = 0;
+        }
+
+        int timeout = -1;
+        if (wake_at != Clock::time_point::max()) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(wake_at - Clock::now()).count();
+            timeout = static_cast<int>(std::clamp<int64_t>(left, 0, std::numeric_limits<int>::max()));
+        }
+        const ssize_t rval = Poll(fds.data(), static_cast<int>(fds.size()), timeout);
+        if (rval == -1) {
+            throw std::system_error(getSocketErrorCode(), getErrorCategory(), "fail to connect");
+        }
+
+        const auto now = Clock::now();
+        std::vector<std::unique_ptr<Attempt>> in_flight;
+        for (size_t i = 0; i < attempts.size(); ++i) {
+            if (fds[i].revents) {
+                int err = 0;
+                socklen_t len = sizeof(err);
+                getsockopt(*attempts[i]->socket, SOL_SOCKET, SO_ERROR, (char*)&err, &len);
+
+                if (!err) {
+                    // Attempts still in flight are cancelled by closing their sockets.
+                    return connected(attempts[i]);
                 }
-                if (rval > 0) {
-                    socklen_t len = sizeof(err);
-                    getsockopt(*s, SOL_SOCKET, SO_ERROR, (char*)&err, &len);
-
-                    if (!err) {
-                        SetNonBlock(*s, false);
-                        return s.release();
-                    }
-                   last_err = err;
-                }
+                last_err = err;
+                next_start = now;
+            } else if (now >= attempts[i]->deadline) {
+                last_err = TimedOutError();
+                next_start = now;
+            } else {
+                in_flight.push_back(std::move(attempts[i]));
             }
-        } else {
-            SetNonBlock(*s, false);
-            return s.release();
         }
+        attempts.swap(in_flight);
     }
+
     if (last_err > 0) {
         throw std::system_error(last_err, getErrorCategory(), "fail to connect");
     }
     throw std::system_error(getSocketErrorCode(), getErrorCategory(), "fail to connect");
 }
 
+SOCKET SocketConnect(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params) {
+    std::vector<ConnectCandidate> candidates;
+    AppendCandidates(addr, 0, IsRacingEnabled(timeout_params), candidates);
+    return RaceConnect(candidates, timeout_params, nullptr);
+}
+
 } // namespace
 
 NetworkAddress::NetworkAddress(const std::string& host, const std::string& port)
     : host_(host)
+    , port_(port)
     , info_(nullptr)
 {
     struct addrinfo hints;
@@ -309,9 +448,16 @@ const std::string & NetworkAddress::Host() const {
     return host_;
 }
 
+const std::string & NetworkAddress::Port() const {
+    return port_;
+}
+
 
 SocketBase::~SocketBase() = default;
 
+void SocketBase::Shutdown() noexcept {
+}
+
 
 SocketFactory::~SocketFactory() = default;
 
@@ -319,17 +465,50 @@ void SocketFactory::sleepFor(const std::chrono::milliseconds& duration) {
     std::this_thread::sleep_for(duration);
 }
 
+std::unique_ptr<SocketBase> SocketFactory::connectAny(const ClientOptions& opts, const std::vector<Endpoint>& endpoints, size_t* index) {
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        try {
+            auto socket = connect(opts, endpoints[i]);
+            *index = i;
+            return socket;
+        } catch (const std::system_error&) {
+            if (i + 1 == endpoints.size()) {
+                throw;
+            }
+        }
+    }
+
+    throw std::system_error(std::make_error_code(std::errc::invalid_argument), "no endpoints to connect to");
+}
+
 
 Socket::Socket(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params)
     : handle_(SocketConnect(addr, timeout_params))
+    , send_timeout_(timeout_params.send_timeout)
 {}
 
 Socket::Socket(const NetworkAddress & addr)
     : handle_(SocketConnect(addr, SocketTimeoutParams{}))
 {}
 
+Socket::Socket(SOCKET handle, const SocketTimeoutParams& timeout_params) noexcept
+    : handle_(handle)
+    , send_timeout_(timeout_params.send_timeout)
+{}
+
+Socket Socket::ConnectAny(const std::vector<const NetworkAddress*>& addresses, const SocketTimeoutParams& timeout_params, size_t* index) {
+    std::vector<ConnectCandidate> candidates;
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        AppendCandidates(*addresses[i], i, IsRacingEnabled(timeout_params), candidates);
+    }
+
+    return Socket(RaceConnect(candidates, timeout_params, index), timeout_params);
+}
+
 Socket::Socket(Socket&& other) noexcept
     : handle_(other.handle_)
+    , zero_copy_(other.zero_copy_)
+    , send_timeout_(other.send_timeout_)
 {
     other.handle_ = INVALID_SOCKET;
 }
@@ -339,6 +518,8 @@ Socket& Socket::operator=(Socket&& other) noexcept {
         Close();
 
         handle_ = other.handle_;
+        zero_copy_ = other.zero_copy_;
+        send_timeout_ = other.send_timeout_;
         other.handle_ = INVALID_SOCKET;
     }
 
@@ -354,6 +535,17 @@ void Socket::Close() {
     handle_ = INVALID_SOCKET;
 }
 
+void Socket::Shutdown() noexcept {
+    if (handle_ == INVALID_SOCKET) {
+        return;
+    }
+#if defined(_win_)
+    shutdown(handle_, SD_BOTH);
+#else
+    shutdown(handle_, SHUT_RDWR);
+#endif
+}
+
 void Socket::SetTcpKeepAlive(int idle, int intvl, int cnt) noexcept {
     int val = 1;
 
@@ -383,31 +575,109 @@ void Socket::SetTcpNoDelay(bool nodelay) noexcept {
 #endif
 }
 
+void Socket::SetRecvBufferSize(int size) noexcept {
+#if defined(_unix_)
+    setsockopt(handle_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+#else
+    setsockopt(handle_, SOL_SOCKET, SO_RCVBUF, (const char*)&size, sizeof(size));
+#endif
+}
+
+void Socket::SetSendBufferSize(int size) noexcept {
+#if defined(_unix_)
+    setsockopt(handle_, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+#else
+    setsockopt(handle_, SOL_SOCKET, SO_SNDBUF, (const char*)&size, sizeof(size));
+#endif
+}
+
+bool Socket::SetZeroCopy(bool enable) noexcept {
+#if defined(_linux_) && defined(SO_ZEROCOPY)
+    int val = enable;
+    if (setsockopt(handle_, SOL_SOCKET, SO_ZEROCOPY, &val, sizeof(val)) != 0) {
+        zero_copy_ = false;
+        return false;
+    }
+    zero_copy_ = enable;
+    return true;
+#else
+    std::ignore = enable;
+    return false;
+#endif
+}
+
 std::unique_ptr<InputStream> Socket::makeInputStream() const {
     return std::make_unique<SocketInput>(handle_);
 }
 
 std::unique_ptr<OutputStream> Socket::makeOutputStream() const {
-    return std::make_unique<SocketOutput>(handle_);
+    return std::make_unique<SocketOutput>(handle_, zero_copy_, send_timeout_);
 }
 
 
+NonSecureSocketFactory::NonSecureSocketFactory(std::shared_ptr<AddressResolver> resolver)
+    : resolver_(std::move(resolver))
+{
+}
+
 NonSecureSocketFactory::~NonSecureSocketFactory()  {}
 
 std::unique_ptr<SocketBase> NonSecureSocketFactory::connect(const ClientOptions &opts, const Endpoint& endpoint) {
 
-    const auto address = NetworkAddress(endpoint.host, std::to_string(endpoint.port));
-    auto socket = doConnect(address, opts);
+    const auto address = resolve(endpoint);
+    auto socket = doConnect(*address, opts);
     setSocketOptions(*socket, opts);
 
     return socket;
 }
 
+std::unique_ptr<SocketBase> NonSecureSocketFactory::connectAny(const ClientOptions& opts, const std::vector<Endpoint>& endpoints, size_t* index) {
+    // Endpoints which can't be resolved are skipped, unless none can.
+    std::vector<std::shared_ptr<const NetworkAddress>> addresses;
+    std::vector<size_t> endpoint_indices;
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        try {
+            addresses.push_back(resolve(endpoints[i]));
+            endpoint_indices.push_back(i);
+        } catch (const std::system_error&) {
+            if (i + 1 == endpoints.size() && addresses.empty()) {
+                throw;
+            }
+        }
+    }
+
+    std::vector<const NetworkAddress*> address_ptrs;
+    for (const auto& address : addresses) {
+        address_ptrs.push_back(address.get());
+    }
+
+    SocketTimeoutParams timeout_params { opts.connection_connect_timeout, opts.connection_recv_timeout, opts.connection_send_timeout, opts.connection_attempt_delay };
+    size_t connected = 0;
+    Socket socket = Socket::ConnectAny(address_ptrs, timeout_params, &connected);
+
+    auto result = doWrap(std::move(socket), *addresses[connected], opts);
+    setSocketOptions(*result, opts);
+    *index = endpoint_indices[connected];
+
+    return result;
+}
+
 std::unique_ptr<Socket> NonSecureSocketFactory::doConnect(const NetworkAddress& address, const ClientOptions& opts) {
-    SocketTimeoutParams timeout_params { opts.connection_connect_timeout, opts.connection_recv_timeout, opts.connection_send_timeout };
+    SocketTimeoutParams timeout_params { opts.connection_connect_timeout, opts.connection_recv_timeout, opts.connection_send_timeout, opts.connection_attempt_delay };
     return std::make_unique<Socket>(address, timeout_params);
 }
 
+std::unique_ptr<Socket> NonSecureSocketFactory::doWrap(Socket&& socket, const NetworkAddress& /*address*/, const ClientOptions& /*opts*/) {
+    return std::make_unique<Socket>(std::move(socket));
+}
+
+std::shared_ptr<const NetworkAddress> NonSecureSocketFactory::resolve(const Endpoint& endpoint) {
+    if (resolver_) {
+        return resolver_->resolve(endpoint.host, std::to_string(endpoint.port));
+    }
+    return std::make_shared<const NetworkAddress>(endpoint.host, std::to_string(endpoint.port));
+}
+
 void NonSecureSocketFactory::setSocketOptions(Socket &socket, const ClientOptions &opts) {
     if (opts.tcp_keepalive) {
         socket.SetTcpKeepAlive(
@@ -418,6 +688,16 @@ void NonSecureSocketFactory::setSocketOptions(Socket &socket, const ClientOption
     if (opts.tcp_nodelay) {
         socket.SetTcpNoDelay(opts.tcp_nodelay);
     }
+    if (opts.socket_recv_buffer_size > 0) {
+        socket.SetRecvBufferSize(opts.socket_recv_buffer_size);
+    }
+    if (opts.socket_send_buffer_size > 0) {
+        socket.SetSendBufferSize(opts.socket_send_buffer_size);
+    }
+    if (opts.zero_copy_send) {
+        // Falls back to regular send() if not supported.
+        socket.SetZeroCopy(true);
+    }
 }
 
 
@@ -442,6 +722,32 @@ size_t SocketInput::DoRead(void* buf, size_t len) {
     throw std::system_error(getSocketErrorCode(), getErrorCategory(), "can't receive string data");
 }
 
+size_t SocketInput::DoReadAll(void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    size_t total = 0;
+
+    // MSG_WAITALL lets the kernel fill the whole destination with a single call,
+    // it still may return less if interrupted by a signal or on timeout, then the loop continues
+    // and the next call fails if no data arrives.
+    while (total < len) {
+        const size_t chunk = std::min<size_t>(len - total, std::numeric_limits<int>::max());
+        const ssize_t ret = ::recv(s_, p + total, (int)chunk, MSG_WAITALL);
+
+        if (ret > 0) {
+            total += (size_t)ret;
+            continue;
+        }
+
+        if (ret == 0) {
+            throw std::system_error(getSocketErrorCode(), getErrorCategory(), "closed");
+        }
+
+        throw std::system_error(getSocketErrorCode(), getErrorCategory(), "can't receive string data");
+    }
+
+    return total;
+}
+
 bool SocketInput::Skip(size_t /*bytes*/) {
     return false;
 }
@@ -452,7 +758,21 @@ SocketOutput::SocketOutput(SOCKET s)
 {
 }
 
-SocketOutput::~SocketOutput() = default;
+SocketOutput::SocketOutput(SOCKET s, bool zero_copy, std::chrono::milliseconds completion_timeout)
+    : s_(s)
+    , zero_copy_(zero_copy)
+    , completion_timeout_(completion_timeout)
+{
+}
+
+SocketOutput::~SocketOutput() {
+    // Kernel may still reference memory of the last writes, make sure it is released
+    // before the caller gets a chance to free it.
+    try {
+        WaitZeroCopyCompletions();
+    } catch (...) {
+    }
+}
 
 size_t SocketOutput::DoWrite(const void* data, size_t len) {
 #if defined (_linux_)
@@ -461,6 +781,23 @@ size_t SocketOutput::DoWrite(const void* data, size_t len) {
     static const int flags = 0;
 #endif
 
+#if defined(_linux_) && defined(MSG_ZEROCOPY)
+    if (zero_copy_ && len >= kZeroCopyThreshold) {
+        const ssize_t ret = ::send(s_, (const char*)data, len, flags | MSG_ZEROCOPY);
+        if (ret >= 0) {
+            // Every successful MSG_ZEROCOPY send gets a sequential notification id, even if partial.
+            ++zero_copy_sent_;
+            return (size_t)ret;
+        }
+        // ENOBUFS means that the per-socket limit of pinned pages (optmem_max) is exhausted,
+        // release what is in flight and send this chunk with a plain copy.
+        if (getSocketErrorCode() != ENOBUFS) {
+            throw std::system_error(getSocketErrorCode(), getErrorCategory(), "fail to send " + std::to_string(len) + " bytes of data");
+        }
+        WaitZeroCopyCompletions();
+    }
+#endif
+
     const ssize_t ret = ::send(s_, (const char*)data, (int)len, flags);
     if (ret < 0) {
         throw std::system_error(getSocketErrorCode(), getErrorCategory(), "fail to send " + std::to_string(len) + " bytes of data");
@@ -469,6 +806,77 @@ size_t SocketOutput::DoWrite(const void* data, size_t len) {
     return (size_t)ret;
 }
 
+void SocketOutput::DoFlush() {
+    WaitZeroCopyCompletions();
+}
+
+void SocketOutput::DoRetain(std::shared_ptr<const void> owner) {
+    if (zero_copy_sent_ != zero_copy_completed_) {
+        retained_.push_back(std::move(owner));
+    }
+}
+
+void SocketOutput::WaitZeroCopyCompletions() {
+#if defined(_linux_) && defined(MSG_ZEROCOPY)
+    while (zero_copy_completed_ != zero_copy_sent_) {
+        // Completion notifications are delivered via the socket error queue, which is signalled with POLLERR.
+        pollfd fd;
+        fd.fd = s_;
+        fd.events = 0;
+        fd.revents = 0;
+        const int timeout = completion_timeout_.count() > 0 ? static_cast<int>(completion_timeout_.count()) : -1;
+        const ssize_t rval = Poll(&fd, 1, timeout);
+        if (rval < 0) {
+            if (getSocketErrorCode() == EINTR) {
+                continue;
+            }
+            throw std::system_error(getSocketErrorCode(), getErrorCategory(), "fail to wait for zero-copy send completion");
+        }
+        if (rval == 0) {
+            throw std::system_error(ETIMEDOUT, getErrorCategory(), "fail to wait for zero-copy send completion");
+        }
+
+        char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))];
+        msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (::recvmsg(s_, &msg, MSG_ERRQUEUE) < 0) {
+            const int err = getSocketErrorCode();
+            if (err == EAGAIN || err == EWOULDBLOCK || err == EINTR) {
+                continue;
+            }
+            throw std::system_error(err, getErrorCategory(), "fail to receive zero-copy send completion");
+        }
+
+        for (cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+            const bool is_recverr = (cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR)
+                || (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR);
+            if (!is_recverr) {
+                continue;
+            }
+
+            sock_extended_err serr;
+            memcpy(&serr, CMSG_DATA(cm), sizeof(serr));
+            if (serr.ee_origin != SO_EE_ORIGIN_ZEROCOPY) {
+                throw std::system_error(static_cast<int>(serr.ee_errno), getErrorCategory(), "fail to send data");
+            }
+
+            // [ee_info, ee_data] is the inclusive range of completed send ids.
+            zero_copy_completed_ += serr.ee_data - serr.ee_info + 1;
+
+            if (serr.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                // Kernel had to copy data anyway (e.g. loopback or device without scatter-gather),
+                // pinning pages only adds overhead, so stop doing that.
+                zero_copy_ = false;
+            }
+        }
+    }
+#endif
+    retained_.clear();
+}
+
 
 NetrworkInitializer::NetrworkInitializer() {
     struct NetrworkInitializerImpl {
@@ -24,6 +24,7 @@
 #endif
 
 #include <memory>
+#include <vector>
 #include <system_error>
 
 struct addrinfo;
@@ -31,6 +32,7 @@ struct addrinfo;
 namespace clickhouse {
 
 struct ClientOptions;
+class AddressResolver;
 
 /** Address of a host to establish connection to.
  *
@@ -43,9 +45,11 @@ public:
 
     const struct addrinfo* Info() const;
     const std::string & Host() const;
+    const std::string & Port() const;
 
 private:
     const std::string host_;
+    const std::string port_;
     struct addrinfo* info_;
 };
 
@@ -80,6 +84,10 @@ public:
 
     virtual std::unique_ptr<InputStream> makeInputStream() const = 0;
     virtual std::unique_ptr<OutputStream> makeOutputStream() const = 0;
+
+    /// Shuts the connection down, so reads and writes blocked on it fail. Unlike other methods,
+    /// may be called from another thread while the socket is in use. Does nothing by default.
+    virtual void Shutdown() noexcept;
 };
 
 
@@ -91,6 +99,10 @@ public:
 
     virtual std::unique_ptr<SocketBase> connect(const ClientOptions& opts, const Endpoint& endpoint) = 0;
 
+    /// Connects to the first of `endpoints` which accepts connection, `index` is set to its position.
+    /// Default implementation tries endpoints one by one.
+    virtual std::unique_ptr<SocketBase> connectAny(const ClientOptions& opts, const std::vector<Endpoint>& endpoints, size_t* index);
+
     virtual void sleepFor(const std::chrono::milliseconds& duration);
 };
 
@@ -99,6 +111,10 @@ struct SocketTimeoutParams {
     std::chrono::milliseconds connect_timeout{ 5000 };
     std::chrono::milliseconds recv_timeout{ 0 };
     std::chrono::milliseconds send_timeout{ 0 };
+    /// If not zero, next address is tried after this delay without waiting for the previous attempt to complete,
+    /// and addresses are tried alternating address families (IPv6, IPv4, ...). Otherwise addresses are tried
+    /// one by one in the order of the resolver.
+    std::chrono::milliseconds connection_attempt_delay{ 0 };
 };
 
 class Socket : public SocketBase {
@@ -110,6 +126,10 @@ public:
 
     ~Socket() override;
 
+    /// Races connection attempts to all the addresses (see SocketTimeoutParams::connection_attempt_delay),
+    /// `index` is set to position of the address connected to.
+    static Socket ConnectAny(const std::vector<const NetworkAddress*>& addresses, const SocketTimeoutParams& timeout_params, size_t* index);
+
     /// @params idle the time (in seconds) the connection needs to remain
     ///         idle before TCP starts sending keepalive probes.
     /// @params intvl the time (in seconds) between individual keepalive probes.
@@ -120,28 +140,57 @@ public:
     /// @params nodelay whether to enable TCP_NODELAY
     void SetTcpNoDelay(bool nodelay) noexcept;
 
+    /// @params size size of the kernel receive buffer (SO_RCVBUF) in bytes.
+    void SetRecvBufferSize(int size) noexcept;
+
+    /// @params size size of the kernel send buffer (SO_SNDBUF) in bytes.
+    void SetSendBufferSize(int size) noexcept;
+
+    /// Enables SO_ZEROCOPY, so large writes to the output stream are sent with MSG_ZEROCOPY.
+    /// Linux only, returns false if zero-copy send is not supported by the platform or kernel.
+    bool SetZeroCopy(bool enable) noexcept;
+
     std::unique_ptr<InputStream> makeInputStream() const override;
     std::unique_ptr<OutputStream> makeOutputStream() const override;
 
+    void Shutdown() noexcept override;
+
 protected:
+    Socket(SOCKET handle, const SocketTimeoutParams& timeout_params) noexcept;
     Socket(const Socket&) = delete;
     Socket& operator = (const Socket&) = delete;
     void Close();
 
     SOCKET handle_;
+    bool zero_copy_ = false;
+    std::chrono::milliseconds send_timeout_{0};
 };
 
 
 class NonSecureSocketFactory : public SocketFactory {
 public:
+    /// @params resolver resolves endpoint host names, e.g. CachingResolver,
+    ///         if null, host names are resolved with getaddrinfo() on each connect.
+    explicit NonSecureSocketFactory(std::shared_ptr<AddressResolver> resolver = nullptr);
     ~NonSecureSocketFactory() override;
 
     std::unique_ptr<SocketBase> connect(const ClientOptions& opts, const Endpoint& endpoint) override;
 
+    /// Races TCP connects to all addresses of all endpoints, see ClientOptions::connection_attempt_delay.
+    std::unique_ptr<SocketBase> connectAny(const ClientOptions& opts, const std::vector<Endpoint>& endpoints, size_t* index) override;
+
 protected:
     virtual std::unique_ptr<Socket> doConnect(const NetworkAddress& address, const ClientOptions& opts);
 
+    /// Makes a socket of the factory type over an already connected one.
+    virtual std::unique_ptr<Socket> doWrap(Socket&& socket, const NetworkAddress& address, const ClientOptions& opts);
+
     void setSocketOptions(Socket& socket, const ClientOptions& opts);
+
+    std::shared_ptr<const NetworkAddress> resolve(const Endpoint& endpoint);
+
+private:
+    const std::shared_ptr<AddressResolver> resolver_;
 };
 
 
@@ -153,6 +202,7 @@ public:
 protected:
     bool Skip(size_t bytes) override;
     size_t DoRead(void* buf, size_t len) override;
+    size_t DoReadAll(void* buf, size_t len) override;
 
 private:
     SOCKET s_;
@@ -161,13 +211,35 @@ private:
 class SocketOutput : public OutputStream {
 public:
     explicit SocketOutput(SOCKET s);
+    /// @params zero_copy send chunks of at least kZeroCopyThreshold bytes with MSG_ZEROCOPY,
+    ///         socket must have SO_ZEROCOPY enabled.
+    /// @params completion_timeout max time to wait for kernel to release zero-copy buffers on Flush(),
+    ///         zero means no timeout.
+    SocketOutput(SOCKET s, bool zero_copy, std::chrono::milliseconds completion_timeout);
     ~SocketOutput();
 
+    /// Chunks smaller than that are cheaper to copy than to pin and wait for completion.
+    static constexpr size_t kZeroCopyThreshold = 64 * 1024;
+
 protected:
+    /// Data passed to DoWrite() in zero-copy mode is referenced by the kernel until DoFlush() returns,
+    /// caller must not modify or free it before calling Flush(), unless its owner is passed to Retain().
     size_t DoWrite(const void* data, size_t len) override;
+    void DoFlush() override;
+    void DoRetain(std::shared_ptr<const void> owner) override;
+
+private:
+    void WaitZeroCopyCompletions();
 
 private:
     SOCKET s_;
+    bool zero_copy_ = false;
+    std::chrono::milliseconds completion_timeout_{0};
+    /// Number of MSG_ZEROCOPY sends issued and number of those acknowledged by the kernel.
+    uint32_t zero_copy_sent_ = 0;
+    uint32_t zero_copy_completed_ = 0;
+    /// Owners of the memory which may be referenced by zero-copy sends in flight.
+    std::vector<std::shared_ptr<const void>> retained_;
 };
 
 static struct NetrworkInitializer {
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+namespace clickhouse {
+
+/**
+ * Non-owning view of contiguous sequence of elements, a minimal substitute of C++20 std::span.
+ */
+template <typename T>
+class Span {
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = size_t;
+    using pointer = T*;
+    using reference = T&;
+    using iterator = T*;
+
+    constexpr Span() noexcept = default;
+
+    constexpr Span(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size)
+    {}
+
+    /// Span of a contiguous container, e.g. std::vector or std::string.
+    /// Like std::span, a span of const values may refer to a temporary, e.g. an argument of a function.
+    template <typename Container, typename = std::enable_if_t<
+        std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>
+        && (std::is_lvalue_reference_v<Container> || std::is_const_v<T>)>>
+    constexpr Span(Container&& container) noexcept
+        : data_(container.data())
+        , size_(container.size())
+    {}
+
+    /// Span<const T> from Span<T>.
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    constexpr Span(const Span<U>& other) noexcept
+        : data_(other.data())
+        , size_(other.size())
+    {}
+
+    constexpr T* data() const noexcept { return data_; }
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr size_t size_bytes() const noexcept { return size_ * sizeof(T); }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+
+    /// No bounds checking.
+    constexpr T& operator[](size_t i) const noexcept { return data_[i]; }
+
+    constexpr T& front() const noexcept { return data_[0]; }
+    constexpr T& back() const noexcept { return data_[size_ - 1]; }
+
+    constexpr iterator begin() const noexcept { return data_; }
+    constexpr iterator end() const noexcept { return data_ + size_; }
+
+    /// Elements [offset, offset + count), `count` is clamped to the end of the span.
+    constexpr Span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const noexcept {
+        offset = offset < size_ ? offset : size_;
+        return Span(data_ + offset, count < size_ - offset ? count : size_ - offset);
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+}
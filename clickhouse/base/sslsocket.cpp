@@ -2,8 +2,11 @@
 #include "../client.h"
 #include "../exceptions.h"
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
+#include <time.h>
 
 #include <openssl/ssl.h>
 #include <openssl/x509v3.h>
@@ -175,7 +178,8 @@ clickhouse::SSLParams GetSSLParams(const clickhouse::ClientOptions& opts) {
             ssl_options.skip_verification,
             ssl_options.host_flags,
             ssl_options.server_host_name,
-            convertConfiguration(ssl_options.configuration)
+            convertConfiguration(ssl_options.configuration),
+            ssl_options.use_ktls
     };
 }
 
@@ -183,14 +187,78 @@ clickhouse::SSLParams GetSSLParams(const clickhouse::ClientOptions& opts) {
 
 namespace clickhouse {
 
-SSLContext::SSLContext(SSL_CTX & context)
+SSLSessionCache::SSLSessionCache() = default;
+
+SSLSessionCache::~SSLSessionCache() = default;
+
+uint64_t SSLSessionCache::Hits() const noexcept {
+    return hits_.load(std::memory_order_relaxed);
+}
+
+uint64_t SSLSessionCache::Misses() const noexcept {
+    return misses_.load(std::memory_order_relaxed);
+}
+
+size_t SSLSessionCache::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+void SSLSessionCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sessions_.clear();
+}
+
+SSL_SESSION * SSLSessionCache::get(const std::string & key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = sessions_.find(key);
+    if (it == sessions_.end())
+        return nullptr;
+
+    SSL_SESSION * session = it->second.get();
+    // Session becomes non-resumable if connection which used it failed.
+    if (!SSL_SESSION_is_resumable(session)) {
+        sessions_.erase(it);
+        return nullptr;
+    }
+
+    const auto expires_at = static_cast<int64_t>(SSL_SESSION_get_time(session)) + static_cast<int64_t>(SSL_SESSION_get_timeout(session));
+    if (expires_at <= static_cast<int64_t>(time(nullptr))) {
+        sessions_.erase(it);
+        return nullptr;
+    }
+
+    SSL_SESSION_up_ref(session);
+    return session;
+}
+
+void SSLSessionCache::put(const std::string & key, SSL_SESSION * session) {
+    std::unique_ptr<SSL_SESSION, void (*)(SSL_SESSION*)> holder(session, &SSL_SESSION_free);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(key);
+    if (it != sessions_.end())
+        it->second = std::move(holder);
+    else
+        sessions_.emplace(key, std::move(holder));
+}
+
+void SSLSessionCache::onHandshake(bool resumed) noexcept {
+    (resumed ? hits_ : misses_).fetch_add(1, std::memory_order_relaxed);
+}
+
+
+SSLContext::SSLContext(SSL_CTX & context, std::shared_ptr<SSLSessionCache> session_cache)
     : context_(&context, &SSL_CTX_free)
+    , session_cache_(std::move(session_cache))
 {
     SSL_CTX_up_ref(context_.get());
 }
 
-SSLContext::SSLContext(const SSLParams & context_params)
+SSLContext::SSLContext(const SSLParams & context_params, std::shared_ptr<SSLSessionCache> session_cache)
     : context_(prepareSSLContext(context_params), &SSL_CTX_free)
+    , session_cache_(std::move(session_cache))
 {
 }
 
@@ -198,6 +266,10 @@ SSL_CTX * SSLContext::getContext() {
     return context_.get();
 }
 
+const std::shared_ptr<SSLSessionCache> & SSLContext::getSessionCache() const {
+    return session_cache_;
+}
+
 // Allows caller to use returned value of `statement` if there was no error, throws exception otherwise.
 #define HANDLE_SSL_ERROR(SSL_PTR, statement) [&] { \
     if (const auto ret_code = (statement); ret_code <= 0) { \
@@ -216,8 +288,14 @@ SSL_CTX * SSLContext::getContext() {
 */
 SSLSocket::SSLSocket(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params,
                      const SSLParams & ssl_params, SSLContext& context)
-    : Socket(addr, timeout_params)
+    : SSLSocket(Socket(addr, timeout_params), addr, ssl_params, context)
+{
+}
+
+SSLSocket::SSLSocket(Socket&& socket, const NetworkAddress& addr, const SSLParams & ssl_params, SSLContext& context)
+    : Socket(std::move(socket))
     , ssl_(SSL_new(context.getContext()), &SSL_free)
+    , session_cache_(context.getSessionCache())
 {
     auto ssl = ssl_.get();
     if (!ssl)
@@ -243,6 +321,23 @@ SSLSocket::SSLSocket(const NetworkAddress& addr, const SocketTimeoutParams& time
     if (ssl_params.configuration.size() > 0)
         configureSSL(ssl_params.configuration, ssl);
 
+    if (ssl_params.use_ktls) {
+#if defined(SSL_OP_ENABLE_KTLS)
+        // Keys are handed to the kernel right after the handshake, if kernel doesn't support
+        // negotiated cipher or kTLS at all, OpenSSL keeps doing encryption in user space.
+        SSL_set_options(ssl, SSL_OP_ENABLE_KTLS);
+#endif
+    }
+
+    if (session_cache_) {
+        // Server may have different certificates for different names, so SNI is a part of the key.
+        session_key_ = addr.Host() + ":" + addr.Port() + "/" + (ssl_params.use_SNI ? tls_host_name : std::string());
+        if (auto session = session_cache_->get(session_key_)) {
+            SSL_set_session(ssl, session);
+            SSL_SESSION_free(session);
+        }
+    }
+
     SSL_set_connect_state(ssl);
     HANDLE_SSL_ERROR(ssl, SSL_connect(ssl));
     HANDLE_SSL_ERROR(ssl, SSL_set_mode(ssl, SSL_MODE_AUTO_RETRY));
@@ -255,6 +350,13 @@ SSLSocket::SSLSocket(const NetworkAddress& addr, const SocketTimeoutParams& time
                 + "\nServer certificate: " + getCertificateInfo(SSL_get_peer_certificate(ssl)));
     }
 
+    if (session_cache_) {
+        session_cache_->onHandshake(SSL_session_reused(ssl));
+        // With TLS 1.2 session is resumable right after the handshake, with TLS 1.3
+        // tickets come later and are picked up when connection is closed.
+        storeSession();
+    }
+
     // Host name verification is done by OpenSSL itself, however if we are connecting to an ip-address,
     // no verification is made, so we have to do it manually.
     // Just in case if this is ever required, leave it here commented out.
@@ -268,6 +370,36 @@ SSLSocket::SSLSocket(const NetworkAddress& addr, const SocketTimeoutParams& time
 //    }
 }
 
+SSLSocket::~SSLSocket() {
+    if (!ssl_ || !session_cache_)
+        return;
+
+    try {
+        storeSession();
+    } catch (...) {
+        // Failing to cache the session only means a full handshake next time.
+    }
+
+    // Otherwise SSL_free() treats connection as broken and invalidates the session.
+    // Quiet shutdown doesn't send close_notify, so destructor never blocks on the network.
+    if (SSL_is_init_finished(ssl_.get())) {
+        SSL_set_quiet_shutdown(ssl_.get(), 1);
+        SSL_shutdown(ssl_.get());
+    }
+}
+
+void SSLSocket::storeSession() {
+    if (!ssl_ || !session_cache_)
+        return;
+
+    if (SSL_SESSION * session = SSL_get1_session(ssl_.get())) {
+        if (SSL_SESSION_is_resumable(session))
+            session_cache_->put(session_key_, session);
+        else
+            SSL_SESSION_free(session);
+    }
+}
+
 void SSLSocket::validateParams(const SSLParams & ssl_params) {
     // We need either SSL or SSL_CTX to properly validate configuration, so create a temporary one.
     std::unique_ptr<SSL_CTX, decltype(&SSL_CTX_free)> ctx(SSL_CTX_new(TLS_client_method()), &SSL_CTX_free);
@@ -276,22 +408,49 @@ void SSLSocket::validateParams(const SSLParams & ssl_params) {
 
 
 SSLSocketFactory::SSLSocketFactory(const ClientOptions& opts)
-    : NonSecureSocketFactory()
+    : NonSecureSocketFactory(opts.resolver)
     , ssl_params_(GetSSLParams(opts)) {
+    std::shared_ptr<SSLSessionCache> session_cache;
+    if (opts.ssl_options->use_session_cache) {
+        session_cache = opts.ssl_options->session_cache
+            ? opts.ssl_options->session_cache
+            : std::make_shared<SSLSessionCache>();
+    }
+
     if (opts.ssl_options->ssl_context) {
-        ssl_context_ = std::make_unique<SSLContext>(*opts.ssl_options->ssl_context);
+        ssl_context_ = std::make_unique<SSLContext>(*opts.ssl_options->ssl_context, std::move(session_cache));
     } else {
-        ssl_context_ = std::make_unique<SSLContext>(ssl_params_);
+        ssl_context_ = std::make_unique<SSLContext>(ssl_params_, std::move(session_cache));
     }
 }
 
 SSLSocketFactory::~SSLSocketFactory() = default;
 
 std::unique_ptr<Socket> SSLSocketFactory::doConnect(const NetworkAddress& address, const ClientOptions& opts) {
-    SocketTimeoutParams timeout_params { opts.connection_connect_timeout, opts.connection_recv_timeout, opts.connection_send_timeout };
+    SocketTimeoutParams timeout_params { opts.connection_connect_timeout, opts.connection_recv_timeout, opts.connection_send_timeout, opts.connection_attempt_delay };
     return std::make_unique<SSLSocket>(address, timeout_params, ssl_params_, *ssl_context_);
 }
 
+std::unique_ptr<Socket> SSLSocketFactory::doWrap(Socket&& socket, const NetworkAddress& address, const ClientOptions& /*opts*/) {
+    return std::make_unique<SSLSocket>(std::move(socket), address, ssl_params_, *ssl_context_);
+}
+
+bool SSLSocket::IsKTLSSendEnabled() const {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    return BIO_get_ktls_send(SSL_get_wbio(ssl_.get()));
+#else
+    return false;
+#endif
+}
+
+bool SSLSocket::IsKTLSRecvEnabled() const {
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+    return BIO_get_ktls_recv(SSL_get_rbio(ssl_.get()));
+#else
+    return false;
+#endif
+}
+
 std::unique_ptr<InputStream> SSLSocket::makeInputStream() const {
     return std::make_unique<SSLSocketInput>(ssl_.get());
 }
@@ -324,11 +483,18 @@ SSLSocketOutput::SSLSocketOutput(SSL *ssl)
 {}
 
 size_t SSLSocketOutput::DoWrite(const void* data, size_t len) {
-    if (len > std::numeric_limits<int>::max())
-        // FIXME(vnemkov): We should do multiple `SSL_write`s in this case.
-        throw AssertionError("Failed to write too big chunk at once "
-                + std::to_string(len) + " > " + std::to_string(std::numeric_limits<int>::max()));
-    return static_cast<size_t>(HANDLE_SSL_ERROR(ssl_, SSL_write(ssl_, data, static_cast<int>(len))));
+#ifdef USE_BORINGSSL
+    // BoringSSL doesn't have SSL_write_ex, so write at most INT_MAX bytes at once,
+    // the rest is written by subsequent calls from WireFormat::WriteAll().
+    const int max_write = static_cast<int>(
+        std::min<std::size_t>(len, std::numeric_limits<int>::max()));
+    return static_cast<size_t>(
+        HANDLE_SSL_ERROR(ssl_, SSL_write(ssl_, data, max_write)));
+#else
+    size_t actually_written;
+    HANDLE_SSL_ERROR(ssl_, SSL_write_ex(ssl_, data, len, &actually_written));
+    return actually_written;
+#endif
 }
 
 #undef HANDLE_SSL_ERROR
@@ -2,12 +2,16 @@
 
 #include "socket.h"
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 typedef struct ssl_ctx_st SSL_CTX;
 typedef struct ssl_st SSL;
+typedef struct ssl_session_st SSL_SESSION;
 
 namespace clickhouse {
 
@@ -25,13 +29,53 @@ struct SSLParams
     std::string server_host_name;
     using ConfigurationType = std::vector<std::pair<std::string, std::optional<std::string>>>;
     ConfigurationType configuration;
+    bool use_ktls = false;
+};
+
+/** Thread-safe cache of client TLS sessions, keyed by endpoint and SNI.
+ *
+ *  SSLSocket looks up a session before the handshake to resume it,
+ *  and stores the session (or the ticket received from the server) for the next connection.
+ */
+class SSLSessionCache
+{
+public:
+    SSLSessionCache();
+    ~SSLSessionCache();
+
+    SSLSessionCache(const SSLSessionCache &) = delete;
+    SSLSessionCache& operator=(const SSLSessionCache &) = delete;
+
+    /// Number of handshakes which resumed a cached session.
+    uint64_t Hits() const noexcept;
+    /// Number of full handshakes.
+    uint64_t Misses() const noexcept;
+
+    /// Number of cached sessions.
+    size_t Size() const;
+    void Clear();
+
+private:
+    friend class SSLSocket;
+
+    /// Returns a new reference to the session cached for the key, or null if there is no valid one.
+    SSL_SESSION * get(const std::string & key);
+    /// Takes ownership of the session reference.
+    void put(const std::string & key, SSL_SESSION * session);
+    void onHandshake(bool resumed) noexcept;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::unique_ptr<SSL_SESSION, void (*)(SSL_SESSION*)>> sessions_;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
 };
 
 class SSLContext
 {
 public:
-    explicit SSLContext(SSL_CTX & context);
-    explicit SSLContext(const SSLParams & context_params);
+    explicit SSLContext(SSL_CTX & context, std::shared_ptr<SSLSessionCache> session_cache = nullptr);
+    explicit SSLContext(const SSLParams & context_params, std::shared_ptr<SSLSessionCache> session_cache = nullptr);
     ~SSLContext() = default;
 
     SSLContext(const SSLContext &) = delete;
@@ -39,21 +83,27 @@ public:
     SSLContext(SSLContext &&) = delete;
     SSLContext& operator=(SSLContext &) = delete;
 
+    /// Session cache used by connections made with this context, may be null.
+    const std::shared_ptr<SSLSessionCache> & getSessionCache() const;
+
 private:
     friend class SSLSocket;
     SSL_CTX * getContext();
 
 private:
     std::unique_ptr<SSL_CTX, void (*)(SSL_CTX*)> context_;
+    std::shared_ptr<SSLSessionCache> session_cache_;
 };
 
 class SSLSocket : public Socket {
 public:
     explicit SSLSocket(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params,
                        const SSLParams& ssl_params, SSLContext& context);
+    /// Makes TLS handshake over already connected socket.
+    SSLSocket(Socket&& socket, const NetworkAddress& addr, const SSLParams& ssl_params, SSLContext& context);
 
     SSLSocket(SSLSocket &&) = default;
-    ~SSLSocket() override = default;
+    ~SSLSocket() override;
 
     SSLSocket(const SSLSocket & ) = delete;
     SSLSocket& operator=(const SSLSocket & ) = delete;
@@ -61,9 +111,20 @@ public:
     std::unique_ptr<InputStream> makeInputStream() const override;
     std::unique_ptr<OutputStream> makeOutputStream() const override;
 
+    /// Whether records sent over the connection are encrypted by the kernel (kTLS).
+    bool IsKTLSSendEnabled() const;
+    /// Whether records received over the connection are decrypted by the kernel (kTLS).
+    bool IsKTLSRecvEnabled() const;
+
     static void validateParams(const SSLParams & ssl_params);
+private:
+    /// Stores current session into the cache, so the next connection can resume it.
+    void storeSession();
+
 private:
     std::unique_ptr<SSL, void (*)(SSL *s)> ssl_;
+    std::shared_ptr<SSLSessionCache> session_cache_;
+    std::string session_key_;
 };
 
 class SSLSocketFactory : public NonSecureSocketFactory {
@@ -73,6 +134,7 @@ public:
 
 protected:
     std::unique_ptr<Socket> doConnect(const NetworkAddress& address, const ClientOptions& opts) override;
+    std::unique_ptr<Socket> doWrap(Socket&& socket, const NetworkAddress& address, const ClientOptions& opts) override;
 
 private:
     const SSLParams ssl_params_;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace clickhouse {
+
+class Stopwatch {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Stopwatch() noexcept
+        : start_(Clock::now())
+    { }
+
+    /// Nanoseconds since construction.
+    inline uint64_t ElapsedNanoseconds() const noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count();
+    }
+
+private:
+    const Clock::time_point start_;
+};
+
+/// Adds time spent in the scope to `counter`, does nothing if `counter` is null.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(uint64_t* counter) noexcept
+        : counter_(counter)
+        , start_(counter ? Stopwatch::Clock::now() : Stopwatch::Clock::time_point{})
+    { }
+
+    ~ScopedTimer() {
+        if (counter_) {
+            *counter_ += std::chrono::duration_cast<std::chrono::nanoseconds>(Stopwatch::Clock::now() - start_).count();
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    uint64_t* const counter_;
+    const Stopwatch::Clock::time_point start_;
+};
+
+}
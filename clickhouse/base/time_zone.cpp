@@ -0,0 +1,574 @@
+#include "time_zone.h"
+
+#include "../exceptions.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+namespace clickhouse {
+
+namespace {
+
+constexpr int64_t kSecondsInDay = 86400;
+/// Transitions produced by POSIX TZ rules are generated up to this year.
+constexpr int64_t kLastGeneratedYear = 2300;
+
+int64_t FloorDiv(int64_t value, int64_t divisor) {
+    const int64_t quotient = value / divisor;
+    return (value % divisor < 0) ? quotient - 1 : quotient;
+}
+
+/// Days since UNIX epoch of the proleptic Gregorian date, see http://howardhinnant.github.io/date_algorithms.html
+int64_t DaysFromCivil(int64_t year, int64_t month, int64_t day) {
+    year -= month <= 2;
+    const int64_t era = FloorDiv(year, 400);
+    const int64_t year_of_era = year - era * 400;
+    const int64_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+void CivilFromDays(int64_t days, CivilTime& time) {
+    days += 719468;
+    const int64_t era = FloorDiv(days, 146097);
+    const int64_t day_of_era = days - era * 146097;
+    const int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const int64_t mp = (5 * day_of_year + 2) / 153;
+    const int64_t month = mp < 10 ? mp + 3 : mp - 9;
+
+    time.year = static_cast<int32_t>(year_of_era + era * 400 + (month <= 2));
+    time.month = static_cast<uint8_t>(month);
+    time.day = static_cast<uint8_t>(day_of_year - (153 * mp + 2) / 5 + 1);
+}
+
+bool IsLeapYear(int64_t year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+int64_t DaysInMonth(int64_t year, int64_t month) {
+    static const int64_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return days[month - 1] + (month == 2 && IsLeapYear(year));
+}
+
+char* WriteDigits(uint32_t value, size_t digits, char* out) {
+    for (size_t i = digits; i > 0; --i) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    return out + digits;
+}
+
+char* WriteDate(const CivilTime& time, char* out) {
+    int64_t year = time.year;
+    if (year < 0) {
+        *out++ = '-';
+        year = -year;
+    }
+    size_t digits = 4;
+    for (int64_t limit = 10000; year >= limit; limit *= 10) {
+        ++digits;
+    }
+    out = WriteDigits(static_cast<uint32_t>(year), digits, out);
+    *out++ = '-';
+    out = WriteDigits(time.month, 2, out);
+    *out++ = '-';
+    return WriteDigits(time.day, 2, out);
+}
+
+/// Rule of a POSIX TZ string: the day of a year and the local time of a transition.
+struct PosixRule {
+    enum Kind { Julian, ZeroBasedDay, MonthWeekDay };
+
+    Kind kind = MonthWeekDay;
+    int64_t day = 0;
+    int64_t week = 0;
+    int64_t month = 0;
+    int64_t time = 2 * 3600;
+
+    /// Seconds since UNIX epoch of the transition in local time of `year`.
+    int64_t LocalTime(int64_t year) const {
+        int64_t days = DaysFromCivil(year, 1, 1);
+        switch (kind) {
+            case Julian:
+                // 1..365, February 29 is never counted.
+                days += day - 1 + (IsLeapYear(year) && day >= 60);
+                break;
+            case ZeroBasedDay:
+                days += day;
+                break;
+            case MonthWeekDay: {
+                const int64_t first = DaysFromCivil(year, month, 1);
+                // 1970-01-01 is Thursday, the 4th day of a week starting from Sunday.
+                const int64_t weekday = first + 4 - FloorDiv(first + 4, 7) * 7;
+                int64_t day_of_month = (day - weekday + 7) % 7 + (week - 1) * 7;
+                // Week 5 means the last such day of the month.
+                while (day_of_month >= DaysInMonth(year, month)) {
+                    day_of_month -= 7;
+                }
+                days = first + day_of_month;
+                break;
+            }
+        }
+        return days * kSecondsInDay + time;
+    }
+};
+
+/// Parser of the POSIX TZ string of TZif footers, e.g. "CET-1CEST,M3.5.0,M10.5.0/3".
+class PosixTimeZoneParser {
+public:
+    explicit PosixTimeZoneParser(const std::string& text)
+        : text_(text)
+    {}
+
+    bool Parse() {
+        if (!ParseName() || !ParseOffset(std_offset_)) {
+            return false;
+        }
+        // POSIX offsets are positive west of Greenwich.
+        std_offset_ = -std_offset_;
+        if (AtEnd()) {
+            return true;
+        }
+
+        has_dst_ = true;
+        if (!ParseName()) {
+            return false;
+        }
+        dst_offset_ = std_offset_ + 3600;
+        if (!AtEnd() && Peek() != ',') {
+            if (!ParseOffset(dst_offset_)) {
+                return false;
+            }
+            dst_offset_ = -dst_offset_;
+        }
+
+        if (AtEnd()) {
+            // The default rule of POSIX, US rules since 2007.
+            start_ = PosixRule{PosixRule::MonthWeekDay, 0, 2, 3, 2 * 3600};
+            end_ = PosixRule{PosixRule::MonthWeekDay, 0, 1, 11, 2 * 3600};
+            return true;
+        }
+        return Consume(',') && ParseRule(start_) && Consume(',') && ParseRule(end_) && AtEnd();
+    }
+
+    int64_t std_offset_ = 0;
+    int64_t dst_offset_ = 0;
+    bool has_dst_ = false;
+    PosixRule start_;
+    PosixRule end_;
+
+private:
+    bool AtEnd() const { return pos_ == text_.size(); }
+    char Peek() const { return text_[pos_]; }
+
+    bool Consume(char c) {
+        if (AtEnd() || Peek() != c) {
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    bool ParseNumber(int64_t& value) {
+        const size_t begin = pos_;
+        value = 0;
+        while (!AtEnd() && Peek() >= '0' && Peek() <= '9' && pos_ - begin < 6) {
+            value = value * 10 + (Peek() - '0');
+            ++pos_;
+        }
+        return pos_ != begin;
+    }
+
+    bool ParseName() {
+        if (Consume('<')) {
+            while (!AtEnd() && Peek() != '>') {
+                ++pos_;
+            }
+            return Consume('>');
+        }
+        const size_t begin = pos_;
+        while (!AtEnd() && ((Peek() >= 'a' && Peek() <= 'z') || (Peek() >= 'A' && Peek() <= 'Z'))) {
+            ++pos_;
+        }
+        return pos_ - begin >= 3;
+    }
+
+    /// [+-]hh[:mm[:ss]]
+    bool ParseOffset(int64_t& seconds) {
+        int64_t sign = 1;
+        if (Consume('-')) {
+            sign = -1;
+        } else {
+            Consume('+');
+        }
+
+        int64_t hours = 0, minutes = 0, secs = 0;
+        if (!ParseNumber(hours)) {
+            return false;
+        }
+        if (Consume(':') && (!ParseNumber(minutes) || (Consume(':') && !ParseNumber(secs)))) {
+            return false;
+        }
+        seconds = sign * (hours * 3600 + minutes * 60 + secs);
+        return true;
+    }
+
+    /// Jn, n or Mm.w.d optionally followed by /time
+    bool ParseRule(PosixRule& rule) {
+        if (Consume('J')) {
+            rule.kind = PosixRule::Julian;
+            if (!ParseNumber(rule.day) || rule.day < 1 || rule.day > 365) {
+                return false;
+            }
+        } else if (Consume('M')) {
+            rule.kind = PosixRule::MonthWeekDay;
+            if (!ParseNumber(rule.month) || !Consume('.') || !ParseNumber(rule.week) || !Consume('.') || !ParseNumber(rule.day)) {
+                return false;
+            }
+            if (rule.month < 1 || rule.month > 12 || rule.week < 1 || rule.week > 5 || rule.day > 6) {
+                return false;
+            }
+        } else {
+            rule.kind = PosixRule::ZeroBasedDay;
+            if (!ParseNumber(rule.day) || rule.day > 365) {
+                return false;
+            }
+        }
+
+        rule.time = 2 * 3600;
+        return !Consume('/') || ParseOffset(rule.time);
+    }
+
+private:
+    const std::string& text_;
+    size_t pos_ = 0;
+};
+
+/// Reader of big-endian integers of TZif data.
+class TZifReader {
+public:
+    explicit TZifReader(const std::string& data)
+        : data_(data)
+    {}
+
+    bool Skip(size_t bytes) {
+        if (data_.size() - pos_ < bytes) {
+            return false;
+        }
+        pos_ += bytes;
+        return true;
+    }
+
+    template <typename T>
+    bool Read(T& value) {
+        if (data_.size() - pos_ < sizeof(T)) {
+            return false;
+        }
+        uint64_t result = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            result = result << 8 | static_cast<uint8_t>(data_[pos_ + i]);
+        }
+        pos_ += sizeof(T);
+        value = static_cast<T>(result);
+        return true;
+    }
+
+    size_t Position() const { return pos_; }
+    const std::string& Data() const { return data_; }
+
+private:
+    const std::string& data_;
+    size_t pos_ = 0;
+};
+
+struct TZifHeader {
+    char version = 0;
+    uint32_t isutcnt = 0;
+    uint32_t isstdcnt = 0;
+    uint32_t leapcnt = 0;
+    uint32_t timecnt = 0;
+    uint32_t typecnt = 0;
+    uint32_t charcnt = 0;
+};
+
+bool ReadHeader(TZifReader& reader, TZifHeader& header) {
+    const size_t begin = reader.Position();
+    if (!reader.Skip(20) || reader.Data().compare(begin, 4, "TZif") != 0) {
+        return false;
+    }
+    header.version = reader.Data()[begin + 4];
+    return reader.Read(header.isutcnt) && reader.Read(header.isstdcnt) && reader.Read(header.leapcnt)
+        && reader.Read(header.timecnt) && reader.Read(header.typecnt) && reader.Read(header.charcnt)
+        && header.typecnt > 0;
+}
+
+size_t DataBlockSize(const TZifHeader& header, size_t time_size) {
+    return size_t(header.timecnt) * time_size + header.timecnt + size_t(header.typecnt) * 6 + header.charcnt
+        + size_t(header.leapcnt) * (time_size + 4) + header.isstdcnt + header.isutcnt;
+}
+
+struct ParsedZone {
+    std::vector<int64_t> transitions;
+    std::vector<int32_t> offsets;
+};
+
+template <typename Time>
+bool ReadDataBlock(TZifReader& reader, const TZifHeader& header, ParsedZone& zone) {
+    std::vector<int64_t> times(header.timecnt);
+    for (auto& time : times) {
+        Time value;
+        if (!reader.Read(value)) {
+            return false;
+        }
+        time = value;
+    }
+
+    std::vector<uint8_t> indices(header.timecnt);
+    for (auto& index : indices) {
+        if (!reader.Read(index) || index >= header.typecnt) {
+            return false;
+        }
+    }
+
+    std::vector<int32_t> type_offsets(header.typecnt);
+    for (auto& offset : type_offsets) {
+        if (!reader.Read(offset) || !reader.Skip(2)) {
+            return false;
+        }
+    }
+    if (!reader.Skip(header.charcnt + size_t(header.leapcnt) * (sizeof(Time) + 4) + header.isstdcnt + header.isutcnt)) {
+        return false;
+    }
+
+    // Local time before the first transition is specified by the first type.
+    zone.transitions.assign(1, std::numeric_limits<int64_t>::min());
+    zone.offsets.assign(1, type_offsets[0]);
+    for (size_t i = 0; i < times.size(); ++i) {
+        if (times[i] <= zone.transitions.back()) {
+            return false;
+        }
+        zone.transitions.push_back(times[i]);
+        zone.offsets.push_back(type_offsets[indices[i]]);
+    }
+    return true;
+}
+
+/// Appends transitions described by the POSIX TZ string of the footer after the last one of the table.
+bool ApplyPosixRule(const std::string& rule, ParsedZone& zone) {
+    PosixTimeZoneParser parser(rule);
+    if (!parser.Parse()) {
+        return false;
+    }
+
+    const int64_t last = zone.transitions.back();
+    if (!parser.has_dst_) {
+        if (zone.offsets.back() != parser.std_offset_) {
+            if (zone.transitions.size() == 1) {
+                zone.offsets.back() = static_cast<int32_t>(parser.std_offset_);
+            } else {
+                zone.transitions.push_back(last + 1);
+                zone.offsets.push_back(static_cast<int32_t>(parser.std_offset_));
+            }
+        }
+        return true;
+    }
+
+    int64_t first_year = 1970;
+    if (last != std::numeric_limits<int64_t>::min()) {
+        first_year = std::max<int64_t>(first_year, CivilTimeFromUnix(last).year);
+    }
+
+    std::vector<std::pair<int64_t, int32_t>> generated;
+    for (int64_t year = first_year; year <= kLastGeneratedYear; ++year) {
+        // Start of DST is in the local standard time, its end is in the local daylight saving time.
+        generated.emplace_back(parser.start_.LocalTime(year) - parser.std_offset_, static_cast<int32_t>(parser.dst_offset_));
+        generated.emplace_back(parser.end_.LocalTime(year) - parser.dst_offset_, static_cast<int32_t>(parser.std_offset_));
+    }
+    std::sort(generated.begin(), generated.end());
+
+    if (zone.transitions.size() == 1 && !generated.empty()) {
+        // Before the first rule transition, the zone is in the opposite state of it.
+        zone.offsets.back() = static_cast<int32_t>(
+            generated.front().second == parser.dst_offset_ ? parser.std_offset_ : parser.dst_offset_);
+    }
+    for (const auto& [time, offset] : generated) {
+        if (time > zone.transitions.back()) {
+            if (offset == zone.offsets.back()) {
+                continue;
+            }
+            zone.transitions.push_back(time);
+            zone.offsets.push_back(offset);
+        }
+    }
+    return true;
+}
+
+bool ParseTZif(const std::string& data, ParsedZone& zone) {
+    TZifReader reader(data);
+    TZifHeader header;
+    if (!ReadHeader(reader, header)) {
+        return false;
+    }
+    if (header.version == 0) {
+        return ReadDataBlock<int32_t>(reader, header, zone);
+    }
+
+    // Version 2+ files repeat the data with 64-bit times after the version 1 data and end with a POSIX TZ string
+    // describing times after the last transition.
+    if (!reader.Skip(DataBlockSize(header, 4)) || !ReadHeader(reader, header) || !ReadDataBlock<int64_t>(reader, header, zone)) {
+        return false;
+    }
+
+    const size_t begin = reader.Position() + 1;
+    const size_t end = data.find('\n', begin);
+    if (begin >= data.size() || data[begin - 1] != '\n' || end == std::string::npos) {
+        return false;
+    }
+    return end == begin || ApplyPosixRule(data.substr(begin, end - begin), zone);
+}
+
+std::shared_ptr<const TimeZone> LoadTimeZone(const std::string& name) {
+    if (name.empty() || name.front() == '/' || name.find("..") != std::string::npos) {
+        throw ValidationError("invalid time zone name '" + name + "'");
+    }
+
+    std::vector<std::string> directories;
+    if (const char* tzdir = std::getenv("TZDIR")) {
+        directories.emplace_back(tzdir);
+    }
+    directories.insert(directories.end(), {"/usr/share/zoneinfo", "/usr/lib/zoneinfo", "/usr/share/lib/zoneinfo"});
+
+    for (const auto& directory : directories) {
+        std::ifstream file(directory + "/" + name, std::ios::binary);
+        if (file) {
+            std::ostringstream data;
+            data << file.rdbuf();
+            return TimeZone::FromTZif(name, data.str());
+        }
+    }
+    throw ValidationError("time zone '" + name + "' is not found");
+}
+
+}
+
+bool operator==(const CivilTime& left, const CivilTime& right) {
+    return left.year == right.year && left.month == right.month && left.day == right.day
+        && left.hour == right.hour && left.minute == right.minute && left.second == right.second
+        && left.nanosecond == right.nanosecond && left.utc_offset == right.utc_offset;
+}
+
+CivilTime CivilTimeFromUnix(int64_t seconds) {
+    CivilTime result;
+    const int64_t days = FloorDiv(seconds, kSecondsInDay);
+    const int64_t seconds_of_day = seconds - days * kSecondsInDay;
+
+    CivilFromDays(days, result);
+    result.hour = static_cast<uint8_t>(seconds_of_day / 3600);
+    result.minute = static_cast<uint8_t>(seconds_of_day / 60 % 60);
+    result.second = static_cast<uint8_t>(seconds_of_day % 60);
+    return result;
+}
+
+size_t FormatDate(const CivilTime& time, char* out) {
+    return static_cast<size_t>(WriteDate(time, out) - out);
+}
+
+size_t FormatDateTime(const CivilTime& time, size_t fraction_digits, char* out) {
+    char* it = WriteDate(time, out);
+    *it++ = ' ';
+    it = WriteDigits(time.hour, 2, it);
+    *it++ = ':';
+    it = WriteDigits(time.minute, 2, it);
+    *it++ = ':';
+    it = WriteDigits(time.second, 2, it);
+
+    if (fraction_digits) {
+        fraction_digits = std::min<size_t>(fraction_digits, 9);
+        uint32_t fraction = time.nanosecond;
+        for (size_t i = fraction_digits; i < 9; ++i) {
+            fraction /= 10;
+        }
+        *it++ = '.';
+        it = WriteDigits(fraction, fraction_digits, it);
+    }
+    return static_cast<size_t>(it - out);
+}
+
+TimeZone::TimeZone(std::string name, std::vector<int64_t> transitions, std::vector<int32_t> offsets)
+    : name_(std::move(name))
+    , transitions_(std::move(transitions))
+    , offsets_(std::move(offsets))
+{
+}
+
+std::shared_ptr<const TimeZone> TimeZone::Get(const std::string& name) {
+    if (name.empty() || name == "UTC") {
+        return UTC();
+    }
+
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<const TimeZone>> zones;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& zone = zones[name];
+    if (!zone) {
+        try {
+            zone = LoadTimeZone(name);
+        } catch (...) {
+            zones.erase(name);
+            throw;
+        }
+    }
+    return zone;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::UTC() {
+    static const std::shared_ptr<const TimeZone> utc(
+        new TimeZone("UTC", {std::numeric_limits<int64_t>::min()}, {0}));
+    return utc;
+}
+
+std::shared_ptr<const TimeZone> TimeZone::FromTZif(std::string name, const std::string& data) {
+    ParsedZone zone;
+    if (!ParseTZif(data, zone)) {
+        throw ValidationError("malformed TZif data of time zone '" + name + "'");
+    }
+    return std::shared_ptr<const TimeZone>(new TimeZone(std::move(name), std::move(zone.transitions), std::move(zone.offsets)));
+}
+
+int32_t TimeZone::UtcOffset(int64_t seconds) const {
+    return offsets_[FindTransition(seconds, 0)];
+}
+
+CivilTime TimeZone::ToCivil(int64_t seconds) const {
+    size_t hint = 0;
+    return ToCivil(seconds, hint);
+}
+
+CivilTime TimeZone::ToCivil(int64_t seconds, size_t& hint) const {
+    hint = FindTransition(seconds, hint);
+    const int32_t offset = offsets_[hint];
+
+    CivilTime result = CivilTimeFromUnix(seconds + offset);
+    result.utc_offset = offset;
+    return result;
+}
+
+size_t TimeZone::FindTransition(int64_t seconds, size_t hint) const {
+    // Values of a column are often close to each other, check the period of the previous value and the next one first.
+    for (size_t i = hint; i < transitions_.size() && i < hint + 2; ++i) {
+        if (transitions_[i] <= seconds && (i + 1 == transitions_.size() || seconds < transitions_[i + 1])) {
+            return i;
+        }
+    }
+    return static_cast<size_t>(std::upper_bound(transitions_.begin(), transitions_.end(), seconds) - transitions_.begin()) - 1;
+}
+
+}
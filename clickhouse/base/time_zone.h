@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clickhouse {
+
+/// Broken-down (civil) time.
+struct CivilTime {
+    int32_t year = 1970;
+    /// 1..12
+    uint8_t month = 1;
+    /// 1..31
+    uint8_t day = 1;
+    uint8_t hour = 0;
+    uint8_t minute = 0;
+    uint8_t second = 0;
+    /// Sub-second part, set for DateTime64 values only.
+    uint32_t nanosecond = 0;
+    /// Offset of the local time from UTC in seconds, positive east of Greenwich.
+    int32_t utc_offset = 0;
+};
+
+bool operator==(const CivilTime& left, const CivilTime& right);
+inline bool operator!=(const CivilTime& left, const CivilTime& right) { return !(left == right); }
+
+/// Breaks down seconds since UNIX epoch in UTC.
+CivilTime CivilTimeFromUnix(int64_t seconds);
+
+/// Maximum number of characters written by FormatDate() and FormatDateTime().
+constexpr size_t kMaxFormattedDateTimeLength = 40;
+
+/// Writes "YYYY-MM-DD", returns the number of characters written.
+size_t FormatDate(const CivilTime& time, char* out);
+/// Writes "YYYY-MM-DD hh:mm:ss" followed by `fraction_digits` (at most 9) digits of nanoseconds
+/// after a dot if `fraction_digits` isn't 0, returns the number of characters written.
+size_t FormatDateTime(const CivilTime& time, size_t fraction_digits, char* out);
+
+/** Time zone of the tz database, a replacement of localtime_r() which takes a global lock and depends on
+ *  the process-wide TZ.
+ *
+ *  All the transitions, including ones described by the POSIX TZ rule at the end of TZif files, are
+ *  precomputed when the zone is loaded up to the year 2300 (the end of the DateTime64 range),
+ *  so conversion is a lookup in a sorted table, which is skipped when consecutive values fall
+ *  into the same period. Leap seconds are ignored, as in ClickHouse.
+ */
+class TimeZone {
+public:
+    /// Zone loaded from the tz database once per process and cached, e.g. "Europe/Amsterdam".
+    /// Empty name and "UTC" refer to UTC without touching the file system.
+    /// Files are looked up in $TZDIR, then in /usr/share/zoneinfo, /usr/lib/zoneinfo and /usr/share/lib/zoneinfo.
+    /// Throws ValidationError if the zone can't be found or loaded.
+    static std::shared_ptr<const TimeZone> Get(const std::string& name);
+
+    static std::shared_ptr<const TimeZone> UTC();
+
+    /// Zone from the contents of a TZif file (RFC 8536), e.g. for systems without the tz database.
+    /// Throws ValidationError if `data` is malformed.
+    static std::shared_ptr<const TimeZone> FromTZif(std::string name, const std::string& data);
+
+    const std::string& Name() const { return name_; }
+
+    /// Offset of the local time from UTC at the moment, in seconds.
+    int32_t UtcOffset(int64_t seconds) const;
+
+    /// Local time at `seconds` since UNIX epoch.
+    CivilTime ToCivil(int64_t seconds) const;
+
+    /// Same as ToCivil(seconds), `hint` is a position in the transition table kept between calls,
+    /// which avoids the lookup for close values. Initialize it with 0.
+    CivilTime ToCivil(int64_t seconds, size_t& hint) const;
+
+private:
+    TimeZone(std::string name, std::vector<int64_t> transitions, std::vector<int32_t> offsets);
+
+    /// Index of the last transition at or before `seconds`.
+    size_t FindTransition(int64_t seconds, size_t hint) const;
+
+private:
+    std::string name_;
+    /// Starts of periods with the same offset, the first one is the minimum value of int64_t.
+    std::vector<int64_t> transitions_;
+    std::vector<int32_t> offsets_;
+};
+
+}
@@ -0,0 +1,359 @@
+#include "uring_socket.h"
+#include "../client.h"
+
+#include <liburing.h>
+
+#include <errno.h>
+#include <system_error>
+#include <vector>
+
+namespace clickhouse {
+
+namespace {
+
+constexpr unsigned READ_BUFFER_INDEX = 0;
+constexpr unsigned WRITE_BUFFER_INDEX = 1;
+/// Room for a linked write of buffered and direct data and for cancellation of both.
+constexpr unsigned QUEUE_DEPTH = 4;
+/// user_data of cancellation requests, others are numbered from 0 in order of submission.
+constexpr uint64_t CANCEL_USER_DATA = ~uint64_t(0);
+
+__kernel_timespec ToTimespec(std::chrono::milliseconds timeout) {
+    __kernel_timespec ts;
+    ts.tv_sec = timeout.count() / 1000;
+    ts.tv_nsec = (timeout.count() % 1000) * 1000000;
+    return ts;
+}
+
+}
+
+/// Ring and registered buffers of a single connection.
+class IoUringContext {
+public:
+    struct Completion {
+        int res = 0;
+        uint32_t flags = 0;
+    };
+
+    IoUringContext(SOCKET fd, const IoUringParams& params, const SocketTimeoutParams& timeout_params);
+    ~IoUringContext();
+
+    /// Receives next portion of data into the registered read buffer, returns number of bytes received.
+    /// Data stays valid until the next call.
+    size_t Receive(const void** data);
+
+    /// Sends `buffered` bytes from the registered write buffer followed by `len` bytes of `data`,
+    /// both parts are submitted as a single linked chain.
+    void Send(size_t buffered, const void* data, size_t len);
+
+    inline uint8_t* WriteBuffer() noexcept {
+        return write_buffer_.data();
+    }
+
+    inline size_t BufferSize() const noexcept {
+        return buffer_size_;
+    }
+
+private:
+    io_uring_sqe* GetSqe();
+
+    /// Submits queued requests and waits for `count` completions, which are stored in `completions` by user_data.
+    /// Requests must have user_data 0, 1, ..., count - 1, at most 32 of them.
+    void Submit(Completion* completions, unsigned count, std::chrono::milliseconds timeout);
+
+    /// Cancels requests of Submit() which are still in flight (bit `i` of `completed` isn't set for request `i`)
+    /// and waits for their completions.
+    void CancelInFlight(uint32_t completed, unsigned count);
+
+private:
+    const SOCKET fd_;
+    const size_t buffer_size_;
+    const std::chrono::milliseconds recv_timeout_;
+    const std::chrono::milliseconds send_timeout_;
+
+    io_uring ring_;
+    std::vector<uint8_t> read_buffer_;
+    std::vector<uint8_t> write_buffer_;
+};
+
+IoUringContext::IoUringContext(SOCKET fd, const IoUringParams& params, const SocketTimeoutParams& timeout_params)
+    : fd_(fd)
+    , buffer_size_(params.buffer_size)
+    , recv_timeout_(timeout_params.recv_timeout)
+    , send_timeout_(timeout_params.send_timeout)
+    , read_buffer_(params.buffer_size)
+    , write_buffer_(params.buffer_size)
+{
+    if (const int ret = io_uring_queue_init(QUEUE_DEPTH, &ring_, 0); ret < 0) {
+        throw std::system_error(-ret, std::system_category(), "fail to initialize io_uring");
+    }
+
+    iovec buffers[2];
+    buffers[READ_BUFFER_INDEX] = iovec{read_buffer_.data(), read_buffer_.size()};
+    buffers[WRITE_BUFFER_INDEX] = iovec{write_buffer_.data(), write_buffer_.size()};
+    if (const int ret = io_uring_register_buffers(&ring_, buffers, 2); ret < 0) {
+        io_uring_queue_exit(&ring_);
+        throw std::system_error(-ret, std::system_category(), "fail to register io_uring buffers");
+    }
+}
+
+IoUringContext::~IoUringContext() {
+    // Also cancels whatever is still in flight, before buffers are released.
+    io_uring_queue_exit(&ring_);
+}
+
+io_uring_sqe* IoUringContext::GetSqe() {
+    io_uring_sqe* sqe = io_uring_get_sqe(&ring_);
+    if (!sqe) {
+        throw std::system_error(EBUSY, std::system_category(), "io_uring submission queue is full");
+    }
+    return sqe;
+}
+
+void IoUringContext::Submit(Completion* completions, unsigned count, std::chrono::milliseconds timeout) {
+    if (const int ret = io_uring_submit(&ring_); ret < 0) {
+        throw std::system_error(-ret, std::system_category(), "fail to submit io_uring requests");
+    }
+
+    uint32_t completed = 0;
+    for (unsigned done = 0; done < count;) {
+        io_uring_cqe* cqe = nullptr;
+        int ret;
+        if (timeout.count() > 0) {
+            __kernel_timespec ts = ToTimespec(timeout);
+            ret = io_uring_wait_cqe_timeout(&ring_, &cqe, &ts);
+        } else {
+            ret = io_uring_wait_cqe(&ring_, &cqe);
+        }
+
+        if (ret == -EINTR) {
+            continue;
+        }
+        if (ret == -ETIME) {
+            // Requests still in flight could write into the caller's buffers after it got the error,
+            // and their completions would be taken for ones of the next requests.
+            CancelInFlight(completed, count);
+            // Same error as reported by recv()/send() when SO_RCVTIMEO/SO_SNDTIMEO expires.
+            throw std::system_error(EAGAIN, std::system_category(), "io_uring request timed out");
+        }
+        if (ret < 0) {
+            throw std::system_error(-ret, std::system_category(), "fail to wait for io_uring completion");
+        }
+
+        const auto id = io_uring_cqe_get_data64(cqe);
+        completions[id] = Completion{cqe->res, cqe->flags};
+        completed |= uint32_t(1) << id;
+        io_uring_cqe_seen(&ring_, cqe);
+        ++done;
+    }
+}
+
+void IoUringContext::CancelInFlight(uint32_t completed, unsigned count) {
+    unsigned in_flight = 0;
+    unsigned cancels = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        if (!(completed & (uint32_t(1) << i))) {
+            io_uring_sqe* sqe = GetSqe();
+            io_uring_prep_cancel64(sqe, i, 0);
+            io_uring_sqe_set_data64(sqe, CANCEL_USER_DATA);
+            ++in_flight;
+            ++cancels;
+        }
+    }
+    if (const int ret = io_uring_submit(&ring_); ret < 0) {
+        throw std::system_error(-ret, std::system_category(), "fail to submit io_uring cancellation");
+    }
+
+    // Every request completes exactly once: cancelled, or with its result if it was done before
+    // the cancellation got to it. Results are dropped, the caller gets an error anyway.
+    while (in_flight || cancels) {
+        io_uring_cqe* cqe = nullptr;
+        const int ret = io_uring_wait_cqe(&ring_, &cqe);
+        if (ret == -EINTR) {
+            continue;
+        }
+        if (ret < 0) {
+            throw std::system_error(-ret, std::system_category(), "fail to wait for io_uring cancellation");
+        }
+
+        if (io_uring_cqe_get_data64(cqe) == CANCEL_USER_DATA) {
+            --cancels;
+        } else {
+            --in_flight;
+        }
+        io_uring_cqe_seen(&ring_, cqe);
+    }
+}
+
+size_t IoUringContext::Receive(const void** data) {
+    io_uring_sqe* sqe = GetSqe();
+    io_uring_prep_read_fixed(sqe, fd_, read_buffer_.data(), static_cast<unsigned>(read_buffer_.size()), 0, READ_BUFFER_INDEX);
+    io_uring_sqe_set_data64(sqe, 0);
+
+    Completion completion;
+    Submit(&completion, 1, recv_timeout_);
+
+    if (completion.res == 0) {
+        throw std::system_error(ECONNRESET, std::system_category(), "closed");
+    }
+    if (completion.res < 0) {
+        throw std::system_error(-completion.res, std::system_category(), "can't receive string data");
+    }
+
+    *data = read_buffer_.data();
+
+    return static_cast<size_t>(completion.res);
+}
+
+void IoUringContext::Send(size_t buffered, const void* data, size_t len) {
+    struct Segment {
+        const uint8_t* data;
+        size_t len;
+        bool registered;
+    };
+
+    Segment segments[2];
+    unsigned count = 0;
+    if (buffered) {
+        segments[count++] = Segment{write_buffer_.data(), buffered, true};
+    }
+    if (len) {
+        segments[count++] = Segment{static_cast<const uint8_t*>(data), len, false};
+    }
+
+    for (unsigned first = 0; first < count;) {
+        for (unsigned i = first; i < count; ++i) {
+            io_uring_sqe* sqe = GetSqe();
+            if (segments[i].registered) {
+                io_uring_prep_write_fixed(sqe, fd_, segments[i].data, static_cast<unsigned>(segments[i].len), 0, WRITE_BUFFER_INDEX);
+            } else {
+                // MSG_WAITALL makes the kernel retry short sends internally.
+                io_uring_prep_send(sqe, fd_, segments[i].data, segments[i].len, MSG_NOSIGNAL | MSG_WAITALL);
+            }
+            if (i + 1 < count) {
+                sqe->flags |= IOSQE_IO_LINK;
+            }
+            io_uring_sqe_set_data64(sqe, i - first);
+        }
+
+        Completion completions[2];
+        Submit(completions, count - first, send_timeout_);
+
+        for (unsigned i = first; i < count; ++i) {
+            const int res = completions[i - first].res;
+            if (res == -ECANCELED) {
+                // Chain was broken by a short write of the previous segment, resubmit the rest.
+                break;
+            }
+            if (res < 0) {
+                throw std::system_error(-res, std::system_category(), "fail to send " + std::to_string(segments[i].len) + " bytes of data");
+            }
+
+            segments[i].data += res;
+            segments[i].len -= res;
+            if (segments[i].len) {
+                break;
+            }
+            ++first;
+        }
+    }
+}
+
+
+IoUringSocket::IoUringSocket(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params, const IoUringParams& params)
+    : IoUringSocket(Socket(addr, timeout_params), timeout_params, params)
+{
+}
+
+IoUringSocket::IoUringSocket(Socket&& socket, const SocketTimeoutParams& timeout_params, const IoUringParams& params)
+    : Socket(std::move(socket))
+    , context_(std::make_shared<IoUringContext>(handle_, params, timeout_params))
+{
+}
+
+IoUringSocket::~IoUringSocket() = default;
+
+std::unique_ptr<InputStream> IoUringSocket::makeInputStream() const {
+    return std::make_unique<IoUringSocketInput>(context_);
+}
+
+std::unique_ptr<OutputStream> IoUringSocket::makeOutputStream() const {
+    return std::make_unique<IoUringSocketOutput>(context_);
+}
+
+
+IoUringSocketFactory::IoUringSocketFactory(IoUringParams params, std::shared_ptr<AddressResolver> resolver)
+    : NonSecureSocketFactory(std::move(resolver))
+    , params_(std::move(params))
+{
+}
+
+IoUringSocketFactory::~IoUringSocketFactory() = default;
+
+std::unique_ptr<Socket> IoUringSocketFactory::doConnect(const NetworkAddress& address, const ClientOptions& opts) {
+    SocketTimeoutParams timeout_params { opts.connection_connect_timeout, opts.connection_recv_timeout, opts.connection_send_timeout, opts.connection_attempt_delay };
+    return std::make_unique<IoUringSocket>(address, timeout_params, params_);
+}
+
+std::unique_ptr<Socket> IoUringSocketFactory::doWrap(Socket&& socket, const NetworkAddress& /*address*/, const ClientOptions& opts) {
+    SocketTimeoutParams timeout_params { opts.connection_connect_timeout, opts.connection_recv_timeout, opts.connection_send_timeout, opts.connection_attempt_delay };
+    return std::make_unique<IoUringSocket>(std::move(socket), timeout_params, params_);
+}
+
+
+IoUringSocketInput::IoUringSocketInput(std::shared_ptr<IoUringContext> context)
+    : context_(std::move(context))
+{
+}
+
+IoUringSocketInput::~IoUringSocketInput() = default;
+
+size_t IoUringSocketInput::DoNext(const void** ptr, size_t len) {
+    if (array_input_.Exhausted()) {
+        const void* data = nullptr;
+        const size_t size = context_->Receive(&data);
+        array_input_.Reset(data, size);
+    }
+
+    return array_input_.Next(ptr, len);
+}
+
+
+IoUringSocketOutput::IoUringSocketOutput(std::shared_ptr<IoUringContext> context)
+    : context_(std::move(context))
+    , array_output_(context_->WriteBuffer(), context_->BufferSize())
+{
+}
+
+IoUringSocketOutput::~IoUringSocketOutput() = default;
+
+void IoUringSocketOutput::DoFlush() {
+    if (array_output_.Size()) {
+        context_->Send(array_output_.Size(), nullptr, 0);
+        array_output_.Reset(context_->WriteBuffer(), context_->BufferSize());
+    }
+}
+
+size_t IoUringSocketOutput::DoNext(void** data, size_t len) {
+    if (array_output_.Avail() < len) {
+        Flush();
+    }
+
+    return array_output_.Next(data, len);
+}
+
+size_t IoUringSocketOutput::DoWrite(const void* data, size_t len) {
+    if (array_output_.Avail() < len) {
+        if (len > context_->BufferSize() / 2) {
+            // Send buffered data and the large chunk itself with a single submission, without copying the chunk.
+            context_->Send(array_output_.Size(), data, len);
+            array_output_.Reset(context_->WriteBuffer(), context_->BufferSize());
+            return len;
+        }
+        Flush();
+    }
+
+    return array_output_.Write(data, len);
+}
+
+}
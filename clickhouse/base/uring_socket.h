@@ -0,0 +1,80 @@
+#pragma once
+
+#include "socket.h"
+
+#include <memory>
+
+namespace clickhouse {
+
+struct IoUringParams {
+    /// Size of each of the registered read and write buffers.
+    size_t buffer_size = 64 * 1024;
+};
+
+class IoUringContext;
+
+/** Socket which does all I/O through its own io_uring instance.
+ *
+ *  Reads and writes go through buffers registered with the ring, so both streams are zero-copy
+ *  and are not wrapped into BufferedInput/BufferedOutput by the Client.
+ *  A large write is linked after the buffered data, so both are sent with one submission.
+ *
+ *  I/O stays synchronous: every read and every flush submits its requests and waits for them,
+ *  so it takes about as many syscalls as recv()/send() on a regular socket.
+ */
+class IoUringSocket : public Socket {
+public:
+    IoUringSocket(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params, const IoUringParams& params);
+    IoUringSocket(Socket&& socket, const SocketTimeoutParams& timeout_params, const IoUringParams& params);
+    ~IoUringSocket() override;
+
+    std::unique_ptr<InputStream> makeInputStream() const override;
+    std::unique_ptr<OutputStream> makeOutputStream() const override;
+
+private:
+    std::shared_ptr<IoUringContext> context_;
+};
+
+/// Creates IoUringSocket connections, Linux only, available if built with WITH_LIBURING.
+class IoUringSocketFactory : public NonSecureSocketFactory {
+public:
+    explicit IoUringSocketFactory(IoUringParams params = {}, std::shared_ptr<AddressResolver> resolver = nullptr);
+    ~IoUringSocketFactory() override;
+
+protected:
+    std::unique_ptr<Socket> doConnect(const NetworkAddress& address, const ClientOptions& opts) override;
+    std::unique_ptr<Socket> doWrap(Socket&& socket, const NetworkAddress& address, const ClientOptions& opts) override;
+
+private:
+    const IoUringParams params_;
+};
+
+class IoUringSocketInput : public ZeroCopyInput {
+public:
+    explicit IoUringSocketInput(std::shared_ptr<IoUringContext> context);
+    ~IoUringSocketInput() override;
+
+protected:
+    size_t DoNext(const void** ptr, size_t len) override;
+
+private:
+    std::shared_ptr<IoUringContext> context_;
+    ArrayInput array_input_;
+};
+
+class IoUringSocketOutput : public ZeroCopyOutput {
+public:
+    explicit IoUringSocketOutput(std::shared_ptr<IoUringContext> context);
+    ~IoUringSocketOutput() override;
+
+protected:
+    void DoFlush() override;
+    size_t DoNext(void** data, size_t len) override;
+    size_t DoWrite(const void* data, size_t len) override;
+
+private:
+    std::shared_ptr<IoUringContext> context_;
+    ArrayOutput array_output_;
+};
+
+}
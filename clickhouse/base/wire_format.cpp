@@ -16,17 +16,7 @@ constexpr int MAX_VARINT_BYTES = 10;
 namespace clickhouse {
 
 bool WireFormat::ReadAll(InputStream& input, void* buf, size_t len) {
-    uint8_t* p = static_cast<uint8_t*>(buf);
-
-    size_t read_previously = 1; // 1 to execute loop at least once
-    while (len > 0 && read_previously) {
-        read_previously = input.Read(p, len);
-
-        p += read_previously;
-        len -= read_previously;
-    }
-
-    return !len;
+    return input.ReadAll(buf, len) == len;
 }
 
 void WireFormat::WriteAll(OutputStream& output, const void* buf, size_t len) {
@@ -81,6 +81,22 @@ size_t Block::GetRowCount() const {
     return rows_;
 }
 
+size_t Block::ByteSize() const {
+    size_t result = 0;
+    for (const auto& item : columns_) {
+        result += item.column->ByteSize();
+    }
+    return result;
+}
+
+size_t Block::AllocatedBytes() const {
+    size_t result = 0;
+    for (const auto& item : columns_) {
+        result += item.column->AllocatedBytes();
+    }
+    return result;
+}
+
 size_t Block::RefreshRowCount() {
     size_t rows = 0UL;
 
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "columns/column.h"
+#include "base/memory_resource.h"
+
+#include <memory>
 
 namespace clickhouse {
 
@@ -81,6 +84,13 @@ public:
 
     size_t RefreshRowCount();
 
+    /// Sum of Column::ByteSize() of all columns.
+    size_t ByteSize() const;
+
+    /// Sum of Column::AllocatedBytes() of all columns. String data allocated from the arena is counted
+    /// by the columns, unused space of arena chunks is not.
+    size_t AllocatedBytes() const;
+
     const std::string& GetColumnName(size_t idx) const {
         return columns_.at(idx).name;
     }
@@ -100,6 +110,14 @@ public:
     Iterator cbegin() const { return begin(); }
     Iterator cend() const { return end(); }
 
+    /// Arena the columns of the block were allocated from, if any, see ClientOptions::block_arena_chunk_size.
+    /// Its memory is released once the block and all its columns are destroyed.
+    const std::shared_ptr<ArenaMemoryResource>& GetArena() const { return arena_; }
+    void SetArena(std::shared_ptr<ArenaMemoryResource> arena) { arena_ = std::move(arena); }
+
+    /// Bytes allocated by the arena, zero if there is none.
+    size_t ArenaAllocatedBytes() const { return arena_ ? arena_->AllocatedBytes() : 0; }
+
 private:
     struct ColumnItem {
         std::string name;
@@ -110,6 +128,7 @@ private:
     std::vector<ColumnItem> columns_;
     /// Count of rows in the block.
     size_t rows_;
+    std::shared_ptr<ArenaMemoryResource> arena_;
 };
 
 }
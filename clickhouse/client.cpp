@@ -1,9 +1,11 @@
 #include "client.h"
 #include "clickhouse/version.h"
 #include "protocol.h"
+#include "result_cache.h"
 
 #include "base/compressed.h"
 #include "base/socket.h"
+#include "base/stopwatch.h"
 #include "base/wire_format.h"
 
 #include "columns/factory.h"
@@ -45,8 +47,12 @@
 #define DBMS_MIN_PROTOCOL_VERSION_WITH_ADDENDUM 54458 // send quota key after handshake
 #define DBMS_MIN_PROTOCOL_REVISION_WITH_QUOTA_KEY 54458 // the same
 #define DBMS_MIN_PROTOCOL_VERSION_WITH_PARAMETERS 54459
+#define DBMS_MIN_PROTOCOL_VERSION_WITH_SERVER_QUERY_TIME_IN_PROGRESS 54460
+#define DBMS_MIN_PROTOCOL_VERSION_WITH_PASSWORD_COMPLEXITY_RULES 54461
+#define DBMS_MIN_REVISION_WITH_INTERSERVER_SECRET_V2    54462
+#define DBMS_MIN_PROTOCOL_VERSION_WITH_TOTAL_BYTES_IN_PROGRESS 54463
 
-#define DMBS_PROTOCOL_REVISION  DBMS_MIN_PROTOCOL_VERSION_WITH_PARAMETERS
+#define DMBS_PROTOCOL_REVISION  DBMS_MIN_PROTOCOL_VERSION_WITH_TOTAL_BYTES_IN_PROGRESS
 
 namespace clickhouse {
 
@@ -92,6 +98,7 @@ std::ostream& operator<<(std::ostream& os, const ClientOptions& opt) {
        << " ping_before_query:" << opt.ping_before_query
        << " send_retries:" << opt.send_retries
        << " retry_timeout:" << opt.retry_timeout.count()
+       << " connection_attempt_delay:" << opt.connection_attempt_delay.count()
        << " compression_method:"
        << (opt.compression_method == CompressionMethod::LZ4    ? "LZ4"
            : opt.compression_method == CompressionMethod::ZSTD ? "ZSTD"
@@ -107,6 +114,7 @@ std::ostream& operator<<(std::ostream& os, const ClientOptions& opt) {
            << " min_protocol_version: " << ssl_options.min_protocol_version
            << " max_protocol_version: " << ssl_options.max_protocol_version
            << " context_options: " << ssl_options.context_options
+           << " use_ktls: " << ssl_options.use_ktls
            << ")";
     }
 #endif
@@ -154,6 +162,12 @@ struct TableColumns {
 struct ProfileEvents {
     Block block;
 };
+struct Totals {
+    Block block;
+};
+struct Extremes {
+    Block block;
+};
 struct EndOfStream {
 };
 using DecodedPacket = std::variant<
@@ -167,6 +181,8 @@ using DecodedPacket = std::variant<
     Log,
     TableColumns,
     ProfileEvents,
+    Totals,
+    Extremes,
     EndOfStream>;
 
 std::unique_ptr<SocketFactory> GetSocketFactory(const ClientOptions& opts) {
@@ -176,18 +192,101 @@ std::unique_ptr<SocketFactory> GetSocketFactory(const ClientOptions& opts) {
         return std::make_unique<SSLSocketFactory>(opts);
     else
 #endif
-        return std::make_unique<NonSecureSocketFactory>();
+        return std::make_unique<NonSecureSocketFactory>(opts.resolver);
 }
 
-std::unique_ptr<EndpointsIteratorBase> GetEndpointsIterator(const ClientOptions& opts) {
+std::unique_ptr<EndpointsIteratorBase> GetEndpointsIterator(const ClientOptions& opts, std::shared_ptr<EndpointsStats> stats) {
     if (opts.endpoints.empty())
     {
         throw ValidationError("The list of endpoints is empty");
     }
 
+    switch (opts.endpoints_iteration_algorithm) {
+        case EndpointsIterationAlgorithm::LeastOutstanding:
+            return std::make_unique<LeastOutstandingEndpointsIterator>(opts.endpoints, std::move(stats));
+        case EndpointsIterationAlgorithm::PowerOfTwoChoices:
+            return std::make_unique<PowerOfTwoChoicesEndpointsIterator>(opts.endpoints, std::move(stats));
+        case EndpointsIterationAlgorithm::InOrder:
+            return std::make_unique<InOrderEndpointsIterator>(opts.endpoints, std::move(stats));
+        case EndpointsIterationAlgorithm::RoundRobin:
+            break;
+    }
+
     return std::make_unique<RoundRobinEndpointsIterator>(opts.endpoints);
 }
 
+/// Counts reads from the socket into ClientStats.
+class StatsInput : public InputStream {
+public:
+    StatsInput(std::unique_ptr<InputStream> slave, ClientStats* stats)
+        : slave_(std::move(slave))
+        , stats_(stats)
+    { }
+
+    bool Skip(size_t bytes) override {
+        ScopedTimer timer(&stats_->network_receive_ns);
+        ++stats_->recv_calls;
+        if (!slave_->Skip(bytes)) {
+            return false;
+        }
+        stats_->bytes_received += bytes;
+        return true;
+    }
+
+protected:
+    size_t DoRead(void* buf, size_t len) override {
+        ScopedTimer timer(&stats_->network_receive_ns);
+        ++stats_->recv_calls;
+        const size_t ret = slave_->Read(buf, len);
+        stats_->bytes_received += ret;
+        return ret;
+    }
+
+    size_t DoReadAll(void* buf, size_t len) override {
+        ScopedTimer timer(&stats_->network_receive_ns);
+        ++stats_->recv_calls;
+        const size_t ret = slave_->ReadAll(buf, len);
+        stats_->bytes_received += ret;
+        return ret;
+    }
+
+private:
+    std::unique_ptr<InputStream> slave_;
+    ClientStats* const stats_;
+};
+
+/// Counts writes to the socket into ClientStats.
+class StatsOutput : public OutputStream {
+public:
+    StatsOutput(std::unique_ptr<OutputStream> slave, ClientStats* stats)
+        : slave_(std::move(slave))
+        , stats_(stats)
+    { }
+
+protected:
+    size_t DoWrite(const void* data, size_t len) override {
+        ScopedTimer timer(&stats_->network_send_ns);
+        ++stats_->send_calls;
+        const size_t ret = slave_->Write(data, len);
+        stats_->bytes_sent += ret;
+        return ret;
+    }
+
+    void DoFlush() override {
+        // Flush may wait for completion of zero-copy sends.
+        ScopedTimer timer(&stats_->network_send_ns);
+        slave_->Flush();
+    }
+
+    void DoRetain(std::shared_ptr<const void> owner) override {
+        slave_->Retain(std::move(owner));
+    }
+
+private:
+    std::unique_ptr<OutputStream> slave_;
+    ClientStats* const stats_;
+};
+
 } // anonymous namespace
 
 class Client::Impl {
@@ -201,14 +300,23 @@ public:
     void BeginExecuteQuery(const Query& query, bool finalize = true);
     
     // Note, next block returns the block, but also notifies `query.OnData()` if it is set.
-    std::optional<Block> NextBlock();
+    // Totals and extremes are returned only if `kind` is set.
+    std::optional<Block> NextBlock(BlockKind* kind = nullptr);
 
     void SelectWithExternalData(Query query, const ExternalTables& external_tables);
 
+    /// Executes query through ClientOptions::result_cache.
+    void ExecuteCachedQuery(Query query);
+
+    /// Key of the query in ClientOptions::result_cache, which includes the server the client is connected to.
+    std::string MakeResultCacheKey(const Query& query) const;
+
     void SendCancel();
 
     void Cancel();
 
+    void Interrupt();
+
     bool IsSelecting() const { return state_ == State::Selecting; }
 
     void Insert(const std::string& table_name, const std::string& query_id, const Block& block);
@@ -231,13 +339,28 @@ public:
 
     const std::optional<Endpoint>& GetCurrentEndpoint() const;
 
+    const ClientStats& GetStats() const { return stats_; }
+
 private:
     bool Handshake();
 
+    /// Connection attempts to the endpoints are raced, see ClientOptions::connection_attempt_delay.
+    inline bool RaceEndpoints() const
+    {
+        return options_.connection_attempt_delay.count() > 0 && options_.endpoints.size() > 1;
+    }
+
+    /// Connects to the first endpoint which accepts TCP connection and completes the handshake.
+    void ResetConnectionRacing();
+
     DecodedPacket ReceivePacket(uint64_t* server_packet = nullptr);
     bool ProcessPacket(uint64_t* server_packet = nullptr);
     void ResetState();
 
+    /// Report requests to the current endpoint to EndpointsStats.
+    void StartRequest();
+    void FinishRequest(bool success);
+
     void SendQuery(const Query& query, bool finalize = true);
     void FinalizeQuery();
 
@@ -255,6 +378,9 @@ private:
     /// Reads data packet form input stream.
     bool ReceiveData(Block & block);
 
+    /// Reads block of data, totals or extremes packet, which may be compressed.
+    bool ReceiveBlock(Block & block);
+
     /// Reads exception packet form input stream.
     bool ReceiveException(bool rethrow = false, ServerError * error = nullptr);
 
@@ -311,6 +437,7 @@ private:
     int compression_ = CompressionState::Disable;
 
     std::unique_ptr<SocketFactory> socket_factory_;
+    std::shared_ptr<EndpointsStats> endpoints_stats_;
 
     std::unique_ptr<InputStream> input_;
     std::unique_ptr<OutputStream> output_;
@@ -318,6 +445,19 @@ private:
     std::unique_ptr<EndpointsIteratorBase> endpoints_iterator;
 
     std::optional<Endpoint> current_endpoint_;
+    /// Blocks of the query result being collected for ClientOptions::result_cache.
+    std::optional<std::vector<Block>> result_blocks_;
+    size_t result_bytes_ = 0;
+    /// Start time of the request to current endpoint in progress, see EndpointsStats.
+    std::optional<std::chrono::steady_clock::time_point> request_started_;
+    /// stats_.callbacks_ns on the start of the request, time spent in callbacks isn't counted as latency.
+    uint64_t request_callbacks_ns_ = 0;
+    /// The server reported an exception for the request in progress.
+    bool request_failed_ = false;
+
+    ClientStats stats_;
+    /// Value of stats_ on the start of the current query.
+    ClientStats query_start_stats_;
 
     ServerInfo server_info_;
 
@@ -342,7 +482,8 @@ Client::Impl::Impl(const ClientOptions& opts,
     : options_(modifyClientOptions(opts))
     , events_(nullptr)
     , socket_factory_(std::move(socket_factory))
-    , endpoints_iterator(GetEndpointsIterator(options_))
+    , endpoints_stats_(options_.endpoints_stats ? options_.endpoints_stats : std::make_shared<EndpointsStats>())
+    , endpoints_iterator(GetEndpointsIterator(options_, endpoints_stats_))
 {
     CreateConnection();
 
@@ -358,6 +499,7 @@ Client::Impl::~Impl() {
         }
     } catch (...) {
     }
+    FinishRequest(false);
 }
 
 void Client::Impl::BeginExecuteQuery(const Query& query, bool finalize) {
@@ -376,13 +518,18 @@ void Client::Impl::BeginExecuteQuery(const Query& query, bool finalize) {
     try {
         SendQuery(query_, finalize);
     }
+    catch (const std::system_error&) {
+        FinishRequest(false);
+        ResetState();
+        throw;
+    }
     catch (...) {
         ResetState();
         throw;
     }
 }
 
-std::optional<Block> Client::Impl::NextBlock() {
+std::optional<Block> Client::Impl::NextBlock(BlockKind* kind) {
     if (state_ != State::Selecting) {
         throw ValidationError("cannot execute NextBlock while not selecting");
     }
@@ -396,8 +543,23 @@ std::optional<Block> Client::Impl::NextBlock() {
                 if (block.GetColumnCount() == 0) {
                     continue;
                 }
+                if (kind) {
+                    *kind = BlockKind::Data;
+                }
                 return {std::move(block)};
             }
+            case VariantIndex<Totals, decltype(packet)>():
+                if (!kind) {
+                    continue;
+                }
+                *kind = BlockKind::Totals;
+                return {std::move(std::get<Totals>(packet).block)};
+            case VariantIndex<Extremes, decltype(packet)>():
+                if (!kind) {
+                    continue;
+                }
+                *kind = BlockKind::Extremes;
+                return {std::move(std::get<Extremes>(packet).block)};
             case VariantIndex<ServerError, decltype(packet)>():
             case VariantIndex<std::monostate, decltype(packet)>():
             case VariantIndex<EndOfStream, decltype(packet)>():
@@ -408,6 +570,11 @@ std::optional<Block> Client::Impl::NextBlock() {
             }
         }
     }
+    catch (const std::system_error&) {
+        FinishRequest(false);
+        ResetState();
+        throw;
+    }
     catch (...) {
         ResetState();
         throw;
@@ -415,12 +582,66 @@ std::optional<Block> Client::Impl::NextBlock() {
 }
 
 void Client::Impl::ExecuteQuery(Query query) {
+    if (options_.result_cache && QueryResultCache::IsCacheable(query)) {
+        ExecuteCachedQuery(std::move(query));
+        return;
+    }
+
     BeginExecuteQuery(query);
     while (NextBlock().has_value()) {
         ;
     }
 }
 
+void Client::Impl::ExecuteCachedQuery(Query query) {
+    if (state_ != State::Idle) {
+        throw ValidationError("cannot execute query while executing another operation");
+    }
+
+    if (auto blocks = options_.result_cache->Get(MakeResultCacheKey(query))) {
+        // Replay the result the same way ReceiveData() delivers it.
+        QueryEvents& events = query;
+        events.OnStart();
+        for (const auto& block : *blocks) {
+            events.OnData(block);
+            if (!events.OnDataCancelable(block)) {
+                break;
+            }
+        }
+        // Nothing was done by the client for the query.
+        events.OnFinishWithStats(ClientStats{});
+        return;
+    }
+
+    BeginExecuteQuery(query);
+    result_blocks_.emplace();
+    result_bytes_ = 0;
+    try {
+        while (NextBlock().has_value()) {
+            ;
+        }
+    } catch (...) {
+        result_blocks_.reset();
+        throw;
+    }
+
+    // Not set if the query was cancelled or failed. The key is made again, since the client
+    // might have reconnected to another endpoint to execute the query.
+    if (result_blocks_) {
+        options_.result_cache->Put(MakeResultCacheKey(query), std::move(*result_blocks_));
+        result_blocks_.reset();
+    }
+}
+
+std::string Client::Impl::MakeResultCacheKey(const Query& query) const {
+    std::string server;
+    if (current_endpoint_) {
+        server = current_endpoint_->host + ":" + std::to_string(current_endpoint_->port);
+    }
+    server += "/" + server_info_.display_name;
+
+    return QueryResultCache::MakeKey(query, server, options_.default_database, options_.user);
+}
 
 void Client::Impl::SelectWithExternalData(Query query, const ExternalTables& external_tables) {
     if (server_info_.revision < DBMS_MIN_REVISION_WITH_TEMPORARY_TABLES) {
@@ -432,6 +653,11 @@ void Client::Impl::SelectWithExternalData(Query query, const ExternalTables& ext
         SendExternalData(external_tables);
         FinalizeQuery();
     }
+    catch (const std::system_error&) {
+        FinishRequest(false);
+        ResetState();
+        throw;
+    }
     catch (...) {
         ResetState();
         throw;
@@ -444,7 +670,8 @@ void Client::Impl::SelectWithExternalData(Query query, const ExternalTables& ext
 
 void Client::Impl::SendBlockData(const Block& block) {
     if (compression_ == CompressionState::Enable) {
-        std::unique_ptr<OutputStream> compressed_output = std::make_unique<CompressedOutput>(output_.get(), options_.max_compression_chunk_size, options_.compression_method);
+        std::unique_ptr<OutputStream> compressed_output = std::make_unique<CompressedOutput>(
+            output_.get(), options_.max_compression_chunk_size, options_.compression_method, &stats_);
         BufferedOutput buffered(std::move(compressed_output), options_.max_compression_chunk_size);
 
         WriteBlock(block, buffered);
@@ -591,6 +818,7 @@ void Client::Impl::EndInsert() {
                             + (eos_packet ? std::to_string(eos_packet) : "nothing") + ")");
     }
     state_ = State::Idle;
+    FinishRequest(true);
 }
 
 void Client::Impl::Ping() {
@@ -610,15 +838,62 @@ void Client::Impl::Ping() {
 }
 
 void Client::Impl::ResetConnection() {
-    InitializeStreams(socket_factory_->connect(options_, current_endpoint_.value()));
-    state_ = State::Idle;
+    FinishRequest(false);
+
+    try {
+        InitializeStreams(socket_factory_->connect(options_, current_endpoint_.value()));
+        state_ = State::Idle;
+
+        if (!Handshake()) {
+            throw ProtocolError("fail to connect to " + options_.host);
+        }
+    } catch (const std::system_error&) {
+        endpoints_stats_->OnConnect(*current_endpoint_, false);
+        throw;
+    }
+    endpoints_stats_->OnConnect(*current_endpoint_, true);
+    endpoints_iterator->OnConnected(*current_endpoint_);
+}
+
+void Client::Impl::ResetConnectionRacing() {
+    std::vector<Endpoint> endpoints;
+    for (size_t i = 0; i < options_.endpoints.size(); ++i) {
+        endpoints.push_back(endpoints_iterator->Next());
+    }
 
-    if (!Handshake()) {
-        throw ProtocolError("fail to connect to " + options_.host);
+    FinishRequest(false);
+    current_endpoint_.reset();
+    while (true) {
+        size_t index = 0;
+        InitializeStreams(socket_factory_->connectAny(options_, endpoints, &index));
+        current_endpoint_ = endpoints[index];
+        state_ = State::Idle;
+
+        try {
+            if (!Handshake()) {
+                throw ProtocolError("fail to connect to " + current_endpoint_->host);
+            }
+            endpoints_stats_->OnConnect(*current_endpoint_, true);
+            endpoints_iterator->OnConnected(*current_endpoint_);
+            return;
+        } catch (const std::system_error&) {
+            endpoints_stats_->OnConnect(*current_endpoint_, false);
+            // Handshake failed, race the rest of endpoints.
+            endpoints.erase(endpoints.begin() + index);
+            if (endpoints.empty()) {
+                current_endpoint_.reset();
+                throw;
+            }
+        }
     }
 }
 
 void Client::Impl::ResetConnectionEndpoint() {
+    if (RaceEndpoints()) {
+        ResetConnectionRacing();
+        return;
+    }
+
     current_endpoint_.reset();
     for (size_t i = 0; i < options_.endpoints.size();)
     {
@@ -689,6 +964,9 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
     if (server_packet) {
         *server_packet = packet_type;
     }
+    if (packet_type < stats_.packets_received.size()) {
+        ++stats_.packets_received[packet_type];
+    }
 
     switch (packet_type) {
     case ServerCodes::Data: {
@@ -699,6 +977,30 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
         return ret;
     }
 
+    case ServerCodes::Totals:
+    case ServerCodes::Extremes: {
+        Block block;
+        if (!ReceiveBlock(block)) {
+            throw ProtocolError("can't read totals or extremes packet from input stream");
+        }
+        // Cached results are replayed as data blocks only.
+        result_blocks_.reset();
+
+        if (packet_type == ServerCodes::Totals) {
+            if (events_) {
+                ScopedTimer timer(&stats_.callbacks_ns);
+                events_->OnTotals(block);
+            }
+            return Totals{std::move(block)};
+        }
+
+        if (events_) {
+            ScopedTimer timer(&stats_.callbacks_ns);
+            events_->OnExtremes(block);
+        }
+        return Extremes{std::move(block)};
+    }
+
     case ServerCodes::Exception: {
         ServerError ret{std::make_shared<Exception>()};
         if (!ReceiveException(false, &ret)) {
@@ -730,6 +1032,7 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
         }
 
         if (events_) {
+            ScopedTimer timer(&stats_.callbacks_ns);
             events_->OnProfile(ret);
         }
 
@@ -750,6 +1053,11 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
                 return {};
             }
         }
+        if (server_info_.revision >= DBMS_MIN_PROTOCOL_VERSION_WITH_TOTAL_BYTES_IN_PROGRESS) {
+            if (!WireFormat::ReadUInt64(*input_, &ret.total_bytes)) {
+                return {};
+            }
+        }
         if (server_info_.revision >= DBMS_MIN_REVISION_WITH_CLIENT_WRITE_INFO)
         {
             if (!WireFormat::ReadUInt64(*input_, &ret.written_rows)) {
@@ -759,8 +1067,14 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
                 return {};
             }
         }
+        if (server_info_.revision >= DBMS_MIN_PROTOCOL_VERSION_WITH_SERVER_QUERY_TIME_IN_PROGRESS) {
+            if (!WireFormat::ReadUInt64(*input_, &ret.elapsed_ns)) {
+                return {};
+            }
+        }
 
         if (events_) {
+            ScopedTimer timer(&stats_.callbacks_ns);
             events_->OnProgress(ret);
         }
 
@@ -777,7 +1091,8 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
 
     case ServerCodes::EndOfStream: {
         if (events_) {
-            events_->OnFinish();
+            ScopedTimer timer(&stats_.callbacks_ns);
+            events_->OnFinishWithStats(stats_ - query_start_stats_);
         }
         return EndOfStream{};
     }
@@ -795,6 +1110,7 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
         }
 
         if (events_) {
+            ScopedTimer timer(&stats_.callbacks_ns);
             events_->OnServerLog(ret.block);
         }
         return ret;
@@ -824,6 +1140,7 @@ DecodedPacket Client::Impl::ReceivePacket(uint64_t* server_packet) {
         }
 
         if (events_) {
+            ScopedTimer timer(&stats_.callbacks_ns);
             events_->OnProfileEvents(ret.block);
         }
         return ret;
@@ -849,6 +1166,7 @@ bool Client::Impl::ProcessPacket(uint64_t* server_packet) {
 
 void Client::Impl::ResetState()
 {
+    FinishRequest(true);
     state_ = State::Idle;
     query_ = {};
     events_ = nullptr;
@@ -892,6 +1210,11 @@ bool Client::Impl::ReadBlock(InputStream& input, Block* block) {
 
     CreateColumnByTypeSettings create_column_settings;
     create_column_settings.low_cardinality_as_wrapped_column = options_.backward_compatibility_lowcardinality_as_wrapped_column;
+    if (options_.block_arena_chunk_size && num_rows) {
+        auto arena = std::make_shared<ArenaMemoryResource>(options_.block_arena_chunk_size);
+        create_column_settings.memory_resource = arena;
+        block->SetArena(std::move(arena));
+    }
 
     for (size_t i = 0; i < num_columns; ++i) {
         std::string name;
@@ -914,9 +1237,13 @@ bool Client::Impl::ReadBlock(InputStream& input, Block* block) {
         }
 
         if (ColumnRef col = CreateColumnByType(type, create_column_settings)) {
+            // Network and decompression time spent inside of Load() is accounted separately.
+            const uint64_t nested_ns = stats_.network_receive_ns + stats_.decompression_ns;
+            const Stopwatch watch;
             if (num_rows && !col->Load(&input, num_rows)) {
                 throw ProtocolError("can't load column '" + name + "' of type " + type);
             }
+            stats_.column_load_ns += watch.ElapsedNanoseconds() - (stats_.network_receive_ns + stats_.decompression_ns - nested_ns);
 
             block->AppendColumn(name, col);
         } else {
@@ -927,8 +1254,7 @@ bool Client::Impl::ReadBlock(InputStream& input, Block* block) {
     return true;
 }
 
-bool Client::Impl::ReceiveData(Block & block) {
-
+bool Client::Impl::ReceiveBlock(Block & block) {
     if (server_info_.revision >= DBMS_MIN_REVISION_WITH_TEMPORARY_TABLES) {
         if (!WireFormat::SkipString(*input_)) {
             return false;
@@ -936,19 +1262,36 @@ bool Client::Impl::ReceiveData(Block & block) {
     }
 
     if (compression_ == CompressionState::Enable) {
-        CompressedInput compressed(input_.get());
-        if (!ReadBlock(compressed, &block)) {
-            return false;
-        }
-    } else {
-        if (!ReadBlock(*input_, &block)) {
-            return false;
+        CompressedInput compressed(input_.get(), &stats_);
+        return ReadBlock(compressed, &block);
+    }
+    return ReadBlock(*input_, &block);
+}
+
+bool Client::Impl::ReceiveData(Block & block) {
+    if (!ReceiveBlock(block)) {
+        return false;
+    }
+
+    if (result_blocks_) {
+        result_bytes_ += block.AllocatedBytes();
+        if (options_.max_buffered_result_bytes && result_bytes_ > options_.max_buffered_result_bytes) {
+            result_blocks_.reset();
+        } else {
+            // The callbacks below may modify columns of the block.
+            result_blocks_->push_back(QueryResultCache::CopyBlock(block));
         }
     }
 
     if (events_) {
-        events_->OnData(block);
-        if (!events_->OnDataCancelable(block)) {
+        bool cancel = false;
+        {
+            ScopedTimer timer(&stats_.callbacks_ns);
+            events_->OnData(block);
+            cancel = !events_->OnDataCancelable(block);
+        }
+        if (cancel) {
+            result_blocks_.reset();
             SendCancel();
         }
     }
@@ -967,6 +1310,9 @@ bool Client::Impl::ReceiveException(bool rethrow, ServerError * error) {
         && WireFormat::ReadString(*input_, &e->stack_trace)
         && WireFormat::ReadFixed(*input_, &has_nested);
 
+    result_blocks_.reset();
+    request_failed_ = true;
+
     if (events_) {
         events_->OnServerException(*e);
     }
@@ -996,7 +1342,42 @@ void Client::Impl::Cancel() {
     }
 }
 
+void Client::Impl::Interrupt() {
+    if (socket_) {
+        socket_->Shutdown();
+    }
+}
+
+void Client::Impl::StartRequest() {
+    // Request may be left unfinished if an exception is thrown in the middle of insert.
+    FinishRequest(false);
+
+    if (current_endpoint_) {
+        endpoints_stats_->OnRequestStart(*current_endpoint_);
+        request_started_ = std::chrono::steady_clock::now();
+        request_callbacks_ns_ = stats_.callbacks_ns;
+        request_failed_ = false;
+    }
+}
+
+void Client::Impl::FinishRequest(bool success) {
+    if (request_started_ && current_endpoint_) {
+        const auto callbacks = std::chrono::nanoseconds(stats_.callbacks_ns - request_callbacks_ns_);
+        const auto latency = std::chrono::steady_clock::now() - *request_started_ - callbacks;
+        endpoints_stats_->OnRequestFinish(*current_endpoint_, latency, success && !request_failed_);
+    }
+    request_started_.reset();
+}
+
 void Client::Impl::SendQuery(const Query& query, bool finalize) {
+    if (events_) {
+        ScopedTimer timer(&stats_.callbacks_ns);
+        events_->OnStart();
+    }
+    StartRequest();
+    query_start_stats_ = stats_;
+    ++stats_.queries;
+
     WireFormat::WriteUInt64(*output_, ClientCodes::Query);
     WireFormat::WriteString(*output_, query.GetQueryID());
 
@@ -1155,12 +1536,28 @@ void Client::Impl::SendData(const Block& block) {
     }
     SendBlockData(block);
 
+    // Column bodies may be sent with zero copy: the socket keeps the columns alive until kernel
+    // releases their pages, even if the caller drops the block before that.
+    for (Block::Iterator bi(block); bi.IsValid(); bi.Next()) {
+        output_->Retain(bi.Column());
+    }
+
+    // With zero-copy send this also waits until kernel releases column buffers of the block.
     output_->Flush();
 }
 
 void Client::Impl::InitializeStreams(std::unique_ptr<SocketBase>&& socket) {
-    std::unique_ptr<OutputStream> output = std::make_unique<BufferedOutput>(socket->makeOutputStream());
-    std::unique_ptr<InputStream> input = std::make_unique<BufferedInput>(socket->makeInputStream());
+    std::unique_ptr<OutputStream> output = socket->makeOutputStream();
+    std::unique_ptr<InputStream> input = socket->makeInputStream();
+
+    // Streams which are already buffered (e.g. backed by io_uring registered buffers) are used as is.
+    if (!dynamic_cast<ZeroCopyOutput*>(output.get())) {
+        output = std::make_unique<BufferedOutput>(std::make_unique<StatsOutput>(std::move(output), &stats_));
+    }
+    if (!dynamic_cast<ZeroCopyInput*>(input.get())) {
+        input = std::make_unique<BufferedInput>(std::make_unique<StatsInput>(std::move(input), &stats_),
+            options_.input_buffer_size, options_.max_input_buffer_size);
+    }
 
     std::swap(input, input_);
     std::swap(output, output_);
@@ -1188,6 +1585,9 @@ bool Client::Impl::ReceiveHello() {
     if (!WireFormat::ReadVarint64(*input_, &packet_type)) {
         return false;
     }
+    if (packet_type < stats_.packets_received.size()) {
+        ++stats_.packets_received[packet_type];
+    }
 
     if (packet_type == ServerCodes::Hello) {
         if (!WireFormat::ReadString(*input_, &server_info_.name)) {
@@ -1221,6 +1621,28 @@ bool Client::Impl::ReceiveHello() {
             }
         }
 
+        // Password complexity rules are only used by interactive clients on password change.
+        if (server_info_.revision >= DBMS_MIN_PROTOCOL_VERSION_WITH_PASSWORD_COMPLEXITY_RULES) {
+            uint64_t rules = 0;
+            if (!WireFormat::ReadUInt64(*input_, &rules)) {
+                return false;
+            }
+            for (uint64_t i = 0; i < rules; ++i) {
+                // Pattern and exception message.
+                if (!WireFormat::SkipString(*input_) || !WireFormat::SkipString(*input_)) {
+                    return false;
+                }
+            }
+        }
+
+        // Nonce is only used by servers to authenticate each other with the interserver secret.
+        if (server_info_.revision >= DBMS_MIN_REVISION_WITH_INTERSERVER_SECRET_V2) {
+            uint64_t nonce = 0;
+            if (!WireFormat::ReadFixed(*input_, &nonce)) {
+                return false;
+            }
+        }
+
         return true;
     } else if (packet_type == ServerCodes::Exception) {
         ReceiveException(true);
@@ -1256,6 +1678,21 @@ void Client::Impl::RetryGuard(std::function<void()> func) {
     }
     // Connections with current_endpoint_ are broken.
     // Trying to establish  with the another one from the list.
+    if (RaceEndpoints()) {
+        for (size_t i = 0; ; ++i) {
+            try {
+                socket_factory_->sleepFor(options_.retry_timeout);
+                ResetConnectionRacing();
+                func();
+                return;
+            } catch (const std::system_error&) {
+                if (i + 1 >= options_.send_retries) {
+                    throw;
+                }
+            }
+        }
+    }
+
     size_t connection_attempts_count = GetConnectionAttempts();
     for (size_t i = 0; i < connection_attempts_count;)
     {
@@ -1365,11 +1802,20 @@ std::optional<Block> Client::NextBlock() {
     return impl_->NextBlock();
 }
 
+std::optional<Block> Client::NextBlock(BlockKind& kind) {
+    return impl_->NextBlock(&kind);
+}
+
 void Client::Cancel()
 {
     impl_->Cancel();
 }
 
+void Client::Interrupt()
+{
+    impl_->Interrupt();
+}
+
 bool Client::IsSelecting() const
 {
     return impl_->IsSelecting();
@@ -1423,6 +1869,10 @@ const ServerInfo& Client::GetServerInfo() const {
     return impl_->GetServerInfo();
 }
 
+const ClientStats& Client::GetStats() const {
+    return impl_->GetStats();
+}
+
 Client::Version Client::GetVersion() {
     return Version {
         CLICKHOUSE_CPP_VERSION_MAJOR,
@@ -33,6 +33,11 @@ typedef struct ssl_ctx_st SSL_CTX;
 
 namespace clickhouse {
 
+class AddressResolver;
+class EndpointsStats;
+class QueryResultCache;
+class SSLSessionCache;
+
 struct ServerInfo {
     std::string name;
     std::string timezone;
@@ -60,6 +65,12 @@ struct Endpoint {
 
 enum class EndpointsIterationAlgorithm {
     RoundRobin = 0,
+    /// Endpoint with the least number of requests in progress, makes sense with shared ClientOptions::endpoints_stats.
+    LeastOutstanding = 1,
+    /// The better of two random endpoints by latency (EWMA) and number of requests in progress.
+    PowerOfTwoChoices = 2,
+    /// The first healthy endpoint in the order of ClientOptions::endpoints.
+    InOrder = 3,
 };
 
 struct ClientOptions {
@@ -115,13 +126,76 @@ struct ClientOptions {
     // TCP options
     DECLARE_FIELD(tcp_nodelay, bool, TcpNoDelay, true);
 
+    /** Algorithm of choosing endpoint to connect (or reconnect) to.
+     *
+     *  All the algorithms but RoundRobin skip endpoints which failed `EndpointsStatsParams::max_failures`
+     *  times in a row, for `EndpointsStatsParams::ejection_time`.
+     */
+    DECLARE_FIELD(endpoints_iteration_algorithm, EndpointsIterationAlgorithm, SetEndpointsIterationAlgorithm, EndpointsIterationAlgorithm::RoundRobin);
+
+    /// Load, latency and health of the endpoints measured by the client, share it between clients
+    /// (e.g. in a connection pool) to balance them together. If null, each client has its own.
+    DECLARE_FIELD(endpoints_stats, std::shared_ptr<EndpointsStats>, SetEndpointsStats, nullptr);
+
     /// Connection socket connect timeout. If the timeout is negative then the connect operation will never timeout.
     DECLARE_FIELD(connection_connect_timeout, std::chrono::milliseconds, SetConnectionConnectTimeout, std::chrono::seconds(5));
 
+    /** Delay between starting connection attempts to the next address ("happy eyeballs", RFC 8305).
+     *
+     *  If not zero, connection attempts to all resolved addresses of the endpoint and, when connecting to
+     *  any of `endpoints`, to all endpoints are raced: next attempt starts if the previous one hasn't
+     *  completed within this delay (or immediately if it failed), the first established connection is used
+     *  and the rest are cancelled. Otherwise addresses and endpoints are tried one by one,
+     *  each up to `connection_connect_timeout`. Recommended value is 250ms.
+     */
+    DECLARE_FIELD(connection_attempt_delay, std::chrono::milliseconds, SetConnectionAttemptDelay, std::chrono::milliseconds(0));
+
+    /** Resolves host names of the endpoints, null means resolving with getaddrinfo() on every connect.
+     *
+     *  Use CachingResolver (e.g. process-wide CachingResolver::Shared()) to avoid blocking
+     *  on DNS when connecting or reconnecting. Custom SocketFactory gets it through its own constructor.
+     */
+    DECLARE_FIELD(resolver, std::shared_ptr<AddressResolver>, SetResolver, nullptr);
+
     /// Connection socket timeout. If the timeout is set to zero then the operation will never timeout.
     DECLARE_FIELD(connection_recv_timeout, std::chrono::milliseconds, SetConnectionRecvTimeout, std::chrono::milliseconds(0));
     DECLARE_FIELD(connection_send_timeout, std::chrono::milliseconds, SetConnectionSendTimeout, std::chrono::milliseconds(0));
 
+    /** Send large chunks of data (e.g. uncompressed column bodies on INSERT) with MSG_ZEROCOPY,
+     *  avoiding copy of the data into kernel socket buffers.
+     *
+     *  Linux-only and ignored for SSL connections or if not supported by the kernel.
+     *  Pays off only for big uncompressed INSERTs over fast network: pages of the column buffers are pinned
+     *  until the peer acknowledges the data, so Insert()/SendInsertBlock() return only after kernel
+     *  released all of them, and the block may be modified or destroyed right after that.
+     */
+    DECLARE_FIELD(zero_copy_send, bool, SetZeroCopySend, false);
+
+    /** Size of the buffer for data received from the server.
+     *
+     *  The buffer starts with `input_buffer_size` bytes and doubles, up to `max_input_buffer_size`,
+     *  while reads from the socket keep filling it up, e.g. when a big result is being received,
+     *  so fewer recv() calls are made. It shrinks back when reads return only a small portion of it.
+     *  Set `max_input_buffer_size` to zero to have a buffer of fixed size.
+     */
+    DECLARE_FIELD(input_buffer_size, size_t, SetInputBufferSize, 8192);
+    DECLARE_FIELD(max_input_buffer_size, size_t, SetMaxInputBufferSize, 1024 * 1024);
+
+    /** Sizes of the kernel socket buffers (SO_RCVBUF and SO_SNDBUF), zero keeps system defaults.
+     *
+     *  Note that on Linux setting buffer size explicitly disables its autotuning.
+     */
+    DECLARE_FIELD(socket_recv_buffer_size, int, SetSocketRecvBufferSize, 0);
+    DECLARE_FIELD(socket_send_buffer_size, int, SetSocketSendBufferSize, 0);
+
+    /** If non-zero, variable-length data of all the columns of each received block is allocated from
+     *  an ArenaMemoryResource with chunks of this size, instead of many separate heap allocations.
+     *  The arena is released in one shot once the block and its columns are destroyed, see Block::GetArena().
+     *
+     *  Note that the arena never reuses memory, so blocks which are cleared and refilled keep growing it.
+     */
+    DECLARE_FIELD(block_arena_chunk_size, size_t, SetBlockArenaChunkSize, 0);
+
     /** It helps to ease migration of the old codebases, which can't afford to switch
     * to using ColumnLowCardinalityT or ColumnLowCardinality directly,
     * but still want to benefit from smaller on-wire LowCardinality bandwidth footprint.
@@ -131,6 +205,23 @@ struct ClientOptions {
     [[deprecated("Makes implementation of LC(X) harder and code uglier. Will be removed in next major release (3.0) ")]]
     DECLARE_FIELD(backward_compatibility_lowcardinality_as_wrapped_column, bool, SetBakcwardCompatibilityFeatureLowCardinalityAsWrappedColumn, false);
 
+    /** Cache of SELECT results, if set, Select() and Execute() of SELECT queries return results
+     *  cached by QueryResultCache instead of sending the query to the server again.
+     *
+     *  Only data is cached, other query callbacks (progress, profile, logs) are not called for cached results.
+     *  Results of cancelled and failed queries are not cached. May be shared by several clients, results
+     *  are cached per server (endpoint and display name), so the clients may be connected to different servers.
+     */
+    DECLARE_FIELD(result_cache, std::shared_ptr<QueryResultCache>, SetResultCache, nullptr);
+
+    /** If non-zero, max size (Block::AllocatedBytes()) of result blocks the client keeps in addition to
+     *  the ones returned to the caller, i.e. the result of a query being stored to result_cache.
+     *  Once the result gets larger, the client stops buffering it and the result isn't cached.
+     *
+     *  For results read by several clients at once, see ShardedSelectParams::max_queued_bytes.
+     */
+    DECLARE_FIELD(max_buffered_result_bytes, size_t, SetMaxBufferedResultBytes, 0);
+
     /** Set max size data to compress if compression enabled.
      *
      *  Allows choosing tradeoff between RAM\CPU:
@@ -159,6 +250,20 @@ struct ClientOptions {
             return *this;
         }
 
+        /** Cache of TLS sessions, which allows to resume session on reconnect instead of doing full handshake.
+         *  If null, each Client has its own cache, so only its reconnects benefit from it.
+         *  May be shared by multiple Clients (e.g. a pool of connections to the same cluster),
+         *  but only by those with the same SSL options.
+         */
+        std::shared_ptr<SSLSessionCache> session_cache = nullptr;
+        auto & SetSessionCache(std::shared_ptr<SSLSessionCache> new_session_cache) {
+            session_cache = std::move(new_session_cache);
+            return *this;
+        }
+
+        /// Resume TLS sessions using `session_cache`.
+        DECLARE_FIELD(use_session_cache, bool, SetUseSessionCache, true);
+
         /** Means to validate the server-supplied certificate against trusted Certificate Authority (CA).
          *  If no CAs are configured, the server's identity can't be validated, and the Client would err.
          *  See https://www.openssl.org/docs/man1.1.1/man3/SSL_CTX_set_default_verify_paths.html
@@ -202,6 +307,14 @@ struct ClientOptions {
          */
         DECLARE_FIELD(server_host_name, std::string, SetServerHostName, "");
 
+        /** Offload record encryption and decryption to the kernel (kTLS), set with SSL_OP_ENABLE_KTLS.
+         *
+         *  Requires OpenSSL 3.0+ built with kTLS support, Linux with `tls` kernel module and a cipher
+         *  supported by the kernel (e.g. AES-GCM). If any of those is missing, connection
+         *  silently falls back to regular user-space TLS.
+         */
+        DECLARE_FIELD(use_ktls, bool, SetUseKTLS, false);
+
         struct CommandAndValue {
             std::string command;
             std::optional<std::string> value = std::nullopt;
@@ -304,10 +417,19 @@ public:
     /// functions.
     std::optional<Block> NextBlock();
 
+    /// Same as NextBlock(), but also returns totals (WITH TOTALS) and extremes (extremes = 1) blocks,
+    /// `kind` tells which of them the block is.
+    std::optional<Block> NextBlock(BlockKind& kind);
+
     // EXPERIMENTAL. Cancels current execution of BeginSelect and drains all in-flight data.
     // Consecutive calls to NextBlock() after Cancel() will throw an exception.
     void Cancel();
 
+    /// Shuts the connection down, so that a call waiting for the server (e.g. NextBlock() of a slow query) fails.
+    /// Unlike other methods, may be called from another thread while a query is being executed.
+    /// The connection must be reset with ResetConnection() before the client is used again.
+    void Interrupt();
+
     // EXPERIMENTAL. Returns true if the client is still in data-receiving mode and more future
     // calls to NextBlock().
     bool IsSelecting() const;
@@ -342,6 +464,11 @@ public:
     /// In case when client is not connected to any endpoint, nullopt will returned.
     const std::optional<Endpoint>& GetCurrentEndpoint() const;
 
+    /// Counters of the work done by the client since its creation, not reset on reconnect.
+    /// Counters of each query are passed to its QueryEvents::OnFinishWithStats(), which calls the callback
+    /// set with Query::OnFinish().
+    const ClientStats& GetStats() const;
+
     // Try to connect to different endpoints one by one only one time. If it doesn't work, throw an exception.
     void ResetConnectionEndpoint();
 
@@ -60,20 +60,51 @@ ColumnRef ColumnArray::GetAsColumn(size_t n) const {
 }
 
 ColumnRef ColumnArray::Slice(size_t begin, size_t size) const {
+    return DoSlice(begin, size, false);
+}
+
+ColumnRef ColumnArray::SliceShared(size_t begin, size_t size) const {
+    return DoSlice(begin, size, true);
+}
+
+ColumnRef ColumnArray::DoSlice(size_t begin, size_t size, bool shared) const {
     if (size && begin + size > Size())
         throw ValidationError("Slice indexes are out of bounds");
 
-    auto sliced_data = data_->Slice(GetOffset(begin), GetOffset(begin + size) - GetOffset(begin));
+    // Offsets are rebased to the start of the slice of the nested values.
+    const auto base  = GetOffset(begin);
+    const auto len   = GetOffset(begin + size) - base;
+    auto sliced_data = shared ? data_->SliceShared(base, len) : data_->Slice(base, len);
     auto offsets     = std::make_shared<ColumnUInt64>();
-    auto offset      = uint64_t{0};
-    for (size_t i = 0; i < size; i++) {
-        offset += GetSize(begin + i);
-        offsets->Append(offset);
+    auto& offsets_data = offsets->GetWritableData();
+    offsets_data.reserve(size);
+    for (const auto offset : offsets_->RawData().subspan(begin, size)) {
+        offsets_data.push_back(offset - base);
     }
 
     return std::make_shared<ColumnArray>(std::move(sliced_data), std::move(offsets));
 }
 
+ColumnRef ColumnArray::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+
+    // Offsets are rewritten for the new sizes, nested values are gathered at once.
+    auto offsets = std::make_shared<ColumnUInt64>();
+    auto& offsets_data = offsets->GetWritableData();
+    offsets_data.reserve(indices.size());
+    std::vector<size_t> nested_indices;
+    for (const auto index : indices) {
+        const auto begin = GetOffset(index);
+        const auto end = begin + GetSize(index);
+        for (auto i = begin; i < end; ++i) {
+            nested_indices.push_back(i);
+        }
+        offsets_data.push_back(nested_indices.size());
+    }
+
+    return std::make_shared<ColumnArray>(data_->Gather(nested_indices), std::move(offsets));
+}
+
 ColumnRef ColumnArray::CloneEmpty() const {
     return std::make_shared<ColumnArray>(data_->CloneEmpty());
 }
@@ -136,6 +167,14 @@ size_t ColumnArray::Size() const {
     return offsets_->Size();
 }
 
+size_t ColumnArray::ByteSize() const {
+    return data_->ByteSize() + offsets_->ByteSize();
+}
+
+size_t ColumnArray::AllocatedBytes() const {
+    return data_->AllocatedBytes() + offsets_->AllocatedBytes();
+}
+
 void ColumnArray::Swap(Column& other) {
     auto & col = dynamic_cast<ColumnArray &>(other);
     // Swap sub-column CONTENTS in place (never rebind the shared_ptr slots), so the data and
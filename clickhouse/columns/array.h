@@ -70,8 +70,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t, size_t) const override;
+    ColumnRef SliceShared(size_t, size_t) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column&) override;
 
@@ -100,6 +106,10 @@ protected:
     void AddOffset(size_t n);
     void Reset();
 
+private:
+    /// Slice with nested values copied or shared, offsets are always copied.
+    ColumnRef DoSlice(size_t begin, size_t size, bool shared) const;
+
 private:
     ColumnRef data_;
     std::shared_ptr<ColumnUInt64> offsets_;
@@ -320,6 +330,14 @@ public:
         return Wrap(ColumnArray::Slice(begin, size));
     }
 
+    ColumnRef SliceShared(size_t begin, size_t size) const override {
+        return Wrap(ColumnArray::SliceShared(begin, size));
+    }
+
+    ColumnRef Gather(Span<const size_t> indices) const override {
+        return Wrap(ColumnArray::Gather(indices));
+    }
+
     ColumnRef CloneEmpty() const override {
         return Wrap(ColumnArray::CloneEmpty());
     }
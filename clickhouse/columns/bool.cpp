@@ -58,9 +58,30 @@ size_t ColumnBool::Size() const {
     return data_.Size();
 }
 
+size_t ColumnBool::ByteSize() const {
+    return data_.ByteSize();
+}
+
+size_t ColumnBool::AllocatedBytes() const {
+    return data_.AllocatedBytes();
+}
+
 ColumnRef ColumnBool::Slice(size_t begin, size_t len) const {
-    auto sliced = std::static_pointer_cast<ColumnUInt8>(data_.Slice(begin, len));
-    return std::make_shared<ColumnBool>(std::move(sliced->GetWritableData()));
+    auto result = std::make_shared<ColumnBool>();
+    result->data_.Swap(*data_.Slice(begin, len));
+    return result;
+}
+
+ColumnRef ColumnBool::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnBool>();
+    result->data_.Swap(*data_.SliceShared(begin, len));
+    return result;
+}
+
+ColumnRef ColumnBool::Gather(Span<const size_t> indices) const {
+    auto result = std::make_shared<ColumnBool>();
+    result->data_.Swap(*data_.Gather(indices));
+    return result;
 }
 
 ColumnRef ColumnBool::CloneEmpty() const {
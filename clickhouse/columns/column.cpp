@@ -1,7 +1,24 @@
 #include "column.h"
 
+#include "../base/output.h"
+
 namespace clickhouse {
 
+namespace {
+
+class CountingOutput : public OutputStream {
+public:
+    size_t bytes = 0;
+
+protected:
+    size_t DoWrite(const void* /*data*/, size_t len) override {
+        bytes += len;
+        return len;
+    }
+};
+
+}
+
 bool Column::LoadPrefix(InputStream*, size_t) {
     /// does nothing by default
     return true;
@@ -21,4 +38,76 @@ void Column::Save(OutputStream* output) {
     SaveBody(output);
 }
 
+ColumnRef Column::SliceShared(size_t begin, size_t len) const {
+    return Slice(begin, len);
+}
+
+ColumnRef Column::Filter(Span<const uint8_t> mask) const {
+    CheckFilterMask(mask);
+
+    std::vector<size_t> indices;
+    for (size_t i = 0; i < mask.size(); ++i) {
+        if (mask[i]) {
+            indices.push_back(i);
+        }
+    }
+    return Gather(indices);
+}
+
+ColumnRef Column::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+
+    auto result = CloneEmpty();
+    for (const auto index : indices) {
+        result->Append(Slice(index, 1));
+    }
+    return result;
+}
+
+ColumnRef Column::Permute(Span<const size_t> permutation) const {
+    if (permutation.size() != Size()) {
+        throw ValidationError("permutation of " + std::to_string(permutation.size())
+            + " rows doesn't match column of " + std::to_string(Size()) + " rows");
+    }
+
+    std::vector<bool> seen(permutation.size());
+    for (const auto index : permutation) {
+        if (index >= seen.size() || seen[index]) {
+            throw ValidationError("not a permutation, row " + std::to_string(index) + " is out of range or repeated");
+        }
+        seen[index] = true;
+    }
+
+    return Gather(permutation);
+}
+
+void Column::CheckFilterMask(Span<const uint8_t> mask) const {
+    if (mask.size() != Size()) {
+        throw ValidationError("filter mask of " + std::to_string(mask.size())
+            + " rows doesn't match column of " + std::to_string(Size()) + " rows");
+    }
+}
+
+void Column::CheckGatherIndices(Span<const size_t> indices) const {
+    if (indices.empty()) {
+        return;
+    }
+    const size_t max_index = *std::max_element(indices.begin(), indices.end());
+    if (max_index >= Size()) {
+        throw ValidationError("row " + std::to_string(max_index)
+            + " is out of range of column of " + std::to_string(Size()) + " rows");
+    }
+}
+
+size_t Column::ByteSize() const {
+    // Saving doesn't modify columns, it isn't const for historical reasons.
+    CountingOutput output;
+    const_cast<Column*>(this)->SaveBody(&output);
+    return output.bytes;
+}
+
+size_t Column::AllocatedBytes() const {
+    return ByteSize();
+}
+
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../base/span.h"
 #include "../types/types.h"
 #include "../columns/itemview.h"
 #include "../exceptions.h"
@@ -91,9 +92,37 @@ public:
     /// Returns count of rows in the column.
     virtual size_t Size() const = 0;
 
+    /// Bytes of the column values, as ClickHouse accounts them: fixed-size values, characters and 8-byte offsets
+    /// of strings and arrays, null maps, data of nested columns.
+    /// The default implementation serializes the column to count the bytes.
+    virtual size_t ByteSize() const;
+
+    /// Bytes of memory held by the column: capacity of buffers (including the reserved part), string storage,
+    /// LowCardinality hash maps, nested columns. Memory shared with other columns (shared slices, typed views) is counted
+    /// by each of them. The default implementation returns ByteSize().
+    virtual size_t AllocatedBytes() const;
+
     /// Makes slice of the current column.
     virtual ColumnRef Slice(size_t begin, size_t len) const = 0;
 
+    /// Makes slice of the current column, which shares values with it instead of copying them, until the column
+    /// or the slice is modified. Columns of numbers, strings and fixed strings (and columns made of them) support
+    /// sharing, the default implementation is Slice().
+    virtual ColumnRef SliceShared(size_t begin, size_t len) const;
+
+    /// Makes a column of the rows for which `mask` is non-zero, `mask` must have a byte per row.
+    /// The default implementation is Gather() of the selected rows.
+    virtual ColumnRef Filter(Span<const uint8_t> mask) const;
+
+    /// Makes a column of rows `indices[0]`, `indices[1]`, ..., indices may repeat.
+    /// Throws ValidationError if any of the indices is out of range.
+    /// The default implementation appends the rows one at a time, columns of all the built-in types override it.
+    virtual ColumnRef Gather(Span<const size_t> indices) const;
+
+    /// Makes a column of the same rows in different order: row `i` of the result is row `permutation[i]`.
+    /// Throws ValidationError if `permutation` isn't a permutation of [0, Size()).
+    ColumnRef Permute(Span<const size_t> permutation) const;
+
     virtual ColumnRef CloneEmpty() const = 0;
 
     virtual void Swap(Column&) = 0;
@@ -109,6 +138,10 @@ public:
     }
 
 protected:
+    /// Throw ValidationError if arguments of Filter() and Gather() don't match the column.
+    void CheckFilterMask(Span<const uint8_t> mask) const;
+    void CheckGatherIndices(Span<const size_t> indices) const;
+
     TypeRef type_;
 };
 
@@ -124,6 +157,31 @@ std::vector<T> SliceVector(const std::vector<T>& vec, size_t begin, size_t len)
     return result;
 }
 
+/// Values of `values` at `indices`, which must be checked by the caller.
+template <typename T>
+std::vector<T> GatherVector(Span<const T> values, Span<const size_t> indices) {
+    std::vector<T> result;
+    result.reserve(indices.size());
+    for (const auto index : indices) {
+        result.push_back(values[index]);
+    }
+    return result;
+}
+
+/// Values of `values` for which `mask` is non-zero.
+template <typename T>
+std::vector<T> FilterVector(Span<const T> values, Span<const uint8_t> mask) {
+    std::vector<T> result(values.size());
+    // Without branches: every value is written, but the position advances for selected ones only.
+    size_t size = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        result[size] = values[i];
+        size += mask[i] != 0;
+    }
+    result.resize(size);
+    return result;
+}
+
 template <typename T>
 struct HasWrapMethod {
 private:
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace clickhouse {
+
+/// Returns true if `ptr` is the only owner of the object, so the object can be modified in place.
+template <typename T>
+bool IsUniqueOwner(const std::shared_ptr<T>& ptr) {
+    if (ptr.use_count() != 1) {
+        return false;
+    }
+    // use_count() is a relaxed load: synchronize with release of the last other owner (e.g. a slice
+    // destroyed by another thread), so its reads of the object happen before it is modified.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+/** Values of a column, which may be shared with its slices (see Column::SliceShared()).
+ *
+ *  Slice() makes a view of a range of the values without copying them. Modification of shared values
+ *  (through Mutable()) copies them first, so the column and its slices never see changes of each other
+ *  (copy-on-write).
+ *
+ *  Container is std::vector or std::string.
+ */
+template <typename Container>
+class CowData {
+public:
+    using value_type = typename Container::value_type;
+    using const_iterator = const value_type*;
+
+    CowData()
+        : data_(std::make_shared<Container>())
+    {}
+
+    explicit CowData(Container data)
+        : data_(std::make_shared<Container>(std::move(data)))
+    {}
+
+    const value_type* data() const { return data_->data() + offset_; }
+    size_t size() const { return is_slice_ ? size_ : data_->size(); }
+    bool empty() const { return size() == 0; }
+    /// Capacity of the underlying container, which may be shared.
+    size_t capacity() const { return data_->capacity(); }
+
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+
+    const value_type& operator[](size_t n) const { return data()[n]; }
+
+    const value_type& at(size_t n) const {
+        if (n >= size()) {
+            throw std::out_of_range("index " + std::to_string(n) + " is out of range of column of size " + std::to_string(size()));
+        }
+        return data()[n];
+    }
+
+    /// Returns true if the values are not shared with other columns and are not a view of a part of a container.
+    bool IsUnique() const {
+        return !is_slice_ && IsUniqueOwner(data_);
+    }
+
+    /// Container for modification, the values are copied first if they are shared.
+    /// The reference must not be used after Slice(), which shares the container.
+    Container& Mutable() {
+        if (!IsUnique()) {
+            data_ = std::make_shared<Container>(begin(), end());
+            offset_ = 0;
+            size_ = 0;
+            is_slice_ = false;
+        }
+        return *data_;
+    }
+
+    /// Removes all the values, without copying them if they are shared.
+    void clear() {
+        if (IsUnique()) {
+            data_->clear();
+        } else {
+            *this = CowData();
+        }
+    }
+
+    /// Copy of values [begin, begin + len), `len` is clamped to the end of the values.
+    Container Copy(size_t begin, size_t len) const {
+        begin = std::min(begin, size());
+        return Container(data() + begin, data() + begin + std::min(len, size() - begin));
+    }
+
+    /// View of values [begin, begin + len), `len` is clamped to the end of the values.
+    CowData Slice(size_t begin, size_t len) const {
+        CowData result(*this);
+        begin = std::min(begin, size());
+        result.offset_ = offset_ + begin;
+        result.size_ = std::min(len, size() - begin);
+        result.is_slice_ = true;
+        return result;
+    }
+
+    void swap(CowData& other) noexcept {
+        data_.swap(other.data_);
+        std::swap(offset_, other.offset_);
+        std::swap(size_, other.size_);
+        std::swap(is_slice_, other.is_slice_);
+    }
+
+private:
+    std::shared_ptr<Container> data_;
+    /// Range of data_ the column consists of, if it is a slice.
+    size_t offset_ = 0;
+    size_t size_ = 0;
+    bool is_slice_ = false;
+};
+
+}
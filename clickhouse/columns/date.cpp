@@ -3,6 +3,64 @@
 
 namespace clickhouse {
 
+namespace {
+
+constexpr int64_t kSecondsInDay = 86400;
+
+template <typename T>
+void DaysToCivilTimes(Span<const T> days, std::vector<CivilTime>& out) {
+    out.resize(days.size());
+    for (size_t i = 0; i < days.size(); ++i) {
+        out[i] = CivilTimeFromUnix(static_cast<int64_t>(days[i]) * kSecondsInDay);
+    }
+}
+
+/// `max_length` is the maximum length of a formatted value.
+template <typename T>
+void DaysToStrings(Span<const T> days, size_t max_length, std::string& arena, std::vector<std::string_view>& out) {
+    arena.resize(days.size() * max_length);
+    out.resize(days.size());
+
+    char* it = &arena[0];
+    for (size_t i = 0; i < days.size(); ++i) {
+        const size_t len = FormatDate(CivilTimeFromUnix(static_cast<int64_t>(days[i]) * kSecondsInDay), it);
+        out[i] = std::string_view(it, len);
+        it += len;
+    }
+}
+
+/// Splits DateTime64 values into seconds and nanoseconds.
+class DateTime64Splitter {
+public:
+    /// Precision is at most 9, as ClickHouse allows.
+    explicit DateTime64Splitter(size_t precision) {
+        for (size_t i = 0; i < precision; ++i) {
+            ticks_per_second_ *= 10;
+        }
+        for (size_t i = precision; i < 9; ++i) {
+            nanoseconds_per_tick_ *= 10;
+        }
+    }
+
+    /// Returns seconds, the sub-second part is rounded down, so it is never negative.
+    int64_t Split(int64_t value, uint32_t& nanosecond) const {
+        int64_t seconds = value / ticks_per_second_;
+        int64_t ticks = value % ticks_per_second_;
+        if (ticks < 0) {
+            --seconds;
+            ticks += ticks_per_second_;
+        }
+        nanosecond = static_cast<uint32_t>(ticks * nanoseconds_per_tick_);
+        return seconds;
+    }
+
+private:
+    int64_t ticks_per_second_ = 1;
+    int64_t nanoseconds_per_tick_ = 1;
+};
+
+}
+
 ColumnDate::ColumnDate()
     : Column(Type::CreateDate())
     , data_(std::make_shared<ColumnUInt16>())
@@ -67,11 +125,31 @@ size_t ColumnDate::Size() const {
     return data_->Size();
 }
 
+size_t ColumnDate::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnDate::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnDate::Slice(size_t begin, size_t len) const {
-    auto col = data_->Slice(begin, len)->As<ColumnUInt16>();
     auto result = std::make_shared<ColumnDate>();
+    result->data_->Swap(*data_->Slice(begin, len));
+
+    return result;
+}
+
+ColumnRef ColumnDate::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnDate>();
+    result->data_->Swap(*data_->SliceShared(begin, len));
+
+    return result;
+}
 
-    result->data_->Append(col);
+ColumnRef ColumnDate::Gather(Span<const size_t> indices) const {
+    auto result = std::make_shared<ColumnDate>();
+    result->data_->Swap(*data_->Gather(indices));
 
     return result;
 }
@@ -89,6 +167,15 @@ ItemView ColumnDate::GetItem(size_t index) const {
     return ItemView(Type::Date, data_->GetItem(index));
 }
 
+void ColumnDate::ToCivilTimes(std::vector<CivilTime>& out) const {
+    DaysToCivilTimes(RawData(), out);
+}
+
+void ColumnDate::ToStrings(std::string& arena, std::vector<std::string_view>& out) const {
+    // Dates up to 2149-06-06.
+    DaysToStrings(RawData(), 10, arena, out);
+}
+
 
 ColumnDate32::ColumnDate32()
     : Column(Type::CreateDate32())
@@ -154,11 +241,31 @@ size_t ColumnDate32::Size() const {
     return data_->Size();
 }
 
+size_t ColumnDate32::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnDate32::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnDate32::Slice(size_t begin, size_t len) const {
-    auto col = data_->Slice(begin, len)->As<ColumnInt32>();
     auto result = std::make_shared<ColumnDate32>();
+    result->data_->Swap(*data_->Slice(begin, len));
+
+    return result;
+}
+
+ColumnRef ColumnDate32::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnDate32>();
+    result->data_->Swap(*data_->SliceShared(begin, len));
 
-    result->data_->Append(col);
+    return result;
+}
+
+ColumnRef ColumnDate32::Gather(Span<const size_t> indices) const {
+    auto result = std::make_shared<ColumnDate32>();
+    result->data_->Swap(*data_->Gather(indices));
 
     return result;
 }
@@ -176,6 +283,15 @@ ItemView ColumnDate32::GetItem(size_t index) const {
     return ItemView{Type()->GetCode(), data_->GetItem(index)};
 }
 
+void ColumnDate32::ToCivilTimes(std::vector<CivilTime>& out) const {
+    DaysToCivilTimes(RawData(), out);
+}
+
+void ColumnDate32::ToStrings(std::string& arena, std::vector<std::string_view>& out) const {
+    // Years of any int32_t number of days fit 7 digits and a sign.
+    DaysToStrings(RawData(), 14, arena, out);
+}
+
 ColumnDateTime::ColumnDateTime()
     : Column(Type::CreateDateTime())
     , data_(std::make_shared<ColumnUInt32>())
@@ -248,21 +364,41 @@ size_t ColumnDateTime::Size() const {
     return data_->Size();
 }
 
+size_t ColumnDateTime::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnDateTime::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 void ColumnDateTime::Clear() {
     data_->Clear();
 }
 
 ColumnRef ColumnDateTime::Slice(size_t begin, size_t len) const {
-    auto col = data_->Slice(begin, len)->As<ColumnUInt32>();
-    auto result = std::make_shared<ColumnDateTime>();
+    auto result = std::make_shared<ColumnDateTime>(Timezone());
+    result->data_->Swap(*data_->Slice(begin, len));
+
+    return result;
+}
+
+ColumnRef ColumnDateTime::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnDateTime>(Timezone());
+    result->data_->Swap(*data_->SliceShared(begin, len));
+
+    return result;
+}
 
-    result->data_->Append(col);
+ColumnRef ColumnDateTime::Gather(Span<const size_t> indices) const {
+    auto result = std::make_shared<ColumnDateTime>(Timezone());
+    result->data_->Swap(*data_->Gather(indices));
 
     return result;
 }
 
 ColumnRef ColumnDateTime::CloneEmpty() const {
-    return std::make_shared<ColumnDateTime>();
+    return std::make_shared<ColumnDateTime>(Timezone());
 }
 
 void ColumnDateTime::Swap(Column& other) {
@@ -274,6 +410,39 @@ ItemView ColumnDateTime::GetItem(size_t index) const {
     return ItemView(Type::DateTime, data_->GetItem(index));
 }
 
+void ColumnDateTime::ToCivilTimes(std::vector<CivilTime>& out) const {
+    ToCivilTimes(*TimeZone::Get(Timezone()), out);
+}
+
+void ColumnDateTime::ToCivilTimes(const TimeZone& timezone, std::vector<CivilTime>& out) const {
+    const auto values = RawData();
+    out.resize(values.size());
+
+    size_t hint = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        out[i] = timezone.ToCivil(values[i], hint);
+    }
+}
+
+void ColumnDateTime::ToStrings(std::string& arena, std::vector<std::string_view>& out) const {
+    ToStrings(*TimeZone::Get(Timezone()), arena, out);
+}
+
+void ColumnDateTime::ToStrings(const TimeZone& timezone, std::string& arena, std::vector<std::string_view>& out) const {
+    const auto values = RawData();
+    // Local time of uint32_t seconds is within years 1969..2106.
+    arena.resize(values.size() * 19);
+    out.resize(values.size());
+
+    char* it = &arena[0];
+    size_t hint = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        const size_t len = FormatDateTime(timezone.ToCivil(values[i], hint), 0, it);
+        out[i] = std::string_view(it, len);
+        it += len;
+    }
+}
+
 ColumnDateTime64::ColumnDateTime64(size_t precision)
     : ColumnDateTime64(Type::CreateDateTime64(precision), std::make_shared<ColumnDecimal>(18ul, precision))
 {}
@@ -333,6 +502,14 @@ size_t ColumnDateTime64::Size() const {
     return data_->Size();
 }
 
+size_t ColumnDateTime64::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnDateTime64::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ItemView ColumnDateTime64::GetItem(size_t index) const {
     return ItemView(Type::DateTime64, data_->GetItem(index));
 }
@@ -353,6 +530,18 @@ ColumnRef ColumnDateTime64::Slice(size_t begin, size_t len) const {
     return ColumnRef{new ColumnDateTime64(type_, sliced_data)};
 }
 
+ColumnRef ColumnDateTime64::SliceShared(size_t begin, size_t len) const {
+    auto sliced_data = data_->SliceShared(begin, len)->As<ColumnDecimal>();
+
+    return ColumnRef{new ColumnDateTime64(type_, sliced_data)};
+}
+
+ColumnRef ColumnDateTime64::Gather(Span<const size_t> indices) const {
+    auto gathered_data = data_->Gather(indices)->As<ColumnDecimal>();
+
+    return ColumnRef{new ColumnDateTime64(type_, gathered_data)};
+}
+
 ColumnRef ColumnDateTime64::CloneEmpty() const {
     return ColumnRef{new ColumnDateTime64(type_, data_->CloneEmpty()->As<ColumnDecimal>())};
 }
@@ -361,4 +550,43 @@ size_t ColumnDateTime64::GetPrecision() const {
     return precision_;
 }
 
+void ColumnDateTime64::ToCivilTimes(std::vector<CivilTime>& out) const {
+    ToCivilTimes(*TimeZone::Get(Timezone()), out);
+}
+
+void ColumnDateTime64::ToCivilTimes(const TimeZone& timezone, std::vector<CivilTime>& out) const {
+    const auto values = RawData();
+    const DateTime64Splitter splitter(precision_);
+    out.resize(values.size());
+
+    size_t hint = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint32_t nanosecond = 0;
+        out[i] = timezone.ToCivil(splitter.Split(values[i], nanosecond), hint);
+        out[i].nanosecond = nanosecond;
+    }
+}
+
+void ColumnDateTime64::ToStrings(std::string& arena, std::vector<std::string_view>& out) const {
+    ToStrings(*TimeZone::Get(Timezone()), arena, out);
+}
+
+void ColumnDateTime64::ToStrings(const TimeZone& timezone, std::string& arena, std::vector<std::string_view>& out) const {
+    const auto values = RawData();
+    const DateTime64Splitter splitter(precision_);
+    arena.resize(values.size() * kMaxFormattedDateTimeLength);
+    out.resize(values.size());
+
+    char* it = &arena[0];
+    size_t hint = 0;
+    for (size_t i = 0; i < values.size(); ++i) {
+        uint32_t nanosecond = 0;
+        CivilTime time = timezone.ToCivil(splitter.Split(values[i], nanosecond), hint);
+        time.nanosecond = nanosecond;
+        const size_t len = FormatDateTime(time, precision_, it);
+        out[i] = std::string_view(it, len);
+        it += len;
+    }
+}
+
 }
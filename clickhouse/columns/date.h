@@ -2,8 +2,12 @@
 
 #include "decimal.h"
 #include "numeric.h"
+#include "../base/time_zone.h"
 
 #include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace clickhouse {
 
@@ -34,6 +38,14 @@ public:
     /// Get Raw Vector Contents
     std::vector<uint16_t>& GetWritableData();
 
+    /// Read-only view of the raw values (as RawAt() returns), invalidated once the column is modified.
+    inline Span<const uint16_t> RawData() const { return data_->RawData(); }
+
+    /// Bulk conversions of the whole column, `out` is resized to Size().
+    void ToCivilTimes(std::vector<CivilTime>& out) const;
+    /// Formats all the values as "YYYY-MM-DD" into `arena`, see ColumnDecimal::ToStrings().
+    void ToStrings(std::string& arena, std::vector<std::string_view>& out) const;
+
     /// Increase the capacity of the column for large block insertion.
     void Reserve(size_t new_cap) override;
 
@@ -52,8 +64,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
@@ -88,6 +106,14 @@ public:
     /// Get Raw Vector Contents
     std::vector<int32_t>& GetWritableData();
 
+    /// Read-only view of the raw values (as RawAt() returns), invalidated once the column is modified.
+    inline Span<const int32_t> RawData() const { return data_->RawData(); }
+
+    /// Bulk conversions of the whole column, `out` is resized to Size().
+    void ToCivilTimes(std::vector<CivilTime>& out) const;
+    /// Formats all the values as "YYYY-MM-DD" into `arena`, see ColumnDecimal::ToStrings().
+    void ToStrings(std::string& arena, std::vector<std::string_view>& out) const;
+
     /// Returns the capacity of the column
     size_t Capacity() const;
 
@@ -110,8 +136,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
@@ -150,6 +182,18 @@ public:
     /// Get Raw Vector Contents
     std::vector<uint32_t>& GetWritableData();
 
+    /// Read-only view of the raw values (as RawAt() returns), invalidated once the column is modified.
+    inline Span<const uint32_t> RawData() const { return data_->RawData(); }
+
+    /// Bulk conversions of the whole column to local time of Timezone(), `out` is resized to Size().
+    /// Columns without a timezone use the server one, which isn't known to the column, UTC is used for them.
+    /// Pass TimeZone::Get(client.GetServerInfo().timezone) explicitly to get the server local time.
+    void ToCivilTimes(std::vector<CivilTime>& out) const;
+    void ToCivilTimes(const TimeZone& timezone, std::vector<CivilTime>& out) const;
+    /// Formats all the values as "YYYY-MM-DD hh:mm:ss" into `arena`, see ColumnDecimal::ToStrings().
+    void ToStrings(std::string& arena, std::vector<std::string_view>& out) const;
+    void ToStrings(const TimeZone& timezone, std::string& arena, std::vector<std::string_view>& out) const;
+
     /// Returns the capacity of the column
     size_t Capacity() const;
 
@@ -172,8 +216,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
@@ -203,6 +253,16 @@ public:
 
     inline Int64 operator[](size_t n) const { return At(n); }
 
+    /// Read-only view of the values (as At() returns), invalidated once the column is modified.
+    inline Span<const int64_t> RawData() const { return data_->RawData<int64_t>(); }
+
+    /// Same as the ColumnDateTime ones, CivilTime::nanosecond is set to the sub-second part.
+    void ToCivilTimes(std::vector<CivilTime>& out) const;
+    void ToCivilTimes(const TimeZone& timezone, std::vector<CivilTime>& out) const;
+    /// Formats all the values as "YYYY-MM-DD hh:mm:ss" followed by GetPrecision() digits of fraction.
+    void ToStrings(std::string& arena, std::vector<std::string_view>& out) const;
+    void ToStrings(const TimeZone& timezone, std::string& arena, std::vector<std::string_view>& out) const;
+
     /// Timezone associated with a data column.
     std::string Timezone() const;
 
@@ -225,8 +285,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
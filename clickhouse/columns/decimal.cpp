@@ -1,20 +1,27 @@
 #include "decimal.h"
+#include "clickhouse/base/bignum_string.h"
 #include "clickhouse/exceptions.h"
 
 #include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <iterator>
+#include <limits>
 
 namespace {
 
+using clickhouse::Bignum;
+using clickhouse::Int128;
+using clickhouse::Int256;
 using clickhouse::ValidationError;
 
-void ValidateDecimalString(const std::string& value, size_t precision, size_t scale)
+void ValidateDecimalString(std::string_view value, size_t precision, size_t scale)
 {
     // Although some of the strings can already be parsed by the existing algorithm without
     // any changes, we do not want to worry about backward-compatibility with weird strings
     // when refactoring and improving the algorithm.
     if (value.empty() || value == "." || value == "-" || value == "-.") {
-        throw ValidationError("bad string " + value);
+        throw ValidationError("bad string " + std::string(value));
     }
 
     auto it = value.begin();
@@ -51,12 +58,221 @@ void ValidateDecimalString(const std::string& value, size_t precision, size_t sc
 
     if (digits > precision) {
         throw ValidationError(
-                std::string("Value ") + value + " is too large for"
+                "Value " + std::string(value) + " is too large for"
                 " scale=" + std::to_string(scale) +
                 " precision=" + std::to_string(precision));
     }
 }
 
+Int256 ToInt256(const Int128& value) {
+    Int256 result(Bignum::Int128High64(value));
+    result.limbs[1] = result.limbs[0];
+    result.limbs[0] = Bignum::Int128Low64(value);
+    return result;
+}
+
+double Pow10(size_t n) {
+    double result = 1;
+    for (size_t i = 0; i < n; ++i) {
+        result *= 10;
+    }
+    return result;
+}
+
+inline double ToDouble(int32_t value) {
+    return value;
+}
+
+inline double ToDouble(int64_t value) {
+    return static_cast<double>(value);
+}
+
+/// Converts two's complement limbs to double, the sign is applied after conversion of the magnitude
+/// to avoid cancellation of the limbs.
+template <size_t N>
+double LimbsToDouble(uint64_t (&limbs)[N]) {
+    const bool negative = static_cast<int64_t>(limbs[N - 1]) < 0;
+    if (negative) {
+        uint64_t carry = 1;
+        for (size_t i = 0; i < N; ++i) {
+            limbs[i] = ~limbs[i] + carry;
+            carry = carry && limbs[i] == 0;
+        }
+    }
+
+    double result = 0;
+    for (size_t i = N; i-- > 0;) {
+        result = result * 0x1p64 + static_cast<double>(limbs[i]);
+    }
+    return negative ? -result : result;
+}
+
+inline double ToDouble(const Int128& value) {
+    uint64_t limbs[2] = {Bignum::Int128Low64(value), static_cast<uint64_t>(Bignum::Int128High64(value))};
+    return LimbsToDouble(limbs);
+}
+
+inline double ToDouble(const Int256& value) {
+    uint64_t limbs[4] = {value.limbs[0], value.limbs[1], value.limbs[2], value.limbs[3]};
+    return LimbsToDouble(limbs);
+}
+
+/// Splits integral `value` into two's complement limbs, |value| must be less than 2^(64 * N - 1).
+template <size_t N>
+void DoubleToLimbs(double value, uint64_t (&limbs)[N]) {
+    double rest = std::fabs(value);
+    for (size_t i = N; i-- > 0;) {
+        const double unit = std::ldexp(1.0, static_cast<int>(64 * i));
+        const double limb = std::floor(rest / unit);
+        limbs[i] = static_cast<uint64_t>(limb);
+        rest -= limb * unit;
+    }
+
+    if (value < 0) {
+        uint64_t carry = 1;
+        for (size_t i = 0; i < N; ++i) {
+            limbs[i] = ~limbs[i] + carry;
+            carry = carry && limbs[i] == 0;
+        }
+    }
+}
+
+template <typename T>
+T FromIntegralDouble(double value) {
+    if constexpr (std::is_same_v<T, Int128>) {
+        uint64_t limbs[2];
+        DoubleToLimbs(value, limbs);
+        return Bignum::MakeInt128(static_cast<int64_t>(limbs[1]), limbs[0]);
+    } else if constexpr (std::is_same_v<T, Int256>) {
+        Int256 result;
+        DoubleToLimbs(value, result.limbs);
+        return result;
+    } else {
+        return static_cast<T>(value);
+    }
+}
+
+template <typename T>
+bool ToInt64(const T& value, int64_t& result) {
+    if constexpr (std::is_same_v<T, Int128>) {
+        result = static_cast<int64_t>(Bignum::Int128Low64(value));
+        return Bignum::Int128High64(value) == (result < 0 ? -1 : 0);
+    } else if constexpr (std::is_same_v<T, Int256>) {
+        result = static_cast<int64_t>(value.limbs[0]);
+        const uint64_t sign = result < 0 ? ~uint64_t(0) : 0;
+        return value.limbs[1] == sign && value.limbs[2] == sign && value.limbs[3] == sign;
+    } else {
+        result = value;
+        return true;
+    }
+}
+
+template <typename T>
+T FromInt64(int64_t value) {
+    if constexpr (std::is_same_v<T, Int256>) {
+        return Int256(value);
+    } else {
+        return static_cast<T>(value);
+    }
+}
+
+/// Max length of the formatted unscaled value of the storage type, including the sign.
+template <typename T>
+constexpr size_t MaxDigits = std::is_same_v<T, Int256> ? 78 : std::is_same_v<T, Int128> ? 40 : sizeof(T) == 8 ? 20 : 11;
+
+/// Writes unscaled value into `buffer`, returns the string within it.
+template <typename T>
+std::string_view FormatUnscaled(const T& value, char (&buffer)[80]) {
+    using clickhouse::internal::bignum::string::limb_arr_to_str;
+    using clickhouse::internal::bignum::string::SignMode;
+
+    if constexpr (std::is_same_v<T, Int128> || std::is_same_v<T, Int256>) {
+        uint32_t limbs[sizeof(T) / 4];
+        if constexpr (std::is_same_v<T, Int128>) {
+            const uint64_t low = Bignum::Int128Low64(value);
+            const uint64_t high = static_cast<uint64_t>(Bignum::Int128High64(value));
+            limbs[0] = static_cast<uint32_t>(low);
+            limbs[1] = static_cast<uint32_t>(low >> 32);
+            limbs[2] = static_cast<uint32_t>(high);
+            limbs[3] = static_cast<uint32_t>(high >> 32);
+        } else {
+            for (size_t i = 0; i < 4; ++i) {
+                limbs[2 * i] = static_cast<uint32_t>(value.limbs[i]);
+                limbs[2 * i + 1] = static_cast<uint32_t>(value.limbs[i] >> 32);
+            }
+        }
+        const char* begin = limb_arr_to_str(limbs, sizeof(T) / 4, SignMode::SIGNED, buffer, sizeof(buffer));
+        return std::string_view(begin, static_cast<size_t>(buffer + sizeof(buffer) - 1 - begin));
+    } else {
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        return std::string_view(buffer, static_cast<size_t>(result.ptr - buffer));
+    }
+}
+
+/// Max length of the value formatted by FormatDecimal(): sign, digits (with leading "0" if all of them are
+/// after the point) and the point. Scale may exceed the number of digits of the storage type.
+template <typename T>
+size_t MaxFormattedSize(size_t scale) {
+    return std::max(MaxDigits<T>, scale + 1) + 2;
+}
+
+/// Writes unscaled value as decimal with `scale` digits after the point into `out`, returns number of written bytes.
+/// `out` must have room for MaxFormattedSize<T>(scale) bytes.
+template <typename T>
+size_t FormatDecimal(const T& value, size_t scale, char* out) {
+    char buffer[80];
+    std::string_view raw = FormatUnscaled(value, buffer);
+    if (scale == 0) {
+        std::copy(raw.begin(), raw.end(), out);
+        return raw.size();
+    }
+
+    char* it = out;
+    if (raw.front() == '-') {
+        *it++ = '-';
+        raw.remove_prefix(1);
+    }
+
+    if (raw.size() > scale) {
+        const size_t integral_len = raw.size() - scale;
+        it = std::copy(raw.begin(), raw.begin() + integral_len, it);
+        *it++ = '.';
+        it = std::copy(raw.begin() + integral_len, raw.end(), it);
+    } else {
+        *it++ = '0';
+        *it++ = '.';
+        it = std::fill_n(it, scale - raw.size(), '0');
+        it = std::copy(raw.begin(), raw.end(), it);
+    }
+    return static_cast<size_t>(it - out);
+}
+
+/// Returns pointer to the values of non-empty column.
+template <typename T>
+const T* RawValues(const clickhouse::ColumnVector<T>& data) {
+    return data.Size() ? &data.At(0) : nullptr;
+}
+
+/// Calls `f` with typed storage column of ColumnDecimal.
+template <typename Column, typename F>
+void VisitDecimalData(clickhouse::Type::Code code, Column& data, F&& f) {
+    using namespace clickhouse;
+    constexpr bool is_const = std::is_const_v<Column>;
+
+    switch (code) {
+        case Type::Int32:
+            return f(static_cast<std::conditional_t<is_const, const ColumnInt32, ColumnInt32>&>(data));
+        case Type::Int64:
+            return f(static_cast<std::conditional_t<is_const, const ColumnInt64, ColumnInt64>&>(data));
+        case Type::Int128:
+            return f(static_cast<std::conditional_t<is_const, const ColumnInt128, ColumnInt128>&>(data));
+        case Type::Int256:
+            return f(static_cast<std::conditional_t<is_const, const ColumnInt256, ColumnInt256>&>(data));
+        default:
+            throw ValidationError("Invalid data_ column type in ColumnDecimal");
+    }
+}
+
 } // anonymous namespace
 
 namespace clickhouse {
@@ -64,12 +280,19 @@ namespace clickhouse {
 ColumnDecimal::ColumnDecimal(size_t precision, size_t scale)
     : Column(Type::CreateDecimal(precision, scale))
 {
+    if (scale > precision) {
+        throw ValidationError("Decimal scale " + std::to_string(scale)
+            + " is greater than precision " + std::to_string(precision));
+    }
+
     if (precision <= 9) {
         data_ = std::make_shared<ColumnInt32>();
     } else if (precision <= 18) {
         data_ = std::make_shared<ColumnInt64>();
-    } else {
+    } else if (precision <= 38) {
         data_ = std::make_shared<ColumnInt128>();
+    } else {
+        data_ = std::make_shared<ColumnInt256>();
     }
     data_type_code_ = data_->Type()->GetCode();
 }
@@ -89,13 +312,33 @@ void ColumnDecimal::Append(const Int128& value) {
         case Type::Int64:
             static_cast<ColumnInt64*>(data_.get())->Append(static_cast<int64_t>(Bignum::Int128Low64(value)));
             break;
+        case Type::Int256:
+            static_cast<ColumnInt256*>(data_.get())->Append(ToInt256(value));
+            break;
         default:
             static_cast<ColumnInt128*>(data_.get())->Append(static_cast<Int128>(value));
             break;
     }
 }
 
+void ColumnDecimal::Append(const Int256& value) {
+    switch (data_type_code_) {
+        case Type::Int256:
+            static_cast<ColumnInt256*>(data_.get())->Append(value);
+            break;
+        default:
+            // Same truncation as for Int128 values appended to narrower columns.
+            Append(Bignum::MakeInt128(static_cast<int64_t>(value.limbs[1]), value.limbs[0]));
+            break;
+    }
+}
+
 void ColumnDecimal::Append(const std::string& value) {
+    std::string buffer;
+    AppendString(value, buffer);
+}
+
+void ColumnDecimal::AppendString(std::string_view value, std::string& cleaned) {
     auto scale = type_->As<DecimalType>()->GetScale();
     auto precision = type_->As<DecimalType>()->GetPrecision();
 
@@ -109,7 +352,7 @@ void ColumnDecimal::Append(const std::string& value) {
     // no zeros must be padded.
     // This is highly debatable behavior, but it has been since beginning of the library
     // and we leave it here for backward compatibility.
-    std::string cleaned{};
+    cleaned.clear();
     cleaned.reserve(precision + 1); // extra byte for the '-' sign
 
     int64_t pad_len = 0;
@@ -142,7 +385,11 @@ void ColumnDecimal::Append(const std::string& value) {
         }
     }
 
-    Append(Bignum::StringToInt128(cleaned));
+    if (data_type_code_ == Type::Int256) {
+        Append(Bignum::StringToInt256(cleaned));
+    } else {
+        Append(Bignum::StringToInt128(cleaned));
+    }
 }
 
 Int128 ColumnDecimal::At(size_t i) const {
@@ -153,11 +400,26 @@ Int128 ColumnDecimal::At(size_t i) const {
             return static_cast<Int128>(static_cast<const ColumnInt64*>(data_.get())->At(i));
         case Type::Int128:
             return static_cast<const ColumnInt128*>(data_.get())->At(i);
+        case Type::Int256: {
+            const Int256 value = static_cast<const ColumnInt256*>(data_.get())->At(i);
+            const Int128 result = Bignum::MakeInt128(static_cast<int64_t>(value.limbs[1]), value.limbs[0]);
+            if (ToInt256(result) != value) {
+                throw ValidationError("Decimal value " + Bignum::Int256ToString(value) + " doesn't fit into Int128");
+            }
+            return result;
+        }
         default:
             throw ValidationError("Invalid data_ column type in ColumnDecimal");
     }
 }
 
+Int256 ColumnDecimal::AtInt256(size_t i) const {
+    if (data_type_code_ == Type::Int256) {
+        return static_cast<const ColumnInt256*>(data_.get())->At(i);
+    }
+    return ToInt256(At(i));
+}
+
 Int128 ColumnDecimal::operator[](size_t i) const {
     return At(i);
 }
@@ -165,37 +427,113 @@ Int128 ColumnDecimal::operator[](size_t i) const {
 std::string ColumnDecimal::StringAt(size_t i) const {
     auto scale = GetScale();
 
-    Int128 val = At(i);
-    std::string raw_str = Bignum::Int128ToString(val);
-    if (scale == 0) {
-        return raw_str;
-    }
-
     std::string ret;
-    ret.reserve(GetPrecision() + 2); // extra space for '-' and '.';
+    VisitDecimalData(data_type_code_, *data_, [&](const auto& data) {
+        using T = typename std::decay_t<decltype(data)>::ValueType;
+        ret.resize(MaxFormattedSize<T>(scale));
+        ret.resize(FormatDecimal(data.At(i), scale, &ret[0]));
+    });
+    return ret;
+}
 
-    auto it = raw_str.cbegin();
-    auto end = raw_str.cend();
+void ColumnDecimal::ToDoubles(std::vector<double>& out) const {
+    const double divisor = Pow10(GetScale());
+    VisitDecimalData(data_type_code_, *data_, [&](const auto& data) {
+        const auto* values = RawValues(data);
+        out.resize(data.Size());
+        for (size_t i = 0; i < out.size(); ++i) {
+            out[i] = ToDouble(values[i]) / divisor;
+        }
+    });
+}
 
-    if (it != end && *it == '-') {
-        ret.push_back(*it++);
-    }
+void ColumnDecimal::ToScaledInt64(std::vector<int64_t>& out) const {
+    VisitDecimalData(data_type_code_, *data_, [&](const auto& data) {
+        const auto* values = RawValues(data);
+        out.resize(data.Size());
+        for (size_t i = 0; i < out.size(); ++i) {
+            if (!ToInt64(values[i], out[i])) {
+                throw ValidationError("Decimal value " + StringAt(i) + " doesn't fit into Int64");
+            }
+        }
+    });
+}
 
-    int64_t str_len = std::distance(it, end);
-    int64_t integral_len = str_len - static_cast<int64_t>(scale);
+void ColumnDecimal::ToStrings(std::string& arena, std::vector<std::string_view>& out) const {
+    const size_t scale = GetScale();
+    VisitDecimalData(data_type_code_, *data_, [&](const auto& data) {
+        using T = typename std::decay_t<decltype(data)>::ValueType;
+        const size_t rows = data.Size();
+        const T* values = RawValues(data);
+
+        arena.resize(rows * MaxFormattedSize<T>(scale));
+        out.resize(rows);
+
+        char* it = &arena[0];
+        for (size_t i = 0; i < rows; ++i) {
+            const size_t len = FormatDecimal(values[i], scale, it);
+            out[i] = std::string_view(it, len);
+            it += len;
+        }
 
-    if (integral_len > 0) {
-        std::copy(it, it + integral_len, std::back_inserter(ret));
-        it += integral_len;
-        ret.push_back('.');
-    }
-    else {
-        ret.append("0.");
-        ret.append(static_cast<size_t>(-integral_len), '0');
+    });
+}
+
+void ColumnDecimal::AppendDoubles(const double* values, size_t count) {
+    const double multiplier = Pow10(GetScale());
+    const double limit = Pow10(GetPrecision());
+
+    VisitDecimalData(data_type_code_, *data_, [&](auto& data) {
+        using T = typename std::decay_t<decltype(data)>::ValueType;
+        auto& vec = data.GetWritableData();
+        const size_t old_size = vec.size();
+        vec.reserve(old_size + count);
+
+        for (size_t i = 0; i < count; ++i) {
+            const double value = std::round(values[i] * multiplier);
+            if (!(std::fabs(value) < limit)) {
+                vec.resize(old_size);
+                throw ValidationError("Value " + std::to_string(values[i]) + " is out of range of " + type_->GetName());
+            }
+            vec.push_back(FromIntegralDouble<T>(value));
+        }
+    });
+}
+
+void ColumnDecimal::AppendScaledInt64(const int64_t* values, size_t count) {
+    const size_t precision = GetPrecision();
+    // Any int64 value has at most 19 digits.
+    int64_t limit = std::numeric_limits<int64_t>::max();
+    if (precision < 19) {
+        limit = 1;
+        for (size_t i = 0; i < precision; ++i) {
+            limit *= 10;
+        }
     }
-    std::copy(it, end, std::back_inserter(ret));
 
-    return ret;
+    VisitDecimalData(data_type_code_, *data_, [&](auto& data) {
+        using T = typename std::decay_t<decltype(data)>::ValueType;
+        auto& vec = data.GetWritableData();
+        const size_t old_size = vec.size();
+        vec.reserve(old_size + count);
+
+        for (size_t i = 0; i < count; ++i) {
+            if (precision < 19 && (values[i] >= limit || values[i] <= -limit)) {
+                vec.resize(old_size);
+                throw ValidationError("Value " + std::to_string(values[i]) + " is out of range of " + type_->GetName());
+            }
+            vec.push_back(FromInt64<T>(values[i]));
+        }
+    });
+}
+
+void ColumnDecimal::AppendStrings(const std::string_view* values, size_t count) {
+    data_->Reserve(data_->Size() + count);
+
+    std::string buffer;
+    for (size_t i = 0; i < count; ++i) {
+        AppendString(values[i], buffer);
+    }
 }
 
 void ColumnDecimal::Reserve(size_t new_cap) {
@@ -224,11 +562,29 @@ size_t ColumnDecimal::Size() const {
     return data_->Size();
 }
 
+size_t ColumnDecimal::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnDecimal::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnDecimal::Slice(size_t begin, size_t len) const {
     // coundn't use std::make_shared since this c-tor is private
     return ColumnRef{new ColumnDecimal(type_, data_->Slice(begin, len))};
 }
 
+ColumnRef ColumnDecimal::SliceShared(size_t begin, size_t len) const {
+    // coundn't use std::make_shared since this c-tor is private
+    return ColumnRef{new ColumnDecimal(type_, data_->SliceShared(begin, len))};
+}
+
+ColumnRef ColumnDecimal::Gather(Span<const size_t> indices) const {
+    // coundn't use std::make_shared since this c-tor is private
+    return ColumnRef{new ColumnDecimal(type_, data_->Gather(indices))};
+}
+
 ColumnRef ColumnDecimal::CloneEmpty() const {
     // coundn't use std::make_shared since this c-tor is private
     return ColumnRef{new ColumnDecimal(type_, data_->CloneEmpty())};
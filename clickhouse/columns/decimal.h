@@ -3,8 +3,15 @@
 #include "column.h"
 #include "numeric.h"
 
+#include <string>
+#include <string_view>
+#include <vector>
+
 namespace clickhouse {
 
+template <typename T>
+class ColumnDecimalT;
+
 /**
  * Represents a column of decimal type.
  */
@@ -12,17 +19,50 @@ class ColumnDecimal : public Column {
 public:
     using ValueType = Int128;
 
+    /// Throws ValidationError if scale is greater than precision.
     ColumnDecimal(size_t precision, size_t scale);
 
     CH_ABSEIL_BIGNUM_DEPRECATED void Append(const Int128& value);
+    void Append(const Int256& value);
     void Append(const std::string& value);
 
+    /// Throws ValidationError if the value of Decimal256 column doesn't fit into Int128, use AtInt256() instead.
     CH_ABSEIL_BIGNUM_DEPRECATED Int128 At(size_t i) const;
     CH_ABSEIL_BIGNUM_DEPRECATED Int128 operator[](size_t i) const;
 
+    /// Unscaled value widened to 256 bits, works for any precision.
+    Int256 AtInt256(size_t i) const;
+
+    /// Read-only view of the unscaled values, throws ValidationError if they are not stored as T
+    /// (see ColumnDecimalT). Invalidated once the column is modified.
+    template <typename T>
+    Span<const T> RawData() const {
+        auto data = dynamic_cast<const ColumnVector<T>*>(data_.get());
+        if (!data) {
+            throw ValidationError("Values of " + type_->GetName() + " are not stored as " + Type::CreateSimple<T>()->GetName());
+        }
+        return data->RawData();
+    }
+
     // Returns string representation of the decimal value
     std::string StringAt(size_t i) const;
 
+    /// Bulk conversions of the whole column, `out` is resized to Size().
+    void ToDoubles(std::vector<double>& out) const;
+    /// Unscaled values, i.e. values multiplied by 10^scale. Throws ValidationError if a value doesn't fit into int64_t.
+    void ToScaledInt64(std::vector<int64_t>& out) const;
+    /// Formats all the values into `arena` (its capacity is reused, the size is an upper bound of the used part),
+    /// `out[i]` is the i-th value within it and is valid until `arena` is modified.
+    void ToStrings(std::string& arena, std::vector<std::string_view>& out) const;
+
+    /// Appends values rounded to the scale. Throws ValidationError if a value is not finite or has more
+    /// than `precision` digits, nothing is appended in that case.
+    void AppendDoubles(const double* values, size_t count);
+    /// Appends unscaled values, i.e. values multiplied by 10^scale, with the same checks as AppendDoubles().
+    void AppendScaledInt64(const int64_t* values, size_t count);
+    /// Same as Append(const std::string&) for each of the values.
+    void AppendStrings(const std::string_view* values, size_t count);
+
 public:
     /// Increase the capacity of the column for large block insertion.
     void Reserve(size_t new_cap) override;
@@ -31,7 +71,11 @@ public:
     void SaveBody(OutputStream* output) override;
     void Clear() override;
     size_t Size() const override;
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
     ItemView GetItem(size_t index) const override;
@@ -39,15 +83,128 @@ public:
     size_t GetScale() const;
     size_t GetPrecision() const;
 
+protected:
+    explicit ColumnDecimal(TypeRef type, ColumnRef data);
+
 private:
+    template <typename T>
+    friend class ColumnDecimalT;
+
+    void AppendString(std::string_view value, std::string& buffer);
+
     /// Depending on a precision it can be one of:
     ///  - ColumnInt32
     ///  - ColumnInt64
     ///  - ColumnInt128
+    ///  - ColumnInt256
     ColumnRef data_;
     Type::Code data_type_code_;
+};
 
-    explicit ColumnDecimal(TypeRef type, ColumnRef data);
+/**
+ * Typed view of ColumnDecimal for the given storage type, i.e. one of int32_t (precision up to 9),
+ * int64_t (up to 18), Int128 (up to 38) or Int256. Values are accessed directly, without dispatching
+ * on the storage type for each of them.
+ */
+template <typename T>
+class ColumnDecimalT : public ColumnDecimal, public WrappableColumn<ColumnDecimalT<T>, ColumnDecimal> {
+public:
+    using DataColumnType = ColumnVector<T>;
+    using ValueType = T;
+
+    /// Throws ValidationError if values of the given precision are not stored as T.
+    ColumnDecimalT(size_t precision, size_t scale)
+        : ColumnDecimal(precision, scale)
+        , typed_data_(std::dynamic_pointer_cast<DataColumnType>(data_))
+    {
+        if (!typed_data_) {
+            throw ValidationError("Can't make ColumnDecimalT of " + type_->GetName() + ": unexpected storage type");
+        }
+    }
+
+    using ColumnDecimal::Append;
+
+    /// Appends unscaled value, i.e. value multiplied by 10^scale.
+    inline void Append(const T& value) { typed_data_->Append(value); }
+
+    /// Returns unscaled value at the given row.
+    inline const T& At(size_t i) const { return typed_data_->At(i); }
+    inline const T& operator[](size_t i) const { return typed_data_->At(i); }
+
+    /// Unscaled values.
+    inline std::vector<T>& GetWritableData() { return typed_data_->GetWritableData(); }
+
+    /// Read-only view of the unscaled values, invalidated once the column is modified.
+    inline Span<const T> RawData() const { return typed_data_->RawData(); }
+
+    /** Create a ColumnDecimalT that SHARES the values of `col`.
+     *
+     *  The two-argument overloads are non-throwing: on a type mismatch they return
+     *  nullptr and, if `error` is non-null, assign a description to `*error`. The
+     *  single-argument overloads throw ValidationError on a type mismatch instead.
+     */
+    static std::shared_ptr<ColumnDecimalT<T>> Wrap(const ColumnDecimal& col, ValidationError* error) {
+        auto data = std::dynamic_pointer_cast<DataColumnType>(col.data_);
+        if (!data) {
+            if (error) {
+                *error = ValidationError("Can't wrap Decimal column: unexpected storage type of " + col.GetType().GetName());
+            }
+            return nullptr;
+        }
+        // Couldn't use std::make_shared since this c-tor is private.
+        return std::shared_ptr<ColumnDecimalT<T>>(new ColumnDecimalT<T>(col.Type(), data));
+    }
+
+    static std::shared_ptr<ColumnDecimalT<T>> Wrap(const Column& col, ValidationError* error) {
+        if (auto* c = dynamic_cast<const ColumnDecimal*>(&col)) {
+            return Wrap(*c, error);
+        }
+        if (error) {
+            *error = ValidationError("Can't wrap column of type " + col.GetType().GetName() + " as Decimal");
+        }
+        return nullptr;
+    }
+
+    // Helper to simplify integration with other APIs
+    static std::shared_ptr<ColumnDecimalT<T>> Wrap(const ColumnRef& col, ValidationError* error) {
+        return Wrap(*col, error);
+    }
+
+    // Throwing single-argument overloads (concrete type / Column& / ColumnRef&).
+    using WrappableColumn<ColumnDecimalT<T>, ColumnDecimal>::Wrap;
+
+    ColumnRef Slice(size_t begin, size_t len) const override {
+        return Wrap(ColumnDecimal::Slice(begin, len));
+    }
+
+    ColumnRef SliceShared(size_t begin, size_t len) const override {
+        return Wrap(ColumnDecimal::SliceShared(begin, len));
+    }
+
+    ColumnRef Gather(Span<const size_t> indices) const override {
+        return Wrap(ColumnDecimal::Gather(indices));
+    }
+
+    ColumnRef CloneEmpty() const override { return Wrap(ColumnDecimal::CloneEmpty()); }
+
+    void Swap(Column& other) override {
+        auto& col = dynamic_cast<ColumnDecimalT<T>&>(other);
+        ColumnDecimal::Swap(col);
+        typed_data_.swap(col.typed_data_);
+    }
+
+private:
+    ColumnDecimalT(TypeRef type, std::shared_ptr<DataColumnType> data)
+        : ColumnDecimal(std::move(type), data)
+        , typed_data_(std::move(data))
+    {}
+
+    std::shared_ptr<DataColumnType> typed_data_;
 };
 
+using ColumnDecimal32T = ColumnDecimalT<int32_t>;
+using ColumnDecimal64T = ColumnDecimalT<int64_t>;
+using ColumnDecimal128T = ColumnDecimalT<Int128>;
+using ColumnDecimal256T = ColumnDecimalT<Int256>;
+
 }
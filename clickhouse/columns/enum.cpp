@@ -31,12 +31,12 @@ void ColumnEnum<T>::Append(const T& value, bool checkValue) {
     if  (checkValue) {
         // TODO: type_->HasEnumValue(value), "Enum type doesn't have value " + std::to_string(value);
     }
-    data_.push_back(value);
+    data_.Mutable().push_back(value);
 }
 
 template <typename T>
 void ColumnEnum<T>::Append(const std::string& name) {
-    data_.push_back(static_cast<T>(type_->As<EnumType>()->GetEnumValue(name)));
+    data_.Mutable().push_back(static_cast<T>(type_->As<EnumType>()->GetEnumValue(name)));
 }
 
 template <typename T>
@@ -59,30 +59,33 @@ void ColumnEnum<T>::SetAt(size_t n, const T& value, bool checkValue) {
     if (checkValue) {
         // TODO: type_->HasEnumValue(value), "Enum type doesn't have value " + std::to_string(value);
     }
-    data_.at(n) = value;
+    data_.Mutable().at(n) = value;
 }
 
 template <typename T>
 void ColumnEnum<T>::SetNameAt(size_t n, const std::string& name) {
-    data_.at(n) = static_cast<T>(type_->As<EnumType>()->GetEnumValue(name));
+    data_.Mutable().at(n) = static_cast<T>(type_->As<EnumType>()->GetEnumValue(name));
 }
 
 template<typename T>
 void ColumnEnum<T>::Reserve(size_t new_cap) {
-    data_.reserve(new_cap);
+    data_.Mutable().reserve(new_cap);
 }
 
 template <typename T>
 void ColumnEnum<T>::Append(ColumnRef column) {
     if (auto col = column->As<ColumnEnum<T>>()) {
-        data_.insert(data_.end(), col->data_.begin(), col->data_.end());
+        auto& data = data_.Mutable();
+        data.insert(data.end(), col->data_.begin(), col->data_.end());
     }
 }
 
 template <typename T>
 bool ColumnEnum<T>::LoadBody(InputStream* input, size_t rows) {
-    data_.resize(rows);
-    return WireFormat::ReadBytes(*input, data_.data(), data_.size() * sizeof(T));
+    data_.clear();
+    auto& data = data_.Mutable();
+    data.resize(rows);
+    return WireFormat::ReadBytes(*input, data.data(), data.size() * sizeof(T));
 }
 
 template <typename T>
@@ -95,9 +98,38 @@ size_t ColumnEnum<T>::Size() const {
     return data_.size();
 }
 
+template <typename T>
+size_t ColumnEnum<T>::ByteSize() const {
+    return data_.size() * sizeof(T);
+}
+
+template <typename T>
+size_t ColumnEnum<T>::AllocatedBytes() const {
+    return data_.capacity() * sizeof(T);
+}
+
 template <typename T>
 ColumnRef ColumnEnum<T>::Slice(size_t begin, size_t len) const {
-    return std::make_shared<ColumnEnum<T>>(type_, SliceVector(data_, begin, len));
+    return std::make_shared<ColumnEnum<T>>(type_, data_.Copy(begin, len));
+}
+
+template <typename T>
+ColumnRef ColumnEnum<T>::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnEnum<T>>(type_);
+    result->data_ = data_.Slice(begin, len);
+    return result;
+}
+
+template <typename T>
+ColumnRef ColumnEnum<T>::Filter(Span<const uint8_t> mask) const {
+    CheckFilterMask(mask);
+    return std::make_shared<ColumnEnum<T>>(type_, FilterVector(RawData(), mask));
+}
+
+template <typename T>
+ColumnRef ColumnEnum<T>::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+    return std::make_shared<ColumnEnum<T>>(type_, GatherVector(RawData(), indices));
 }
 
 template <typename T>
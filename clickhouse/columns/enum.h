@@ -1,6 +1,7 @@
 #pragma once
 
 #include "column.h"
+#include "cow_data.h"
 
 namespace clickhouse {
 
@@ -25,6 +26,9 @@ public:
     /// Returns element at given row number.
     inline const T& operator[] (size_t n) const { return At(n); }
 
+    /// Read-only view of the values, invalidated once the column is modified.
+    inline Span<const T> RawData() const { return {data_.data(), data_.size()}; }
+
     /// Set element at given row number.
     void SetAt(size_t n, const T& value, bool checkValue = false);
     void SetNameAt(size_t n, const std::string& name);
@@ -48,15 +52,22 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Filter(Span<const uint8_t> mask) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
     ItemView GetItem(size_t index) const override;
 
 private:
-    std::vector<T> data_;
+    CowData<std::vector<T>> data_;
 };
 
 using ColumnEnum8 = ColumnEnum<int8_t>;
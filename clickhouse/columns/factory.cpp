@@ -46,7 +46,7 @@ const auto& GetASTChildElement(const TypeAst & ast, int position) {
     return ast.elements[static_cast<size_t>(position)];
 }
 
-static ColumnRef CreateTerminalColumn(const TypeAst& ast) {
+static ColumnRef CreateTerminalColumn(const TypeAst& ast, const CreateColumnByTypeSettings& settings) {
     switch (ast.code) {
     case Type::Void:
         return std::make_shared<ColumnNothing>();
@@ -74,6 +74,10 @@ static ColumnRef CreateTerminalColumn(const TypeAst& ast) {
         return std::make_shared<ColumnInt128>();
     case Type::UInt128:
         return std::make_shared<ColumnUInt128>();
+    case Type::Int256:
+        return std::make_shared<ColumnInt256>();
+    case Type::UInt256:
+        return std::make_shared<ColumnUInt256>();
 
     case Type::Float32:
         return std::make_shared<ColumnFloat32>();
@@ -88,9 +92,11 @@ static ColumnRef CreateTerminalColumn(const TypeAst& ast) {
         return std::make_shared<ColumnDecimal>(18, GetASTChildElement(ast, 0).value);
     case Type::Decimal128:
         return std::make_shared<ColumnDecimal>(38, GetASTChildElement(ast, 0).value);
+    case Type::Decimal256:
+        return std::make_shared<ColumnDecimal>(76, GetASTChildElement(ast, 0).value);
 
     case Type::String:
-        return std::make_shared<ColumnString>();
+        return std::make_shared<ColumnString>(settings.memory_resource);
     case Type::FixedString:
         return std::make_shared<ColumnFixedString>(GetASTChildElement(ast, 0).value);
 
@@ -163,7 +169,7 @@ static ColumnRef CreateColumnFromAst(const TypeAst& ast, CreateColumnByTypeSetti
         }
 
         case TypeAst::Terminal: {
-            return CreateTerminalColumn(ast);
+            return CreateTerminalColumn(ast, settings);
         }
 
         case TypeAst::Tuple: {
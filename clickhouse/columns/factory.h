@@ -1,12 +1,18 @@
 #pragma once
 
 #include "column.h"
+#include "../base/memory_resource.h"
+
+#include <memory>
 
 namespace clickhouse {
 
 struct CreateColumnByTypeSettings
 {
     bool low_cardinality_as_wrapped_column = false;
+    /// Resource to allocate variable-length data of the created columns (including nested ones) from,
+    /// e.g. an ArenaMemoryResource shared by all the columns of a block. The heap is used if null.
+    std::shared_ptr<MemoryResource> memory_resource;
 };
 
 ColumnRef CreateColumnByType(const std::string& type_name, CreateColumnByTypeSettings settings = {});
@@ -79,11 +79,31 @@ size_t ColumnGeo<NestedColumnType, type_code>::Size() const {
     return data_->Size();
 }
 
+template <typename NestedColumnType, Type::Code type_code>
+size_t ColumnGeo<NestedColumnType, type_code>::ByteSize() const {
+    return data_->ByteSize();
+}
+
+template <typename NestedColumnType, Type::Code type_code>
+size_t ColumnGeo<NestedColumnType, type_code>::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 template <typename NestedColumnType, Type::Code type_code>
 ColumnRef ColumnGeo<NestedColumnType, type_code>::Slice(size_t begin, size_t len) const {
     return std::make_shared<ColumnGeo>(data_->Slice(begin, len));
 }
 
+template <typename NestedColumnType, Type::Code type_code>
+ColumnRef ColumnGeo<NestedColumnType, type_code>::SliceShared(size_t begin, size_t len) const {
+    return std::make_shared<ColumnGeo>(data_->SliceShared(begin, len));
+}
+
+template <typename NestedColumnType, Type::Code type_code>
+ColumnRef ColumnGeo<NestedColumnType, type_code>::Gather(Span<const size_t> indices) const {
+    return std::make_shared<ColumnGeo>(data_->Gather(indices));
+}
+
 template <typename NestedColumnType, Type::Code type_code>
 ColumnRef ColumnGeo<NestedColumnType, type_code>::CloneEmpty() const {
     return std::make_shared<ColumnGeo>();
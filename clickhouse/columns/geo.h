@@ -47,8 +47,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
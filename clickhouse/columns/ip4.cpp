@@ -97,10 +97,26 @@ size_t ColumnIPv4::Size() const {
     return data_->Size();
 }
 
+size_t ColumnIPv4::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnIPv4::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnIPv4::Slice(size_t begin, size_t len) const {
     return std::make_shared<ColumnIPv4>(data_->Slice(begin, len));
 }
 
+ColumnRef ColumnIPv4::SliceShared(size_t begin, size_t len) const {
+    return std::make_shared<ColumnIPv4>(data_->SliceShared(begin, len));
+}
+
+ColumnRef ColumnIPv4::Gather(Span<const size_t> indices) const {
+    return std::make_shared<ColumnIPv4>(data_->Gather(indices));
+}
+
 ColumnRef ColumnIPv4::CloneEmpty() const {
     return std::make_shared<ColumnIPv4>(data_->CloneEmpty());
 }
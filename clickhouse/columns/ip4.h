@@ -36,6 +36,9 @@ public:
     /// Returns element at given row number.
     in_addr operator [] (size_t n) const;
 
+    /// Read-only view of the addresses as numbers, i.e. 1.2.3.4 is 0x01020304, invalidated once the column is modified.
+    inline Span<const uint32_t> RawData() const { return data_->RawData(); }
+
     std::string AsString(size_t n) const;
 
 public:
@@ -57,8 +60,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
@@ -94,10 +94,26 @@ size_t ColumnIPv6::Size() const {
     return data_->Size();
 }
 
+size_t ColumnIPv6::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnIPv6::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnIPv6::Slice(size_t begin, size_t len) const {
     return std::make_shared<ColumnIPv6>(data_->Slice(begin, len));
 }
 
+ColumnRef ColumnIPv6::SliceShared(size_t begin, size_t len) const {
+    return std::make_shared<ColumnIPv6>(data_->SliceShared(begin, len));
+}
+
+ColumnRef ColumnIPv6::Gather(Span<const size_t> indices) const {
+    return std::make_shared<ColumnIPv6>(data_->Gather(indices));
+}
+
 ColumnRef ColumnIPv6::CloneEmpty() const {
     return std::make_shared<ColumnIPv6>(data_->CloneEmpty());
 }
@@ -32,6 +32,9 @@ public:
     /// Returns element at given row number.
     in6_addr operator [] (size_t n) const;
 
+    /// Read-only view of the addresses, 16 bytes in network byte order each, invalidated once the column is modified.
+    inline Span<const char> RawData() const { return data_->RawData(); }
+
     std::string AsString(size_t n) const;
 
 public:
@@ -53,8 +56,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
     ItemView GetItem(size_t index) const override;
@@ -78,6 +78,14 @@ size_t ColumnJSON::Size() const {
     return data_->Size();
 }
 
+size_t ColumnJSON::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnJSON::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnJSON::Slice(size_t begin, size_t len) const {
     auto ret = std::make_shared<ColumnJSON>();
     auto sliced_data = data_->Slice(begin, len)->As<ColumnString>();
@@ -85,6 +93,20 @@ ColumnRef ColumnJSON::Slice(size_t begin, size_t len) const {
     return ret;
 }
 
+ColumnRef ColumnJSON::SliceShared(size_t begin, size_t len) const {
+    auto ret = std::make_shared<ColumnJSON>();
+    auto sliced_data = data_->SliceShared(begin, len)->As<ColumnString>();
+    ret->data_->Swap(*sliced_data);
+    return ret;
+}
+
+ColumnRef ColumnJSON::Gather(Span<const size_t> indices) const {
+    auto ret = std::make_shared<ColumnJSON>();
+    auto gathered_data = data_->Gather(indices)->As<ColumnString>();
+    ret->data_->Swap(*gathered_data);
+    return ret;
+}
+
 ColumnRef ColumnJSON::CloneEmpty() const
 {
     return std::make_shared<ColumnJSON>();
@@ -114,6 +114,9 @@ inline size_t FixedSizeForDictionaryType(Type::Code code) {
         case Type::IPv6:
         case Type::UUID:
             return 16;
+        case Type::Int256:
+        case Type::UInt256:
+            return 32;
         default:
             return 0;
     }
@@ -123,7 +126,7 @@ inline size_t FixedSizeForDictionaryType(Type::Code code) {
 // backing buffer is static so the non-owning view stays valid.
 inline ItemView ZeroItemForDictionary(Type::Code code) {
     if (const auto size = FixedSizeForDictionaryType(code)) {
-        static const char zeros[16] = {};
+        static const char zeros[32] = {};
         if (size > sizeof(zeros)) {
             throw AssertionError("The size of item view for ColumnLowCardinality exceeds the buffer size");
         }
@@ -217,6 +220,12 @@ inline void AppendToDictionary(Column& dictionary, const ItemView & item) {
         case Type::UInt128:
             column_down_cast<ColumnUInt128>(dictionary).Append(item.get<UInt128>());
             return;
+        case Type::Int256:
+            column_down_cast<ColumnInt256>(dictionary).Append(item.get<Int256>());
+            return;
+        case Type::UInt256:
+            column_down_cast<ColumnUInt256>(dictionary).Append(item.get<UInt256>());
+            return;
         case Type::Float32:
             column_down_cast<ColumnFloat32>(dictionary).Append(item.get<float>());
             return;
@@ -457,8 +466,8 @@ auto Load(ColumnRef new_dictionary_column, InputStream& input, size_t rows) {
 
     if (auto nullable = new_dictionary_column->As<ColumnNullable>()) {
         nullable->Append(true);
-        for(std::size_t i = 1; i < dataColumn->Size(); i++) {
-            nullable->Append(false);
+        if (dataColumn->Size() > 1) {
+            nullable->AppendNullFlags(false, dataColumn->Size() - 1);
         }
     }
 
@@ -546,6 +555,17 @@ size_t ColumnLowCardinality::Size() const {
     return index_->column->Size();
 }
 
+size_t ColumnLowCardinality::ByteSize() const {
+    return dictionary_column_->ByteSize() + index_->column->ByteSize();
+}
+
+size_t ColumnLowCardinality::AllocatedBytes() const {
+    // Estimate of the hash map: array of buckets and a node with a pointer to the next one per item.
+    const size_t map_bytes = unique_items_map_->bucket_count() * sizeof(void*)
+        + unique_items_map_->size() * (sizeof(UniqueItems::value_type) + sizeof(void*));
+    return dictionary_column_->AllocatedBytes() + index_->column->AllocatedBytes() + map_bytes;
+}
+
 ColumnRef ColumnLowCardinality::Slice(size_t begin, size_t len) const {
     begin = std::min(begin, Size());
     len = std::min(len, Size() - begin);
@@ -558,6 +578,17 @@ ColumnRef ColumnLowCardinality::Slice(size_t begin, size_t len) const {
     return result;
 }
 
+ColumnRef ColumnLowCardinality::Gather(Span<const size_t> indices) const {
+    // Only the index is gathered, the result shares values of the dictionary (until either column is modified)
+    // and gets a copy of the hash map, so no items are hashed again.
+    auto result = std::shared_ptr<ColumnLowCardinality>(new ColumnLowCardinality(*this));
+    result->dictionary_column_ = dictionary_column_->SliceShared(0, dictionary_column_->Size());
+    result->index_ = std::make_shared<IndexState>(IndexState{index_->column->Gather(indices), index_->type_code});
+    result->unique_items_map_ = std::make_shared<UniqueItems>(*unique_items_map_);
+
+    return result;
+}
+
 ColumnRef ColumnLowCardinality::CloneEmpty() const {
     return std::make_shared<ColumnLowCardinality>(dictionary_column_->CloneEmpty());
 }
@@ -87,8 +87,13 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of current column, with compacted dictionary
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
     ItemView GetItem(size_t index) const override;
@@ -273,6 +278,10 @@ public:
         return Wrap(ColumnLowCardinality::Slice(begin, size));
     }
 
+    ColumnRef Gather(Span<const size_t> indices) const override {
+        return Wrap(ColumnLowCardinality::Gather(indices));
+    }
+
     ColumnRef CloneEmpty() const override { return Wrap(ColumnLowCardinality::CloneEmpty()); }
 
 private:
@@ -66,10 +66,26 @@ size_t ColumnMap::Size() const {
     return data_->Size();
 }
 
+size_t ColumnMap::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnMap::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnMap::Slice(size_t begin, size_t len) const {
     return std::make_shared<ColumnMap>(data_->Slice(begin, len));
 }
 
+ColumnRef ColumnMap::SliceShared(size_t begin, size_t len) const {
+    return std::make_shared<ColumnMap>(data_->SliceShared(begin, len));
+}
+
+ColumnRef ColumnMap::Gather(Span<const size_t> indices) const {
+    return std::make_shared<ColumnMap>(data_->Gather(indices));
+}
+
 ColumnRef ColumnMap::CloneEmpty() const {
     return std::make_shared<ColumnMap>(data_->CloneEmpty());
 }
@@ -49,8 +49,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t, size_t) const override;
+    ColumnRef SliceShared(size_t, size_t) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column&) override;
 
@@ -90,6 +96,14 @@ public:
         return std::make_shared<ColumnMapT<K, V>>(typed_data_->Slice(begin, len));
     }
 
+    ColumnRef SliceShared(size_t begin, size_t len) const override {
+        return std::make_shared<ColumnMapT<K, V>>(typed_data_->SliceShared(begin, len));
+    }
+
+    ColumnRef Gather(Span<const size_t> indices) const override {
+        return std::make_shared<ColumnMapT<K, V>>(typed_data_->Gather(indices));
+    }
+
     ColumnRef CloneEmpty() const override {
         return std::make_shared<ColumnMapT<K, V>>(typed_data_->CloneEmpty());
     }
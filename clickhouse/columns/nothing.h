@@ -43,6 +43,11 @@ public:
         return std::make_shared<ColumnNothing>(len);
     }
 
+    ColumnRef Gather(Span<const size_t> indices) const override {
+        CheckGatherIndices(indices);
+        return std::make_shared<ColumnNothing>(indices.size());
+    }
+
     ColumnRef CloneEmpty() const override {
         return std::make_shared<ColumnNothing>();
     }
@@ -75,6 +80,10 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override { return size_; }
 
+    /// Values of the column are not stored.
+    size_t ByteSize() const override { return 0; }
+    size_t AllocatedBytes() const override { return 0; }
+
     void Swap(Column& other) override {
         auto & col = dynamic_cast<ColumnNothing &>(other);
         std::swap(size_, col.size_);
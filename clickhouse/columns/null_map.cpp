@@ -0,0 +1,319 @@
+#include "null_map.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#   define CH_NULL_MAP_SSE2 1
+#   include <immintrin.h>
+// AVX2 kernels are compiled with the target attribute and selected at runtime, so the library
+// itself doesn't require AVX2.
+#   if defined(__GNUC__) || defined(__clang__)
+#       define CH_NULL_MAP_AVX2 1
+#       define CH_TARGET_AVX2 __attribute__((target("avx2")))
+#   endif
+#endif
+
+namespace clickhouse {
+
+namespace {
+
+inline uint32_t PopCount(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_popcount(x));
+#else
+    uint32_t count = 0;
+    for (; x; x &= x - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// `x` must not be 0.
+inline uint32_t CountTrailingZeros(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_ctz(x));
+#else
+    uint32_t count = 0;
+    for (; (x & 1) == 0; x >>= 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+/// Writes `base + i` for each bit `i` set in `mask` of `width` bits, returns the position after the last written.
+inline uint32_t* WriteMaskedRows(uint32_t mask, uint32_t width, uint32_t base, uint32_t* out) {
+    const uint32_t full = width == 32 ? ~uint32_t(0) : (uint32_t(1) << width) - 1;
+    if (mask == full) {
+        for (uint32_t i = 0; i < width; ++i) {
+            *out++ = base + i;
+        }
+        return out;
+    }
+    for (; mask; mask &= mask - 1) {
+        *out++ = base + CountTrailingZeros(mask);
+    }
+    return out;
+}
+
+/// Scalar kernels, process rows starting from `begin`, used for tails of the vectorized ones.
+
+size_t CountNullsScalar(const uint8_t* null_map, size_t begin, size_t rows) {
+    size_t count = 0;
+    for (size_t i = begin; i < rows; ++i) {
+        count += null_map[i] != 0;
+    }
+    return count;
+}
+
+size_t FindFirstNullScalar(const uint8_t* null_map, size_t begin, size_t rows) {
+    for (size_t i = begin; i < rows; ++i) {
+        if (null_map[i]) {
+            return i;
+        }
+    }
+    return rows;
+}
+
+/// Returns the position after the last written row.
+uint32_t* BuildSelectionScalar(const uint8_t* null_map, size_t begin, size_t rows, bool nulls, uint32_t* out) {
+    for (size_t i = begin; i < rows; ++i) {
+        // Branchless, the row is overwritten by the next one if it is not selected.
+        *out = static_cast<uint32_t>(i);
+        out += (null_map[i] != 0) == nulls;
+    }
+    return out;
+}
+
+/// `begin` must be a multiple of 8.
+void ToBitmapScalar(const uint8_t* null_map, size_t begin, size_t rows, uint8_t* bitmap) {
+    for (size_t i = begin; i < rows; i += 8) {
+        uint8_t bits = 0;
+        const size_t end = std::min(rows, i + 8);
+        for (size_t j = i; j < end; ++j) {
+            bits = static_cast<uint8_t>(bits | (null_map[j] == 0) << (j - i));
+        }
+        bitmap[i / 8] = bits;
+    }
+}
+
+#if defined(CH_NULL_MAP_SSE2)
+
+/// Bit `i` is set if `null_map[i]` is zero, i.e. the row is not NULL.
+inline uint32_t ValidMaskSSE2(const uint8_t* null_map) {
+    const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(null_map));
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(values, _mm_setzero_si128())));
+}
+
+size_t CountNullsSSE2(const uint8_t* null_map, size_t rows) {
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 16 <= rows; i += 16) {
+        count += 16 - PopCount(ValidMaskSSE2(null_map + i));
+    }
+    return count + CountNullsScalar(null_map, i, rows);
+}
+
+size_t FindFirstNullSSE2(const uint8_t* null_map, size_t rows) {
+    size_t i = 0;
+    for (; i + 16 <= rows; i += 16) {
+        const uint32_t nulls = ~ValidMaskSSE2(null_map + i) & 0xFFFF;
+        if (nulls) {
+            return i + CountTrailingZeros(nulls);
+        }
+    }
+    return FindFirstNullScalar(null_map, i, rows);
+}
+
+uint32_t* BuildSelectionSSE2(const uint8_t* null_map, size_t rows, bool nulls, uint32_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= rows; i += 16) {
+        const uint32_t valid = ValidMaskSSE2(null_map + i);
+        out = WriteMaskedRows(nulls ? ~valid & 0xFFFF : valid, 16, static_cast<uint32_t>(i), out);
+    }
+    return BuildSelectionScalar(null_map, i, rows, nulls, out);
+}
+
+void ToBitmapSSE2(const uint8_t* null_map, size_t rows, uint8_t* bitmap) {
+    size_t i = 0;
+    for (; i + 16 <= rows; i += 16) {
+        const uint32_t valid = ValidMaskSSE2(null_map + i);
+        bitmap[i / 8] = static_cast<uint8_t>(valid);
+        bitmap[i / 8 + 1] = static_cast<uint8_t>(valid >> 8);
+    }
+    ToBitmapScalar(null_map, i, rows, bitmap);
+}
+
+#endif
+
+#if defined(CH_NULL_MAP_AVX2)
+
+CH_TARGET_AVX2 inline uint32_t ValidMaskAVX2(const uint8_t* null_map) {
+    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(null_map));
+    return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(values, _mm256_setzero_si256())));
+}
+
+CH_TARGET_AVX2 size_t CountNullsAVX2(const uint8_t* null_map, size_t rows) {
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 32 <= rows; i += 32) {
+        count += 32 - PopCount(ValidMaskAVX2(null_map + i));
+    }
+    return count + CountNullsScalar(null_map, i, rows);
+}
+
+CH_TARGET_AVX2 size_t FindFirstNullAVX2(const uint8_t* null_map, size_t rows) {
+    size_t i = 0;
+    for (; i + 32 <= rows; i += 32) {
+        const uint32_t nulls = ~ValidMaskAVX2(null_map + i);
+        if (nulls) {
+            return i + CountTrailingZeros(nulls);
+        }
+    }
+    return FindFirstNullScalar(null_map, i, rows);
+}
+
+CH_TARGET_AVX2 uint32_t* BuildSelectionAVX2(const uint8_t* null_map, size_t rows, bool nulls, uint32_t* out) {
+    size_t i = 0;
+    for (; i + 32 <= rows; i += 32) {
+        const uint32_t valid = ValidMaskAVX2(null_map + i);
+        out = WriteMaskedRows(nulls ? ~valid : valid, 32, static_cast<uint32_t>(i), out);
+    }
+    return BuildSelectionScalar(null_map, i, rows, nulls, out);
+}
+
+CH_TARGET_AVX2 void ToBitmapAVX2(const uint8_t* null_map, size_t rows, uint8_t* bitmap) {
+    size_t i = 0;
+    for (; i + 32 <= rows; i += 32) {
+        const uint32_t valid = ValidMaskAVX2(null_map + i);
+        for (size_t j = 0; j < 4; ++j) {
+            bitmap[i / 8 + j] = static_cast<uint8_t>(valid >> (8 * j));
+        }
+    }
+    ToBitmapScalar(null_map, i, rows, bitmap);
+}
+
+#endif
+
+SimdLevel Resolve(SimdLevel level) {
+    static const SimdLevel detected = DetectSimdLevel();
+    if (level == SimdLevel::Auto || static_cast<int>(level) > static_cast<int>(detected)) {
+        return detected;
+    }
+    return level;
+}
+
+/// Null map bytes of each of 256 validity bitmap bytes.
+constexpr std::array<uint64_t, 256> MakeNullMapTable() {
+    std::array<uint64_t, 256> table{};
+    for (size_t bits = 0; bits < 256; ++bits) {
+        uint64_t bytes = 0;
+        for (size_t j = 0; j < 8; ++j) {
+            if ((bits >> j & 1) == 0) {
+                bytes |= uint64_t(1) << (8 * j);
+            }
+        }
+        table[bits] = bytes;
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 256> kNullMapTable = MakeNullMapTable();
+
+}
+
+SimdLevel DetectSimdLevel() {
+#if defined(CH_NULL_MAP_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+#if defined(CH_NULL_MAP_SSE2)
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+size_t CountNulls(Span<const uint8_t> null_map, SimdLevel level) {
+    switch (Resolve(level)) {
+#if defined(CH_NULL_MAP_AVX2)
+        case SimdLevel::AVX2:
+            return CountNullsAVX2(null_map.data(), null_map.size());
+#endif
+#if defined(CH_NULL_MAP_SSE2)
+        case SimdLevel::SSE2:
+            return CountNullsSSE2(null_map.data(), null_map.size());
+#endif
+        default:
+            return CountNullsScalar(null_map.data(), 0, null_map.size());
+    }
+}
+
+size_t FindFirstNull(Span<const uint8_t> null_map, SimdLevel level) {
+    switch (Resolve(level)) {
+#if defined(CH_NULL_MAP_AVX2)
+        case SimdLevel::AVX2:
+            return FindFirstNullAVX2(null_map.data(), null_map.size());
+#endif
+#if defined(CH_NULL_MAP_SSE2)
+        case SimdLevel::SSE2:
+            return FindFirstNullSSE2(null_map.data(), null_map.size());
+#endif
+        default:
+            return FindFirstNullScalar(null_map.data(), 0, null_map.size());
+    }
+}
+
+void BuildSelection(Span<const uint8_t> null_map, std::vector<uint32_t>& rows, bool nulls, SimdLevel level) {
+    // The scalar kernel writes one row past the last selected one.
+    rows.resize(null_map.size() + 1);
+    uint32_t* end = nullptr;
+
+    switch (Resolve(level)) {
+#if defined(CH_NULL_MAP_AVX2)
+        case SimdLevel::AVX2:
+            end = BuildSelectionAVX2(null_map.data(), null_map.size(), nulls, rows.data());
+            break;
+#endif
+#if defined(CH_NULL_MAP_SSE2)
+        case SimdLevel::SSE2:
+            end = BuildSelectionSSE2(null_map.data(), null_map.size(), nulls, rows.data());
+            break;
+#endif
+        default:
+            end = BuildSelectionScalar(null_map.data(), 0, null_map.size(), nulls, rows.data());
+            break;
+    }
+    rows.resize(static_cast<size_t>(end - rows.data()));
+}
+
+void NullMapToValidityBitmap(Span<const uint8_t> null_map, uint8_t* bitmap, SimdLevel level) {
+    switch (Resolve(level)) {
+#if defined(CH_NULL_MAP_AVX2)
+        case SimdLevel::AVX2:
+            return ToBitmapAVX2(null_map.data(), null_map.size(), bitmap);
+#endif
+#if defined(CH_NULL_MAP_SSE2)
+        case SimdLevel::SSE2:
+            return ToBitmapSSE2(null_map.data(), null_map.size(), bitmap);
+#endif
+        default:
+            return ToBitmapScalar(null_map.data(), 0, null_map.size(), bitmap);
+    }
+}
+
+void ValidityBitmapToNullMap(const uint8_t* bitmap, size_t rows, uint8_t* null_map) {
+    size_t i = 0;
+    for (; i + 8 <= rows; i += 8) {
+        std::memcpy(null_map + i, &kNullMapTable[bitmap[i / 8]], 8);
+    }
+    for (; i < rows; ++i) {
+        null_map[i] = (bitmap[i / 8] >> (i % 8) & 1) == 0;
+    }
+}
+
+}
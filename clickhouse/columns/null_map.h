@@ -0,0 +1,44 @@
+#pragma once
+
+#include "../base/span.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace clickhouse {
+
+/**
+ * Helpers for processing null maps of Nullable columns (see ColumnNullable::NullMap()) a block at a time.
+ *
+ * A null map has a byte per row, any non-zero byte denotes NULL. Validity bitmaps are Arrow-style:
+ * a bit per row in LSB order, bit `i % 8` of byte `i / 8` is set if row `i` is NOT NULL.
+ */
+enum class SimdLevel {
+    /// The best level supported by both the build and the CPU.
+    Auto,
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+/// The best level supported by both the build and the CPU.
+SimdLevel DetectSimdLevel();
+
+/// Number of NULLs.
+size_t CountNulls(Span<const uint8_t> null_map, SimdLevel level = SimdLevel::Auto);
+
+/// Index of the first NULL or null_map.size() if there are none.
+size_t FindFirstNull(Span<const uint8_t> null_map, SimdLevel level = SimdLevel::Auto);
+
+/// Fills `rows` with indices of non-NULL rows (or NULL rows if `nulls` is true) in ascending order.
+void BuildSelection(Span<const uint8_t> null_map, std::vector<uint32_t>& rows, bool nulls = false,
+    SimdLevel level = SimdLevel::Auto);
+
+/// Writes (null_map.size() + 7) / 8 bytes to `bitmap`, unused bits of the last byte are zeroed.
+void NullMapToValidityBitmap(Span<const uint8_t> null_map, uint8_t* bitmap, SimdLevel level = SimdLevel::Auto);
+
+/// Writes `rows` bytes to `null_map`, 1 for NULL and 0 otherwise.
+void ValidityBitmapToNullMap(const uint8_t* bitmap, size_t rows, uint8_t* null_map);
+
+}
@@ -1,4 +1,5 @@
 #include "nullable.h"
+#include "null_map.h"
 
 #include <assert.h>
 #include <stdexcept>
@@ -20,6 +21,18 @@ void ColumnNullable::Append(bool isnull)
     nulls_->Append(isnull ? 1 : 0);
 }
 
+void ColumnNullable::AppendNullFlags(bool isnull, size_t count) {
+    auto& nulls = nulls_->GetWritableData();
+    nulls.insert(nulls.end(), count, isnull ? 1 : 0);
+}
+
+void ColumnNullable::AppendValidityBitmap(const uint8_t* bitmap, size_t rows) {
+    auto& nulls = nulls_->GetWritableData();
+    const size_t old_size = nulls.size();
+    nulls.resize(old_size + rows);
+    ValidityBitmapToNullMap(bitmap, rows, nulls.data() + old_size);
+}
+
 
 bool ColumnNullable::IsNull(size_t n) const {
     return nulls_->At(n) != 0;
@@ -82,10 +95,30 @@ size_t ColumnNullable::Size() const {
     return nulls_->Size();
 }
 
+size_t ColumnNullable::ByteSize() const {
+    return nested_->ByteSize() + nulls_->ByteSize();
+}
+
+size_t ColumnNullable::AllocatedBytes() const {
+    return nested_->AllocatedBytes() + nulls_->AllocatedBytes();
+}
+
 ColumnRef ColumnNullable::Slice(size_t begin, size_t len) const {
     return std::make_shared<ColumnNullable>(nested_->Slice(begin, len), nulls_->Slice(begin, len));
 }
 
+ColumnRef ColumnNullable::SliceShared(size_t begin, size_t len) const {
+    return std::make_shared<ColumnNullable>(nested_->SliceShared(begin, len), nulls_->SliceShared(begin, len));
+}
+
+ColumnRef ColumnNullable::Filter(Span<const uint8_t> mask) const {
+    return std::make_shared<ColumnNullable>(nested_->Filter(mask), nulls_->Filter(mask));
+}
+
+ColumnRef ColumnNullable::Gather(Span<const size_t> indices) const {
+    return std::make_shared<ColumnNullable>(nested_->Gather(indices), nulls_->Gather(indices));
+}
+
 ColumnRef ColumnNullable::CloneEmpty() const {
     return std::make_shared<ColumnNullable>(nested_->CloneEmpty(), nulls_->CloneEmpty());
 }
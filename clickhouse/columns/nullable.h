@@ -17,6 +17,13 @@ public:
     /// Appends one null flag to the end of the column
     void Append(bool isnull);
 
+    /// Appends `count` equal null flags.
+    void AppendNullFlags(bool isnull, size_t count);
+
+    /// Appends null flags of `rows` rows from Arrow-style validity bitmap (see null_map.h).
+    /// As with Append(bool), nested values must be appended separately.
+    void AppendValidityBitmap(const uint8_t* bitmap, size_t rows);
+
     /// Returns null flag at given row number.
     bool IsNull(size_t n) const;
 
@@ -26,6 +33,9 @@ public:
     /// Returns nulls column.
     ColumnRef Nulls() const;
 
+    /// Read-only view of the null flags, 1 for NULL and 0 otherwise, invalidated once the column is modified.
+    inline Span<const uint8_t> NullMap() const { return nulls_->RawData(); }
+
 public:
     /// Increase the capacity of the column for large block insertion.
     void Reserve(size_t new_cap) override;
@@ -51,8 +61,15 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Filter(Span<const uint8_t> mask) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column&) override;
 
@@ -89,6 +106,10 @@ public:
 
     inline ValueType operator[](size_t index) const { return At(index); }
 
+    /// Read-only view of the nested values, available if the nested column is fixed-width.
+    /// Values of NULL rows are the defaults. Invalidated once the column is modified.
+    inline auto RawData() const { return typed_nested_data_->RawData(); }
+
     /// Appends content of given column to the end of current one.
     void Append(ColumnRef column) override {
         ColumnNullable::Append(std::move(column));
@@ -156,6 +177,18 @@ public:
         return Wrap(ColumnNullable::Slice(begin, size));
     }
 
+    ColumnRef SliceShared(size_t begin, size_t size) const override {
+        return Wrap(ColumnNullable::SliceShared(begin, size));
+    }
+
+    ColumnRef Filter(Span<const uint8_t> mask) const override {
+        return Wrap(ColumnNullable::Filter(mask));
+    }
+
+    ColumnRef Gather(Span<const size_t> indices) const override {
+        return Wrap(ColumnNullable::Gather(indices));
+    }
+
     ColumnRef CloneEmpty() const override { return Wrap(ColumnNullable::CloneEmpty()); }
 
     void Swap(Column& other) override {
@@ -26,7 +26,14 @@ ColumnVector<T>::ColumnVector(std::vector<T> && data)
 
 template <typename T>
 void ColumnVector<T>::Append(const T& value) {
-    data_.push_back(value);
+    data_.Mutable().push_back(value);
+}
+
+template <typename T>
+void ColumnVector<T>::AppendRange(const T* values, size_t count) {
+    // Grows geometrically and copies trivially copyable values with a single memmove.
+    auto& data = data_.Mutable();
+    data.insert(data.end(), values, values + count);
 }
 
 template <typename T>
@@ -34,17 +41,18 @@ void ColumnVector<T>::Erase(size_t pos, size_t count) {
     const auto begin = std::min(pos, data_.size());
     const auto last = begin + std::min(data_.size() - begin, count);
 
-    data_.erase(data_.begin() + begin, data_.begin() + last);
+    auto& data = data_.Mutable();
+    data.erase(data.begin() + begin, data.begin() + last);
 }
 
 template <typename T>
 std::vector<T>& ColumnVector<T>::GetWritableData() {
-    return data_;
+    return data_.Mutable();
 }
 
 template <typename T>
 void ColumnVector<T>::Reserve(size_t new_cap) {
-    data_.reserve(new_cap);
+    data_.Mutable().reserve(new_cap);
 }
 
 template <typename T>
@@ -70,15 +78,19 @@ const T& ColumnVector<T>::operator [] (size_t n) const {
 template <typename T>
 void ColumnVector<T>::Append(ColumnRef column) {
     if (auto col = column->As<ColumnVector<T>>()) {
-        data_.insert(data_.end(), col->data_.begin(), col->data_.end());
+        // Holding the values makes Mutable() copy them if the column is appended to itself.
+        const auto values = col->data_;
+        AppendRange(values.data(), values.size());
     }
 }
 
 template <typename T>
 bool ColumnVector<T>::LoadBody(InputStream* input, size_t rows) {
-    data_.resize(rows);
+    data_.clear();
+    auto& data = data_.Mutable();
+    data.resize(rows);
 
-    return WireFormat::ReadBytes(*input, data_.data(), data_.size() * sizeof(T));
+    return WireFormat::ReadBytes(*input, data.data(), data.size() * sizeof(T));
 }
 
 template <typename T>
@@ -91,9 +103,38 @@ size_t ColumnVector<T>::Size() const {
     return data_.size();
 }
 
+template <typename T>
+size_t ColumnVector<T>::ByteSize() const {
+    return data_.size() * sizeof(T);
+}
+
+template <typename T>
+size_t ColumnVector<T>::AllocatedBytes() const {
+    return data_.capacity() * sizeof(T);
+}
+
 template <typename T>
 ColumnRef ColumnVector<T>::Slice(size_t begin, size_t len) const {
-    return std::make_shared<ColumnVector<T>>(SliceVector(data_, begin, len));
+    return std::make_shared<ColumnVector<T>>(data_.Copy(begin, len));
+}
+
+template <typename T>
+ColumnRef ColumnVector<T>::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnVector<T>>();
+    result->data_ = data_.Slice(begin, len);
+    return result;
+}
+
+template <typename T>
+ColumnRef ColumnVector<T>::Filter(Span<const uint8_t> mask) const {
+    CheckFilterMask(mask);
+    return std::make_shared<ColumnVector<T>>(FilterVector(RawData(), mask));
+}
+
+template <typename T>
+ColumnRef ColumnVector<T>::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+    return std::make_shared<ColumnVector<T>>(GatherVector(RawData(), indices));
 }
 
 template <typename T>
@@ -114,7 +155,7 @@ ItemView ColumnVector<T>::GetItem(size_t index) const  {
 
 template <>
 void ColumnVector<Int128>::Append(const Int128& value) {
-    data_.push_back(value);
+    data_.Mutable().push_back(value);
 }
 
 template <>
@@ -129,12 +170,12 @@ const Int128& ColumnVector<Int128>::operator [] (size_t n) const {
 
 template <>
 std::vector<Int128>& ColumnVector<Int128>::GetWritableData() {
-    return data_;
+    return data_.Mutable();
 }
 
 template <>
 void ColumnVector<UInt128>::Append(const UInt128& value) {
-    data_.push_back(value);
+    data_.Mutable().push_back(value);
 }
 
 template <>
@@ -149,7 +190,7 @@ const UInt128& ColumnVector<UInt128>::operator [] (size_t n) const {
 
 template <>
 std::vector<UInt128>& ColumnVector<UInt128>::GetWritableData() {
-    return data_;
+    return data_.Mutable();
 }
 
 template class ColumnVector<int8_t>;
@@ -163,6 +204,8 @@ template class ColumnVector<uint32_t>;
 template class ColumnVector<uint64_t>;
 template class ColumnVector<Int128>;
 template class ColumnVector<UInt128>;
+template class ColumnVector<Int256>;
+template class ColumnVector<UInt256>;
 
 template class ColumnVector<float>;
 template class ColumnVector<double>;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "column.h"
+#include "cow_data.h"
 
 namespace clickhouse {
 
@@ -24,6 +25,9 @@ public:
     /// Appends one element to the end of column.
     void Append(const T& value);
 
+    /// Appends `count` elements stored contiguously at `values`, which must not point into the column.
+    void AppendRange(const T* values, size_t count);
+
     /// Returns element at given row number.
     const T& At(size_t n) const;
 
@@ -32,9 +36,14 @@ public:
 
     void Erase(size_t pos, size_t count = 1);
 
-    /// Get Raw Vector Contents
+    /// Get Raw Vector Contents.
+    /// Values shared with slices of the column are copied first. The values are shared again by SliceShared(),
+    /// so don't keep the reference across it: writes through it would modify the slices too.
     std::vector<T>& GetWritableData();
 
+    /// Read-only view of the values, invalidated once the column is modified.
+    inline Span<const T> RawData() const { return {data_.data(), data_.size()}; }
+
     /// Returns the capacity of the column
     size_t Capacity() const;
 
@@ -54,15 +63,22 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Filter(Span<const uint8_t> mask) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
     ItemView GetItem(size_t index) const override;
 
 private:
-    std::vector<T> data_;
+    CowData<std::vector<T>> data_;
 };
 
 using ColumnUInt8   = ColumnVector<uint8_t>;
@@ -70,12 +86,14 @@ using ColumnUInt16  = ColumnVector<uint16_t>;
 using ColumnUInt32  = ColumnVector<uint32_t>;
 using ColumnUInt64  = ColumnVector<uint64_t>;
 using ColumnUInt128 = ColumnVector<UInt128>;
+using ColumnUInt256 = ColumnVector<UInt256>;
 
 using ColumnInt8    = ColumnVector<int8_t>;
 using ColumnInt16   = ColumnVector<int16_t>;
 using ColumnInt32   = ColumnVector<int32_t>;
 using ColumnInt64   = ColumnVector<int64_t>;
 using ColumnInt128  = ColumnVector<Int128>;
+using ColumnInt256  = ColumnVector<Int256>;
 
 using ColumnFloat32 = ColumnVector<float>;
 using ColumnFloat64 = ColumnVector<double>;
@@ -32,7 +32,7 @@ ColumnFixedString::ColumnFixedString(size_t n)
 }
 
 void ColumnFixedString::Reserve(size_t new_cap) {
-    data_.reserve(string_size_ * new_cap);
+    data_.Mutable().reserve(string_size_ * new_cap);
 }
 
 void ColumnFixedString::Append(std::string_view str) {
@@ -42,17 +42,34 @@ void ColumnFixedString::Append(std::string_view str) {
                                  + std::to_string(str.size()) + " bytes.");
     }
 
-    if (data_.capacity() - data_.size() < str.size()) {
-        // round up to the next block size
-        const auto new_size = (((data_.size() + string_size_) / DEFAULT_BLOCK_SIZE) + 1) * DEFAULT_BLOCK_SIZE;
-        data_.reserve(new_size);
+    // Both append() calls grow the string geometrically.
+    auto& data = data_.Mutable();
+    data.append(str);
+    // Pad up to string_size_ with zeroes.
+    data.append(string_size_ - str.size(), char(0));
+}
+
+void ColumnFixedString::AppendFixedStrings(const char* data, size_t count, size_t stride) {
+    if (stride > string_size_) {
+        throw ValidationError("Expected strings of length not greater than "
+                                 + std::to_string(string_size_) + " bytes, received "
+                                 + std::to_string(stride) + " bytes.");
+    }
+    if (count == 0) {
+        return;
     }
 
-    data_.insert(data_.size(), str);
-    // Pad up to string_size_ with zeroes.
-    if (str.size() < string_size_) {
-        const auto padding_size = string_size_ - str.size();
-        data_.resize(data_.size() + padding_size, char(0));
+    auto& values = data_.Mutable();
+    if (stride == string_size_) {
+        values.append(data, count * string_size_);
+        return;
+    }
+
+    // Padding is written at once, then values are copied over it.
+    const auto size = values.size();
+    values.append(count * string_size_, char(0));
+    for (size_t i = 0; i < count; ++i) {
+        memcpy(&values[size + i * string_size_], data + i * stride, stride);
     }
 }
 
@@ -72,14 +89,18 @@ size_t ColumnFixedString::FixedSize() const {
 void ColumnFixedString::Append(ColumnRef column) {
     if (auto col = column->As<ColumnFixedString>()) {
         if (string_size_ == col->string_size_) {
-            data_.insert(data_.end(), col->data_.begin(), col->data_.end());
+            // Holding the values makes Mutable() copy them if the column is appended to itself.
+            const auto values = col->data_;
+            AppendFixedStrings(values.data(), col->Size(), string_size_);
         }
     }
 }
 
 bool ColumnFixedString::LoadBody(InputStream * input, size_t rows) {
-    data_.resize(string_size_ * rows);
-    if (!WireFormat::ReadBytes(*input, &data_[0], data_.size())) {
+    data_.clear();
+    auto& data = data_.Mutable();
+    data.resize(string_size_ * rows);
+    if (!WireFormat::ReadBytes(*input, &data[0], data.size())) {
         return false;
     }
 
@@ -94,13 +115,57 @@ size_t ColumnFixedString::Size() const {
     return data_.size() / string_size_;
 }
 
+size_t ColumnFixedString::ByteSize() const {
+    return data_.size();
+}
+
+size_t ColumnFixedString::AllocatedBytes() const {
+    return data_.capacity();
+}
+
 ColumnRef ColumnFixedString::Slice(size_t begin, size_t len) const {
     auto result = std::make_shared<ColumnFixedString>(string_size_);
 
     if (begin < Size()) {
-        const auto b = begin * string_size_;
-        const auto l = len * string_size_;
-        result->data_ = data_.substr(b, std::min(data_.size() - b, l));
+        result->data_ = CowData<std::string>(data_.Copy(begin * string_size_, len * string_size_));
+    }
+
+    return result;
+}
+
+ColumnRef ColumnFixedString::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnFixedString>(string_size_);
+
+    if (begin < Size()) {
+        result->data_ = data_.Slice(begin * string_size_, len * string_size_);
+    }
+
+    return result;
+}
+
+ColumnRef ColumnFixedString::Filter(Span<const uint8_t> mask) const {
+    CheckFilterMask(mask);
+
+    auto result = std::make_shared<ColumnFixedString>(string_size_);
+    auto& data = result->data_.Mutable();
+    data.reserve(data_.size());
+    for (size_t i = 0; i < mask.size(); ++i) {
+        if (mask[i]) {
+            data.append(data_.data() + i * string_size_, string_size_);
+        }
+    }
+
+    return result;
+}
+
+ColumnRef ColumnFixedString::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+
+    auto result = std::make_shared<ColumnFixedString>(string_size_);
+    auto& data = result->data_.Mutable();
+    data.resize(indices.size() * string_size_);
+    for (size_t i = 0; i < indices.size(); ++i) {
+        memcpy(&data[i * string_size_], data_.data() + indices[i] * string_size_, string_size_);
     }
 
     return result;
@@ -124,12 +189,33 @@ struct ColumnString::Block
 {
     using CharT = typename std::string::value_type;
 
-    explicit Block(size_t starting_capacity)
+    /// Frees data to the resource it was allocated from.
+    struct Deleter {
+        std::shared_ptr<MemoryResource> memory_resource;
+        size_t capacity;
+
+        void operator()(CharT* data) const {
+            if (memory_resource) {
+                memory_resource->Deallocate(data, capacity, alignof(CharT));
+            } else {
+                delete[] data;
+            }
+        }
+    };
+
+    Block(size_t starting_capacity, const std::shared_ptr<MemoryResource>& memory_resource)
         : size(0),
         capacity(starting_capacity),
-        data_(new CharT[capacity])
+        data_(Allocate(capacity, memory_resource))
     {}
 
+    static std::unique_ptr<CharT[], Deleter> Allocate(size_t capacity, const std::shared_ptr<MemoryResource>& memory_resource) {
+        if (memory_resource) {
+            return {static_cast<CharT*>(memory_resource->Allocate(capacity, alignof(CharT))), Deleter{memory_resource, capacity}};
+        }
+        return {new CharT[capacity], Deleter{nullptr, capacity}};
+    }
+
     inline auto GetAvailable() const {
         return capacity - size;
     }
@@ -160,27 +246,40 @@ struct ColumnString::Block
 
     size_t size;
     const size_t capacity;
-    std::unique_ptr<CharT[]> data_;
+    std::unique_ptr<CharT[], Deleter> data_;
+};
+
+struct ColumnString::Storage
+{
+    std::vector<Block> blocks;
+    std::deque<std::string> append_data;
 };
 
 ColumnString::ColumnString()
     : Column(Type::CreateString())
+    , storage_(std::make_shared<Storage>())
 {
 }
 
 ColumnString::ColumnString(size_t element_count)
-    : Column(Type::CreateString())
+    : ColumnString()
 {
-    items_.reserve(element_count);
+    items_.Mutable().reserve(element_count);
     // 16 is arbitrary number, assumption that string values are about ~256 bytes long.
-    blocks_.reserve(std::max<size_t>(1, element_count / 16));
+    storage_->blocks.reserve(std::max<size_t>(1, element_count / 16));
+}
+
+ColumnString::ColumnString(std::shared_ptr<MemoryResource> memory_resource)
+    : ColumnString()
+{
+    memory_resource_ = std::move(memory_resource);
 }
 
 ColumnString::ColumnString(const std::vector<std::string>& data)
     : ColumnString()
 {
-    items_.reserve(data.size());
-    blocks_.emplace_back(ComputeTotalSize(data));
+    items_.Mutable().reserve(data.size());
+    storage_->blocks.emplace_back(ComputeTotalSize(data), memory_resource_);
 
     for (const auto & s : data) {
         AppendUnsafe(s);
@@ -190,30 +289,50 @@ ColumnString::ColumnString(const std::vector<std::string>& data)
 ColumnString::ColumnString(std::vector<std::string>&& data)
     : ColumnString()
 {
-    items_.reserve(data.size());
+    auto& items = items_.Mutable();
+    items.reserve(data.size());
 
     for (auto&& d : data) {
-        append_data_.emplace_back(std::move(d));
-        auto& last_data = append_data_.back();
-        items_.emplace_back(std::string_view{ last_data.data(),last_data.length() });
+        storage_->append_data.emplace_back(std::move(d));
+        auto& last_data = storage_->append_data.back();
+        items.emplace_back(std::string_view{ last_data.data(),last_data.length() });
     }
 }
 
 ColumnString::~ColumnString()
 {}
 
+ColumnString::Storage& ColumnString::MutableStorage() {
+    if (!IsUniqueOwner(storage_)) {
+        shared_storage_.push_back(std::move(storage_));
+        storage_ = std::make_shared<Storage>();
+    }
+    return *storage_;
+}
+
+void ColumnString::ResetStorage() {
+    if (IsUniqueOwner(storage_)) {
+        storage_->blocks.clear();
+        storage_->append_data.clear();
+    } else {
+        storage_ = std::make_shared<Storage>();
+    }
+    shared_storage_.clear();
+}
+
 void ColumnString::Reserve(size_t new_cap) {
-    items_.reserve(new_cap);
+    items_.Mutable().reserve(new_cap);
     // 16 is arbitrary number, assumption that string values are about ~256 bytes long.
-    blocks_.reserve(std::max<size_t>(1, new_cap / 16));
+    MutableStorage().blocks.reserve(std::max<size_t>(1, new_cap / 16));
 }
 
 void ColumnString::Append(std::string_view str) {
-    if (blocks_.size() == 0 || blocks_.back().GetAvailable() < str.length()) {
-        blocks_.emplace_back(std::max(DEFAULT_BLOCK_SIZE, str.size()));
+    auto& blocks = MutableStorage().blocks;
+    if (blocks.size() == 0 || blocks.back().GetAvailable() < str.length()) {
+        blocks.emplace_back(std::max(DEFAULT_BLOCK_SIZE, str.size()), memory_resource_);
     }
 
-    items_.emplace_back(blocks_.back().AppendUnsafe(str));
+    items_.Mutable().emplace_back(blocks.back().AppendUnsafe(str));
 }
 
 void ColumnString::Append(const char* str) {
@@ -221,23 +340,23 @@ void ColumnString::Append(const char* str) {
 }
 
 void ColumnString::Append(std::string&& steal_value) {
-    append_data_.emplace_back(std::move(steal_value));
-    auto& last_data = append_data_.back();
-    items_.emplace_back(std::string_view{ last_data.data(),last_data.length() });
+    auto& append_data = MutableStorage().append_data;
+    append_data.emplace_back(std::move(steal_value));
+    auto& last_data = append_data.back();
+    items_.Mutable().emplace_back(std::string_view{ last_data.data(),last_data.length() });
 }
 
 void ColumnString::AppendNoManagedLifetime(std::string_view str) {
-    items_.emplace_back(str);
+    items_.Mutable().emplace_back(str);
 }
 
 void ColumnString::AppendUnsafe(std::string_view str) {
-    items_.emplace_back(blocks_.back().AppendUnsafe(str));
+    items_.Mutable().emplace_back(storage_->blocks.back().AppendUnsafe(str));
 }
 
 void ColumnString::Clear() {
     items_.clear();
-    blocks_.clear();
-    append_data_.clear();
+    ResetStorage();
 }
 
 std::string_view ColumnString::At(size_t n) const {
@@ -249,8 +368,9 @@ void ColumnString::Append(ColumnRef column) {
         const auto total_size = ComputeTotalSize(col->items_);
 
         // TODO: fill up existing block with some items and then add a new one for the rest of items
-        if (blocks_.size() == 0 || blocks_.back().GetAvailable() < total_size)
-            blocks_.emplace_back(std::max(DEFAULT_BLOCK_SIZE, total_size));
+        auto& blocks = MutableStorage().blocks;
+        if (blocks.size() == 0 || blocks.back().GetAvailable() < total_size)
+            blocks.emplace_back(std::max(DEFAULT_BLOCK_SIZE, total_size), memory_resource_);
 
         // Intentionally not doing items_.reserve() since that cripples performance.
         for (size_t i = 0; i < column->Size(); ++i) {
@@ -262,18 +382,19 @@ void ColumnString::Append(ColumnRef column) {
 bool ColumnString::LoadBody(InputStream* input, size_t rows) {
     if (rows == 0) {
         items_.clear();
-        blocks_.clear();
+        ResetStorage();
 
         return true;
     }
 
-    decltype(items_) new_items;
-    decltype(blocks_) new_blocks;
+    std::vector<std::string_view> new_items;
+    auto new_storage = std::make_shared<Storage>();
+    auto& new_blocks = new_storage->blocks;
 
     new_items.reserve(rows);
 
     // Suboptimzal if the first row string is >DEFAULT_BLOCK_SIZE, but that must be a very rare case.
-    Block * block = &new_blocks.emplace_back(DEFAULT_BLOCK_SIZE);
+    Block * block = &new_blocks.emplace_back(DEFAULT_BLOCK_SIZE, memory_resource_);
 
     for (size_t i = 0; i < rows; ++i) {
         uint64_t len;
@@ -281,7 +402,7 @@ bool ColumnString::LoadBody(InputStream* input, size_t rows) {
             return false;
 
         if (len > block->GetAvailable())
-            block = &new_blocks.emplace_back(std::max<size_t>(DEFAULT_BLOCK_SIZE, len));
+            block = &new_blocks.emplace_back(std::max<size_t>(DEFAULT_BLOCK_SIZE, len), memory_resource_);
 
         if (!WireFormat::ReadBytes(*input, block->GetCurrentWritePos(), len))
             return false;
@@ -289,8 +410,9 @@ bool ColumnString::LoadBody(InputStream* input, size_t rows) {
         new_items.emplace_back(block->ConsumeTailAsStringViewUnsafe(len));
     }
 
-    items_.swap(new_items);
-    blocks_.swap(new_blocks);
+    items_ = CowData<std::vector<std::string_view>>(std::move(new_items));
+    storage_ = std::move(new_storage);
+    shared_storage_.clear();
 
     return true;
 }
@@ -305,14 +427,41 @@ size_t ColumnString::Size() const {
     return items_.size();
 }
 
+size_t ColumnString::ByteSize() const {
+    size_t result = items_.size() * sizeof(uint64_t);
+    for (const auto& item : items_) {
+        result += item.size();
+    }
+    return result;
+}
+
+size_t ColumnString::AllocatedBytes() const {
+    const auto storage_bytes = [] (const Storage& storage) {
+        size_t result = storage.blocks.capacity() * sizeof(Block);
+        for (const auto& block : storage.blocks) {
+            result += block.capacity;
+        }
+        for (const auto& str : storage.append_data) {
+            result += sizeof(std::string) + str.capacity();
+        }
+        return result;
+    };
+
+    size_t result = items_.capacity() * sizeof(std::string_view) + storage_bytes(*storage_);
+    for (const auto& storage : shared_storage_) {
+        result += storage_bytes(*storage);
+    }
+    return result;
+}
+
 ColumnRef ColumnString::Slice(size_t begin, size_t len) const {
-    auto result = std::make_shared<ColumnString>();
+    auto result = std::make_shared<ColumnString>(memory_resource_);
 
     if (begin < items_.size()) {
         len = std::min(len, items_.size() - begin);
-        result->items_.reserve(len);
+        result->items_.Mutable().reserve(len);
 
-        result->blocks_.emplace_back(ComputeTotalSize(items_, begin, len));
+        result->storage_->blocks.emplace_back(ComputeTotalSize(items_, begin, len), memory_resource_);
         for (size_t i = begin; i < begin + len; ++i) {
             result->Append(items_[i]);
         }
@@ -321,15 +470,62 @@ ColumnRef ColumnString::Slice(size_t begin, size_t len) const {
     return result;
 }
 
+ColumnRef ColumnString::SliceShared(size_t begin, size_t len) const {
+    auto result = std::make_shared<ColumnString>(memory_resource_);
+
+    if (begin < items_.size()) {
+        result->items_ = items_.Slice(begin, len);
+        // The storage is shared from now on, so it isn't appended to anymore, see MutableStorage().
+        result->shared_storage_ = shared_storage_;
+        result->shared_storage_.push_back(storage_);
+    }
+
+    return result;
+}
+
+ColumnRef ColumnString::Filter(Span<const uint8_t> mask) const {
+    CheckFilterMask(mask);
+
+    std::vector<size_t> indices;
+    indices.reserve(mask.size());
+    for (size_t i = 0; i < mask.size(); ++i) {
+        if (mask[i]) {
+            indices.push_back(i);
+        }
+    }
+
+    return Gather(indices);
+}
+
+ColumnRef ColumnString::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+
+    // All the values are copied into a single block.
+    size_t total_size = 0;
+    for (const auto index : indices) {
+        total_size += items_[index].size();
+    }
+
+    auto result = std::make_shared<ColumnString>(memory_resource_);
+    result->items_.Mutable().reserve(indices.size());
+    result->storage_->blocks.emplace_back(total_size, memory_resource_);
+    for (const auto index : indices) {
+        result->AppendUnsafe(items_[index]);
+    }
+
+    return result;
+}
+
 ColumnRef ColumnString::CloneEmpty() const {
-    return std::make_shared<ColumnString>();
+    return std::make_shared<ColumnString>(memory_resource_);
 }
 
 void ColumnString::Swap(Column& other) {
     auto & col = dynamic_cast<ColumnString &>(other);
+    memory_resource_.swap(col.memory_resource_);
     items_.swap(col.items_);
-    blocks_.swap(col.blocks_);
-    append_data_.swap(col.append_data_);
+    storage_.swap(col.storage_);
+    shared_storage_.swap(col.shared_storage_);
 }
 
 ItemView ColumnString::GetItem(size_t index) const {
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "column.h"
+#include "cow_data.h"
+#include "../base/memory_resource.h"
 
 #include <string>
 #include <string_view>
@@ -33,6 +35,11 @@ public:
     /// Appends one element to the column.
     void Append(std::string_view str);
 
+    /// Appends `count` values of `stride` bytes each stored contiguously at `data`, which must not point into
+    /// the column. Values shorter than FixedSize() are padded with zeroes, throws ValidationError if `stride`
+    /// is greater than FixedSize().
+    void AppendFixedStrings(const char* data, size_t count, size_t stride);
+
     /// Returns element at given row number.
     std::string_view At(size_t n) const;
 
@@ -42,6 +49,9 @@ public:
     /// Returns the max size of the fixed string
     size_t FixedSize() const;
 
+    /// Read-only view of the values, FixedSize() bytes each, invalidated once the column is modified.
+    inline Span<const char> RawData() const { return {data_.data(), data_.size()}; }
+
 public:
     /// Appends content of given column to the end of current one.
     void Append(ColumnRef column) override;
@@ -58,8 +68,15 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Filter(Span<const uint8_t> mask) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
@@ -67,7 +84,7 @@ public:
 
 private:
     size_t string_size_;
-    std::string data_;
+    CowData<std::string> data_;
 };
 
 /**
@@ -82,6 +99,9 @@ public:
     ~ColumnString();
 
     explicit ColumnString(size_t element_count);
+    /// Character data is allocated from `memory_resource`, the heap is used if it is null.
+    /// Columns made with Slice(), SliceShared() and CloneEmpty() use the same resource.
+    explicit ColumnString(std::shared_ptr<MemoryResource> memory_resource);
     explicit ColumnString(const std::vector<std::string> & data);
     explicit ColumnString(std::vector<std::string>&& data);
     ColumnString& operator=(const ColumnString&) = delete;
@@ -109,6 +129,9 @@ public:
     /// Returns element at given row number.
     inline std::string_view operator [] (size_t n) const { return At(n); }
 
+    /// Resource character data is allocated from, null for the heap.
+    const std::shared_ptr<MemoryResource>& GetMemoryResource() const { return memory_resource_; }
+
 public:
     /// Appends content of given column to the end of current one.
     void Append(ColumnRef column) override;
@@ -125,21 +148,37 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    /// Makes slice of the current column, which references the same character data instead of copying it.
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Filter(Span<const uint8_t> mask) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
     ItemView GetItem(size_t) const override;
 
 private:
+    struct Block;
+    struct Storage;
+
+    /// Storage to append strings to. Storage shared with slices isn't modified, a new one is started instead.
+    Storage& MutableStorage();
+    void ResetStorage();
     void AppendUnsafe(std::string_view);
 
 private:
-    struct Block;
-
-    std::vector<std::string_view> items_;
-    std::vector<Block> blocks_;
-    std::deque<std::string> append_data_;
+    std::shared_ptr<MemoryResource> memory_resource_;
+    CowData<std::vector<std::string_view>> items_;
+    /// Character data of the strings appended to the column.
+    std::shared_ptr<Storage> storage_;
+    /// Character data referenced by the column, but not appended to it anymore: storage of columns the column
+    /// is a slice of, and own storage which was shared with slices.
+    std::vector<std::shared_ptr<const Storage>> shared_storage_;
 };
 
 }
@@ -55,11 +55,29 @@ size_t ColumnTime::Size() const {
     return data_->Size();
 }
 
+size_t ColumnTime::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnTime::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnTime::Slice(size_t begin, size_t len) const {
     auto sliced_data = data_->Slice(begin, len)->As<ColumnInt32>();
     return ColumnRef{new ColumnTime(type_, sliced_data)};
 }
 
+ColumnRef ColumnTime::SliceShared(size_t begin, size_t len) const {
+    auto sliced_data = data_->SliceShared(begin, len)->As<ColumnInt32>();
+    return ColumnRef{new ColumnTime(type_, sliced_data)};
+}
+
+ColumnRef ColumnTime::Gather(Span<const size_t> indices) const {
+    auto gathered_data = data_->Gather(indices)->As<ColumnInt32>();
+    return ColumnRef{new ColumnTime(type_, gathered_data)};
+}
+
 ColumnRef ColumnTime::CloneEmpty() const {
     return ColumnRef{new ColumnTime(type_, data_->CloneEmpty()->As<ColumnInt32>())};
 }
@@ -129,11 +147,29 @@ size_t ColumnTime64::Size() const {
     return data_->Size();
 }
 
+size_t ColumnTime64::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnTime64::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnTime64::Slice(size_t begin, size_t len) const {
     auto sliced_data = data_->Slice(begin, len)->As<ColumnInt64>();
     return ColumnRef{new ColumnTime64(type_, sliced_data)};
 }
 
+ColumnRef ColumnTime64::SliceShared(size_t begin, size_t len) const {
+    auto sliced_data = data_->SliceShared(begin, len)->As<ColumnInt64>();
+    return ColumnRef{new ColumnTime64(type_, sliced_data)};
+}
+
+ColumnRef ColumnTime64::Gather(Span<const size_t> indices) const {
+    auto gathered_data = data_->Gather(indices)->As<ColumnInt64>();
+    return ColumnRef{new ColumnTime64(type_, gathered_data)};
+}
+
 ColumnRef ColumnTime64::CloneEmpty() const {
     return ColumnRef{new ColumnTime64(type_, data_->CloneEmpty()->As<ColumnInt64>())};
 }
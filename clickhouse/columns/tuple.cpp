@@ -76,6 +76,22 @@ size_t ColumnTuple::Size() const {
     return columns_.empty() ? 0 : columns_[0]->Size();
 }
 
+size_t ColumnTuple::ByteSize() const {
+    size_t result = 0;
+    for (const auto& column : columns_) {
+        result += column->ByteSize();
+    }
+    return result;
+}
+
+size_t ColumnTuple::AllocatedBytes() const {
+    size_t result = 0;
+    for (const auto& column : columns_) {
+        result += column->AllocatedBytes();
+    }
+    return result;
+}
+
 ColumnRef ColumnTuple::Slice(size_t begin, size_t len) const {
     std::vector<ColumnRef> sliced_columns;
     sliced_columns.reserve(columns_.size());
@@ -90,6 +106,36 @@ ColumnRef ColumnTuple::Slice(size_t begin, size_t len) const {
     return std::make_shared<ColumnTuple>(sliced_columns, names);
 }
 
+ColumnRef ColumnTuple::SliceShared(size_t begin, size_t len) const {
+    std::vector<ColumnRef> sliced_columns;
+    sliced_columns.reserve(columns_.size());
+    for(const auto &column : columns_) {
+        sliced_columns.push_back(column->SliceShared(begin, len));
+    }
+
+    const auto& names = this->Type()->As<TupleType>()->GetItemNames();
+    if (names.empty()) {
+        return std::make_shared<ColumnTuple>(sliced_columns);
+    }
+    return std::make_shared<ColumnTuple>(sliced_columns, names);
+}
+
+ColumnRef ColumnTuple::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+
+    std::vector<ColumnRef> gathered_columns;
+    gathered_columns.reserve(columns_.size());
+    for(const auto &column : columns_) {
+        gathered_columns.push_back(column->Gather(indices));
+    }
+
+    const auto& names = this->Type()->As<TupleType>()->GetItemNames();
+    if (names.empty()) {
+        return std::make_shared<ColumnTuple>(gathered_columns);
+    }
+    return std::make_shared<ColumnTuple>(gathered_columns, names);
+}
+
 ColumnRef ColumnTuple::CloneEmpty() const {
     std::vector<ColumnRef> result_columns;
     result_columns.reserve(columns_.size());
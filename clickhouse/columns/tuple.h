@@ -52,8 +52,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t, size_t) const override;
+    ColumnRef SliceShared(size_t, size_t) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
@@ -148,6 +154,14 @@ public:
         return Wrap(ColumnTuple::Slice(begin, size));
     }
 
+    ColumnRef SliceShared(size_t begin, size_t size) const override {
+        return Wrap(ColumnTuple::SliceShared(begin, size));
+    }
+
+    ColumnRef Gather(Span<const size_t> indices) const override {
+        return Wrap(ColumnTuple::Gather(indices));
+    }
+
     ColumnRef CloneEmpty() const override { return Wrap(ColumnTuple::CloneEmpty()); }
 
     void Swap(Column& other) override {
@@ -55,10 +55,35 @@ size_t ColumnUUID::Size() const {
     return data_->Size() / 2;
 }
 
+size_t ColumnUUID::ByteSize() const {
+    return data_->ByteSize();
+}
+
+size_t ColumnUUID::AllocatedBytes() const {
+    return data_->AllocatedBytes();
+}
+
 ColumnRef ColumnUUID::Slice(size_t begin, size_t len) const {
     return std::make_shared<ColumnUUID>(data_->Slice(begin * 2, len * 2));
 }
 
+ColumnRef ColumnUUID::SliceShared(size_t begin, size_t len) const {
+    return std::make_shared<ColumnUUID>(data_->SliceShared(begin * 2, len * 2));
+}
+
+ColumnRef ColumnUUID::Gather(Span<const size_t> indices) const {
+    CheckGatherIndices(indices);
+
+    // Each value is two UInt64 halves.
+    std::vector<size_t> halves;
+    halves.reserve(indices.size() * 2);
+    for (const auto index : indices) {
+        halves.push_back(index * 2);
+        halves.push_back(index * 2 + 1);
+    }
+    return std::make_shared<ColumnUUID>(data_->Gather(halves));
+}
+
 ColumnRef ColumnUUID::CloneEmpty() const {
     return std::make_shared<ColumnUUID>();
 }
@@ -27,6 +27,10 @@ public:
     /// Returns element at given row number.
     inline const UUID operator [] (size_t n) const { return At(n); }
 
+    /// Read-only view of the values, two halves per row: RawData()[2 * n] is At(n).first
+    /// and RawData()[2 * n + 1] is At(n).second. Invalidated once the column is modified.
+    inline Span<const uint64_t> RawData() const { return data_->RawData(); }
+
 public:
     /// Increase the capacity of the column for large block insertion.
     void Reserve(size_t new_cap) override;
@@ -46,8 +50,14 @@ public:
     /// Returns count of rows in the column.
     size_t Size() const override;
 
+    /// Returns count of bytes of the column values and of memory held by the column.
+    size_t ByteSize() const override;
+    size_t AllocatedBytes() const override;
+
     /// Makes slice of the current column.
     ColumnRef Slice(size_t begin, size_t len) const override;
+    ColumnRef SliceShared(size_t begin, size_t len) const override;
+    ColumnRef Gather(Span<const size_t> indices) const override;
     ColumnRef CloneEmpty() const override;
     void Swap(Column& other) override;
 
@@ -0,0 +1,177 @@
+#include "profile_events.h"
+#include "exceptions.h"
+
+#include "columns/itemview.h"
+
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace clickhouse {
+
+namespace {
+
+/// Process-wide pool of event and host names, a few hundred names at most.
+class NamePool {
+public:
+    struct Entry {
+        uint32_t id;
+        std::string_view name;
+    };
+
+    static NamePool& Instance() {
+        static NamePool pool;
+        return pool;
+    }
+
+    Entry Intern(std::string_view name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = ids_.find(name);
+        if (it != ids_.end()) {
+            return {it->second, it->first};
+        }
+
+        // Elements of std::deque are not moved on insertion at the end.
+        const std::string_view stored = names_.emplace_back(name);
+        const auto id = static_cast<uint32_t>(names_.size() - 1);
+        ids_.emplace(stored, id);
+        return {id, stored};
+    }
+
+    std::optional<uint32_t> Find(std::string_view name) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        auto it = ids_.find(name);
+        if (it == ids_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+ColumnRef FindColumn(const Block& block, const char* name) {
+    for (size_t i = 0; i < block.GetColumnCount(); ++i) {
+        if (block.GetColumnName(i) == name) {
+            return block[i];
+        }
+    }
+    throw ValidationError(std::string("ProfileEvents block has no column ") + name);
+}
+
+/// Reads integer value of any width, so the code does not depend on exact types of the columns.
+int64_t GetInteger(const ItemView& item) {
+    switch (item.data.size()) {
+        case 1: return item.get<int8_t>();
+        case 2: return item.get<int16_t>();
+        case 4: return item.get<int32_t>();
+        case 8: {
+            int64_t value;
+            std::memcpy(&value, item.data.data(), sizeof(value));
+            return value;
+        }
+    }
+    throw ValidationError("unexpected size of ProfileEvents value: " + std::to_string(item.data.size()));
+}
+
+}
+
+size_t ProfileEventsSnapshot::KeyHash::operator()(const Key& key) const {
+    return std::hash<uint64_t>()(((uint64_t(key.host) << 32) | key.name) ^ (key.thread_id * 0x9E3779B97F4A7C15ULL));
+}
+
+void ProfileEventsSnapshot::Append(const Block& block) {
+    const size_t rows = block.GetRowCount();
+    if (rows == 0) {
+        return;
+    }
+
+    const auto host_names = FindColumn(block, "host_name");
+    const auto thread_ids = FindColumn(block, "thread_id");
+    const auto types = FindColumn(block, "type");
+    const auto names = FindColumn(block, "name");
+    const auto values = FindColumn(block, "value");
+
+    auto& pool = NamePool::Instance();
+    // Rows of a block usually come from the same host.
+    std::string_view last_host_name;
+    NamePool::Entry host{0, {}};
+
+    for (size_t i = 0; i < rows; ++i) {
+        const auto host_name = host_names->GetItem(i).get<std::string_view>();
+        if (i == 0 || host_name != last_host_name) {
+            host = pool.Intern(host_name);
+            last_host_name = host_name;
+        }
+        const auto name = pool.Intern(names->GetItem(i).get<std::string_view>());
+        const auto thread_id = static_cast<uint64_t>(GetInteger(thread_ids->GetItem(i)));
+        const auto type = GetInteger(types->GetItem(i)) == static_cast<int64_t>(Type::Gauge) ? Type::Gauge : Type::Increment;
+        const int64_t value = GetInteger(values->GetItem(i));
+
+        if (totals_.size() <= name.id) {
+            totals_.resize(name.id + 1);
+        }
+        Counter& total = totals_[name.id];
+        total.name = name.name;
+        total.type = type;
+
+        auto [it, inserted] = counters_.try_emplace(Key{host.id, name.id, thread_id});
+        Counter& counter = it->second;
+        if (inserted) {
+            counter.host = host.name;
+            counter.thread_id = thread_id;
+            counter.name = name.name;
+        }
+        counter.type = type;
+
+        if (type == Type::Gauge) {
+            total.value += value - counter.value;
+            counter.value = value;
+        } else {
+            total.value += value;
+            counter.value += value;
+        }
+    }
+}
+
+int64_t ProfileEventsSnapshot::Get(std::string_view name) const {
+    const auto id = NamePool::Instance().Find(name);
+    if (!id || *id >= totals_.size()) {
+        return 0;
+    }
+    return totals_[*id].value;
+}
+
+std::vector<ProfileEventsSnapshot::Counter> ProfileEventsSnapshot::Counters() const {
+    std::vector<Counter> result;
+    result.reserve(counters_.size());
+    for (const auto& [key, counter] : counters_) {
+        result.push_back(counter);
+    }
+    return result;
+}
+
+std::vector<ProfileEventsSnapshot::Counter> ProfileEventsSnapshot::Totals() const {
+    std::vector<Counter> result;
+    for (const auto& total : totals_) {
+        // Slots of names interned by other snapshots.
+        if (!total.name.empty()) {
+            result.push_back(total);
+        }
+    }
+    return result;
+}
+
+void ProfileEventsSnapshot::Clear() {
+    counters_.clear();
+    totals_.clear();
+}
+
+}
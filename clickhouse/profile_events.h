@@ -0,0 +1,69 @@
+#pragma once
+
+#include "block.h"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace clickhouse {
+
+/** Server-side counters of a query decoded from ProfileEvents packets, see Query::OnProfileEventsSnapshot().
+ *
+ *  Each packet carries events of the query per host and thread: increments since the previous packet
+ *  and current values of gauges. Increments are summed and gauges keep the latest value.
+ *
+ *  Names of events and hosts are interned process-wide, views on them are valid for the lifetime of the program.
+ */
+class ProfileEventsSnapshot {
+public:
+    enum class Type : int8_t {
+        Increment = 1,
+        Gauge = 2,
+    };
+
+    struct Counter {
+        std::string_view host;
+        uint64_t thread_id = 0;
+        std::string_view name;
+        Type type = Type::Increment;
+        int64_t value = 0;
+    };
+
+    /// Adds events of a ProfileEvents block.
+    void Append(const Block& block);
+
+    /// Value of the event summed over all the hosts and threads, 0 if there was no such event.
+    int64_t Get(std::string_view name) const;
+
+    /// Values of events per host and thread.
+    std::vector<Counter> Counters() const;
+    /// Values of events summed over all the hosts and threads, `host` and `thread_id` are empty.
+    std::vector<Counter> Totals() const;
+
+    bool Empty() const { return counters_.empty(); }
+    void Clear();
+
+private:
+    struct Key {
+        uint32_t host;
+        uint32_t name;
+        uint64_t thread_id;
+
+        bool operator==(const Key& other) const {
+            return host == other.host && name == other.name && thread_id == other.thread_id;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+private:
+    std::unordered_map<Key, Counter, KeyHash> counters_;
+    /// Indexed by id of the interned name.
+    std::vector<Counter> totals_;
+};
+
+}
@@ -22,4 +22,30 @@ Query::Query(const std::string& query, const std::string& query_id)
 Query::~Query()
 { }
 
+ClientStats& ClientStats::operator-=(const ClientStats& other) {
+    queries -= other.queries;
+    bytes_sent -= other.bytes_sent;
+    bytes_received -= other.bytes_received;
+    send_calls -= other.send_calls;
+    recv_calls -= other.recv_calls;
+    compressed_bytes_sent -= other.compressed_bytes_sent;
+    uncompressed_bytes_sent -= other.uncompressed_bytes_sent;
+    compressed_bytes_received -= other.compressed_bytes_received;
+    uncompressed_bytes_received -= other.uncompressed_bytes_received;
+    for (size_t i = 0; i < packets_received.size(); ++i) {
+        packets_received[i] -= other.packets_received[i];
+    }
+    network_send_ns -= other.network_send_ns;
+    network_receive_ns -= other.network_receive_ns;
+    compression_ns -= other.compression_ns;
+    decompression_ns -= other.decompression_ns;
+    column_load_ns -= other.column_load_ns;
+    callbacks_ns -= other.callbacks_ns;
+    return *this;
+}
+
+ClientStats operator-(ClientStats lhs, const ClientStats& rhs) {
+    return lhs -= rhs;
+}
+
 }
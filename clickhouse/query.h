@@ -1,10 +1,12 @@
 #pragma once
 
 #include "block.h"
+#include "profile_events.h"
 #include "server_exception.h"
 
 #include "base/open_telemetry.h"
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -39,12 +41,67 @@ struct Profile {
 };
 
 
+/// Increments of the query progress since the previous Progress packet.
 struct Progress {
     uint64_t rows = 0;
     uint64_t bytes = 0;
     uint64_t total_rows = 0;
+    /// Estimation of the total bytes to read, set by servers supporting protocol revision 54463 or later.
+    uint64_t total_bytes = 0;
     uint64_t written_rows = 0;
     uint64_t written_bytes = 0;
+    /// Time of the query execution on the server, set by servers supporting protocol revision 54460 or later.
+    uint64_t elapsed_ns = 0;
+};
+
+
+/** Counters of the work done by a client, see Client::GetStats().
+ *
+ *  Byte and syscall counters are not collected for sockets which do their own buffering (io_uring).
+ */
+struct ClientStats {
+    uint64_t queries = 0;
+
+    /// Bytes passed to and from the socket.
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+    /// Number of the socket write and read calls.
+    uint64_t send_calls = 0;
+    uint64_t recv_calls = 0;
+
+    /// Size of compressed blocks on the wire and the size of the same data uncompressed.
+    uint64_t compressed_bytes_sent = 0;
+    uint64_t uncompressed_bytes_sent = 0;
+    uint64_t compressed_bytes_received = 0;
+    uint64_t uncompressed_bytes_received = 0;
+
+    /// Number of received packets indexed by ServerCodes (see protocol.h).
+    std::array<uint64_t, 16> packets_received{};
+
+    /// Time spent waiting for the socket.
+    uint64_t network_send_ns = 0;
+    uint64_t network_receive_ns = 0;
+    uint64_t compression_ns = 0;
+    uint64_t decompression_ns = 0;
+    /// Time spent in Column::Load(), excluding the network and decompression time.
+    uint64_t column_load_ns = 0;
+    /// Time spent in the query callbacks.
+    uint64_t callbacks_ns = 0;
+
+    ClientStats& operator-=(const ClientStats& other);
+};
+
+ClientStats operator-(ClientStats lhs, const ClientStats& rhs);
+
+
+
+/// Kind of a block of the query result.
+enum class BlockKind : uint8_t {
+    Data,
+    /// Totals of GROUP BY ... WITH TOTALS.
+    Totals,
+    /// Min and max values of the columns, requested by the `extremes` setting.
+    Extremes,
 };
 
 
@@ -53,6 +110,9 @@ public:
     virtual ~QueryEvents()
     { }
 
+    /// Called when execution of the query starts, before it is sent to the server.
+    virtual void OnStart() { }
+
     /// Some data was received.
     virtual void OnData(const Block& block) = 0;
     virtual bool OnDataCancelable(const Block& block) = 0;
@@ -72,7 +132,18 @@ public:
     /// Handle query execution profile events.
     virtual void OnProfileEvents(const Block& block) = 0;
 
+    /// Totals of GROUP BY ... WITH TOTALS, received after all the data.
+    virtual void OnTotals(const Block& /*block*/) { }
+    /// Min and max values of the result columns if `extremes` setting is enabled.
+    virtual void OnExtremes(const Block& /*block*/) { }
+
     virtual void OnFinish() = 0;
+
+    /// Called on the end of the query with counters of the work done by the client for it,
+    /// calls OnFinish() by default.
+    virtual void OnFinishWithStats(const ClientStats& /*stats*/) {
+        OnFinish();
+    }
 };
 
 
@@ -83,6 +154,8 @@ using SelectCancelableCallback = std::function<bool(const Block& block)>;
 using SelectServerLogCallback  = std::function<bool(const Block& block)>;
 using ProfileEventsCallback    = std::function<bool(const Block& block)>;
 using ProfileCallback          = std::function<void(const Profile& profile)>;
+using FinishCallback           = std::function<void(const ClientStats& stats)>;
+using ProfileEventsSnapshotCallback = std::function<void(const ProfileEventsSnapshot& snapshot)>;
 
 
 class Query : public QueryEvents {
@@ -162,6 +235,18 @@ public:
         return *this;
     }
 
+    /// Set handler for receiving totals of GROUP BY ... WITH TOTALS.
+    inline Query& OnTotals(SelectCallback cb) {
+        totals_cb_ = std::move(cb);
+        return *this;
+    }
+
+    /// Set handler for receiving extremes (min and max values) of the result, see `extremes` setting.
+    inline Query& OnExtremes(SelectCallback cb) {
+        extremes_cb_ = std::move(cb);
+        return *this;
+    }
+
     /// Set handler for receiving a server log of query exceution.
     inline Query& OnServerLog(SelectServerLogCallback cb) {
         select_server_log_cb_ = std::move(cb);
@@ -174,15 +259,28 @@ public:
         return *this;
     }
 
+    /// Set handler receiving profile events of the query decoded and aggregated, called on the end of the query.
+    inline Query& OnProfileEventsSnapshot(ProfileEventsSnapshotCallback cb) {
+        profile_events_snapshot_cb_ = std::move(cb);
+        return *this;
+    }
+
     inline Query& OnProfile(ProfileCallback cb) {
         profile_callback_cb_ = std::move(cb);
         return *this;
     }
 
+    /// Set handler called on the end of the query with counters of the work done by the client for it.
+    inline Query& OnFinish(FinishCallback cb) {
+        finish_cb_ = std::move(cb);
+        return *this;
+    }
+
     /// True if any server-event handler is installed.
     inline bool HasEventCallbacks() const {
         return exception_cb_ || progress_cb_ || select_cb_ || select_cancelable_cb_
-            || select_server_log_cb_ || profile_events_callback_cb_ || profile_callback_cb_;
+            || select_server_log_cb_ || profile_events_callback_cb_ || profile_callback_cb_ || finish_cb_
+            || profile_events_snapshot_cb_ || totals_cb_ || extremes_cb_;
     }
 
     static const std::string default_query_id;
@@ -202,6 +300,11 @@ private:
         }
     }
 
+    void OnStart() override {
+        // Events of a previous execution, which might have failed before OnFinishWithStats().
+        profile_events_snapshot_.Clear();
+    }
+
     void OnServerException(const Exception& e) override {
         if (exception_cb_) {
             exception_cb_(e);
@@ -219,6 +322,18 @@ private:
         }
     }
 
+    void OnTotals(const Block& block) override {
+        if (totals_cb_) {
+            totals_cb_(block);
+        }
+    }
+
+    void OnExtremes(const Block& block) override {
+        if (extremes_cb_) {
+            extremes_cb_(block);
+        }
+    }
+
     void OnServerLog(const Block& block) override {
         if (select_server_log_cb_) {
             select_server_log_cb_(block);
@@ -229,11 +344,24 @@ private:
         if (profile_events_callback_cb_) {
             profile_events_callback_cb_(block);
         }
+        if (profile_events_snapshot_cb_) {
+            profile_events_snapshot_.Append(block);
+        }
     }
 
     void OnFinish() override {
     }
 
+    void OnFinishWithStats(const ClientStats& stats) override {
+        if (profile_events_snapshot_cb_) {
+            profile_events_snapshot_cb_(profile_events_snapshot_);
+            profile_events_snapshot_.Clear();
+        }
+        if (finish_cb_) {
+            finish_cb_(stats);
+        }
+    }
+
 private:
     std::string query_;
     std::string query_id_;
@@ -244,9 +372,14 @@ private:
     ProgressCallback progress_cb_;
     SelectCallback select_cb_;
     SelectCancelableCallback select_cancelable_cb_;
+    SelectCallback totals_cb_;
+    SelectCallback extremes_cb_;
     SelectServerLogCallback select_server_log_cb_;
     ProfileEventsCallback profile_events_callback_cb_;
     ProfileCallback profile_callback_cb_;
+    FinishCallback finish_cb_;
+    ProfileEventsSnapshotCallback profile_events_snapshot_cb_;
+    ProfileEventsSnapshot profile_events_snapshot_;
 };
 
 }
@@ -0,0 +1,224 @@
+#include "result_cache.h"
+
+#include "base/output.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+namespace clickhouse {
+
+namespace {
+
+class CountingOutput : public OutputStream {
+public:
+    size_t bytes = 0;
+
+protected:
+    size_t DoWrite(const void* /*data*/, size_t len) override {
+        bytes += len;
+        return len;
+    }
+};
+
+size_t EstimateBytes(const QueryResultCache::Blocks& blocks) {
+    CountingOutput output;
+    for (const auto& block : blocks) {
+        for (size_t i = 0; i < block.GetColumnCount(); ++i) {
+            block[i]->Save(&output);
+            output.bytes += block.GetColumnName(i).size();
+        }
+    }
+    return output.bytes;
+}
+
+/// Collapses whitespace outside of quotes and strips trailing semicolons.
+std::string NormalizeQuery(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+
+    char quote = 0;
+    bool space = false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const char c = text[i];
+        if (quote) {
+            result += c;
+            if (c == '\\' && i + 1 < text.size()) {
+                result += text[++i];
+            } else if (c == quote) {
+                quote = 0;
+            }
+            continue;
+        }
+
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            space = !result.empty();
+            continue;
+        }
+        if (space) {
+            result += ' ';
+            space = false;
+        }
+        if (c == '\'' || c == '"' || c == '`') {
+            quote = c;
+        }
+        result += c;
+    }
+
+    while (!result.empty() && (result.back() == ';' || result.back() == ' ')) {
+        result.pop_back();
+    }
+    return result;
+}
+
+bool StartsWithKeyword(const std::string& text, const char* keyword) {
+    size_t i = 0;
+    for (; keyword[i]; ++i) {
+        if (i >= text.size() || std::toupper(static_cast<unsigned char>(text[i])) != keyword[i]) {
+            return false;
+        }
+    }
+    return i == text.size() || !std::isalnum(static_cast<unsigned char>(text[i]));
+}
+
+void AppendField(std::string& key, const std::string& value) {
+    key += std::to_string(value.size());
+    key += ':';
+    key += value;
+}
+
+}
+
+QueryResultCache::QueryResultCache(QueryResultCacheParams params)
+    : params_(std::move(params))
+{
+}
+
+QueryResultCache::~QueryResultCache() = default;
+
+std::shared_ptr<const QueryResultCache::Blocks> QueryResultCache::Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    if (it->second->expires_at <= Clock::now()) {
+        erase(it->second);
+        ++misses_;
+        return nullptr;
+    }
+
+    entries_.splice(entries_.begin(), entries_, it->second);
+    ++hits_;
+    const auto& cached = *it->second->blocks;
+    auto blocks = std::make_shared<Blocks>();
+    blocks->reserve(cached.size());
+    for (const auto& block : cached) {
+        blocks->push_back(CopyBlock(block));
+    }
+    return blocks;
+}
+
+void QueryResultCache::Put(const std::string& key, Blocks blocks) {
+    for (auto& block : blocks) {
+        block = CopyBlock(block);
+    }
+    const size_t bytes = EstimateBytes(blocks);
+    if (bytes > params_.max_entry_bytes || bytes > params_.max_bytes) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        erase(it->second);
+    }
+    while (!entries_.empty() && bytes_ + bytes > params_.max_bytes) {
+        erase(std::prev(entries_.end()));
+    }
+
+    entries_.push_front(Entry{key, std::make_shared<const Blocks>(std::move(blocks)), bytes, Clock::now() + params_.ttl});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+}
+
+size_t QueryResultCache::Hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t QueryResultCache::Misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t QueryResultCache::Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t QueryResultCache::Bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+void QueryResultCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+bool QueryResultCache::IsCacheable(const Query& query) {
+    const std::string text = NormalizeQuery(query.GetText());
+    return StartsWithKeyword(text, "SELECT") || StartsWithKeyword(text, "WITH");
+}
+
+std::string QueryResultCache::MakeKey(const Query& query, const std::string& server, const std::string& database, const std::string& user) {
+    std::string key;
+    AppendField(key, server);
+    AppendField(key, NormalizeQuery(query.GetText()));
+    AppendField(key, database);
+    AppendField(key, user);
+
+    // Settings and parameters are unordered maps, sort them to have the same key regardless of the order.
+    std::map<std::string, std::string> settings;
+    for (const auto& [name, field] : query.GetQuerySettings()) {
+        settings[name] = field.value;
+    }
+    for (const auto& [name, value] : settings) {
+        AppendField(key, name);
+        AppendField(key, value);
+    }
+
+    key += '|';
+    std::map<std::string, QueryParamValue> params(query.GetParams().begin(), query.GetParams().end());
+    for (const auto& [name, value] : params) {
+        AppendField(key, name);
+        // NULL differs from any string value.
+        key += value ? '=' : 'N';
+        AppendField(key, value.value_or(std::string()));
+    }
+
+    return key;
+}
+
+Block QueryResultCache::CopyBlock(const Block& block) {
+    Block copy(block.GetColumnCount(), block.GetRowCount());
+    copy.SetInfo(block.Info());
+    for (size_t i = 0; i < block.GetColumnCount(); ++i) {
+        copy.AppendColumn(block.GetColumnName(i), block[i]->SliceShared(0, block[i]->Size()));
+    }
+    return copy;
+}
+
+void QueryResultCache::erase(Entries::iterator it) {
+    bytes_ -= it->bytes;
+    index_.erase(it->key);
+    entries_.erase(it);
+}
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "block.h"
+#include "query.h"
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace clickhouse {
+
+struct QueryResultCacheParams {
+    /// Max total size of the cached blocks (as serialized by the protocol), least recently used results are evicted.
+    size_t max_bytes = 64 * 1024 * 1024;
+    /// Results larger than this are not cached.
+    size_t max_entry_bytes = 1024 * 1024;
+    /// How long results are served from the cache.
+    std::chrono::milliseconds ttl{ 1000 };
+};
+
+/** In-memory cache of SELECT results, see ClientOptions::result_cache.
+ *
+ *  Results are keyed by server, normalized query text, settings and parameters of the query, database and user,
+ *  and may be shared by several clients, connected to the same or different servers.
+ *
+ *  The cache keeps its own copies of the blocks and returns new copies for every hit, so neither modification
+ *  of columns passed to Put() nor of ones returned by Get() affects the cached result. Copies share values
+ *  with each other until modified (see Column::SliceShared()), so copying is cheap.
+ */
+class QueryResultCache {
+public:
+    using Blocks = std::vector<Block>;
+
+    explicit QueryResultCache(QueryResultCacheParams params = {});
+    ~QueryResultCache();
+
+    /// Returns copy of the cached result or nullptr if there is no valid one.
+    std::shared_ptr<const Blocks> Get(const std::string& key);
+    void Put(const std::string& key, Blocks blocks);
+
+    size_t Hits() const;
+    size_t Misses() const;
+    /// Number of cached results.
+    size_t Size() const;
+    /// Total size of cached results.
+    size_t Bytes() const;
+    void Clear();
+
+    /// Returns true if result of the query may be cached: it is a SELECT (or WITH ... SELECT) query.
+    static bool IsCacheable(const Query& query);
+
+    /// Makes cache key of the query, text is normalized so queries differing only by whitespace
+    /// (outside of literals and quoted identifiers) or trailing semicolon have the same key.
+    /// `server` identifies the server the query is executed by, e.g. its host, port and display name.
+    static std::string MakeKey(const Query& query, const std::string& server, const std::string& database, const std::string& user);
+
+    /// Makes block with the same columns, which share values with the ones of `block` until either is modified.
+    static Block CopyBlock(const Block& block);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Blocks> blocks;
+        size_t bytes;
+        Clock::time_point expires_at;
+    };
+    using Entries = std::list<Entry>;
+
+    void erase(Entries::iterator it);
+
+private:
+    const QueryResultCacheParams params_;
+
+    mutable std::mutex mutex_;
+    /// Most recently used go first.
+    Entries entries_;
+    std::unordered_map<std::string, Entries::iterator> index_;
+    size_t bytes_ = 0;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+}
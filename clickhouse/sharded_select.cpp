@@ -0,0 +1,397 @@
+#include "sharded_select.h"
+#include "client.h"
+#include "exceptions.h"
+
+#include "columns/itemview.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace clickhouse {
+
+namespace {
+
+template <typename T>
+int Compare(const T& a, const T& b) {
+    return a < b ? -1 : (b < a ? 1 : 0);
+}
+
+template <typename T>
+T Load(std::string_view data) {
+    T value;
+    std::memcpy(&value, data.data(), sizeof(T));
+    return value;
+}
+
+int CompareSigned(std::string_view a, std::string_view b) {
+    switch (a.size()) {
+        case 1: return Compare(Load<int8_t>(a), Load<int8_t>(b));
+        case 2: return Compare(Load<int16_t>(a), Load<int16_t>(b));
+        case 4: return Compare(Load<int32_t>(a), Load<int32_t>(b));
+        case 8: return Compare(Load<int64_t>(a), Load<int64_t>(b));
+        case 16: return Compare(Load<Int128>(a), Load<Int128>(b));
+        case 32: return Compare(Load<Int256>(a), Load<Int256>(b));
+    }
+    return a.compare(b);
+}
+
+int CompareUnsigned(std::string_view a, std::string_view b) {
+    switch (a.size()) {
+        case 1: return Compare(Load<uint8_t>(a), Load<uint8_t>(b));
+        case 2: return Compare(Load<uint16_t>(a), Load<uint16_t>(b));
+        case 4: return Compare(Load<uint32_t>(a), Load<uint32_t>(b));
+        case 8: return Compare(Load<uint64_t>(a), Load<uint64_t>(b));
+        case 16: return Compare(Load<UInt128>(a), Load<UInt128>(b));
+        case 32: return Compare(Load<UInt256>(a), Load<UInt256>(b));
+    }
+    return a.compare(b);
+}
+
+/// Compares values the same way server does in ORDER BY, NULLs go last.
+int CompareItems(const ItemView& a, const ItemView& b) {
+    if (a.type == Type::Void || b.type == Type::Void) {
+        return Compare(a.type == Type::Void, b.type == Type::Void);
+    }
+    if (a.data.size() != b.data.size()) {
+        return a.data.compare(b.data);
+    }
+
+    switch (a.type) {
+        case Type::Int8:
+        case Type::Int16:
+        case Type::Int32:
+        case Type::Int64:
+        case Type::Int128:
+        case Type::Int256:
+        case Type::Enum8:
+        case Type::Enum16:
+        case Type::Date32:
+        case Type::DateTime64:
+        case Type::Decimal:
+        case Type::Decimal32:
+        case Type::Decimal64:
+        case Type::Decimal128:
+        case Type::Decimal256:
+        case Type::Time:
+        case Type::Time64:
+            return CompareSigned(a.data, b.data);
+        case Type::UInt8:
+        case Type::UInt16:
+        case Type::UInt32:
+        case Type::UInt64:
+        case Type::UInt128:
+        case Type::UInt256:
+        case Type::Bool:
+        case Type::Date:
+        case Type::DateTime:
+        case Type::IPv4:
+            return CompareUnsigned(a.data, b.data);
+        case Type::Float32:
+            return Compare(a.get<float>(), b.get<float>());
+        case Type::Float64:
+            return Compare(a.get<double>(), b.get<double>());
+        case Type::UUID: {
+            // Two UInt64 halves, the first one is the most significant.
+            const int first = CompareUnsigned(a.data.substr(0, 8), b.data.substr(0, 8));
+            return first ? first : CompareUnsigned(a.data.substr(8), b.data.substr(8));
+        }
+        default:
+            // Strings, FixedStrings and IPv6 (in network byte order) are compared as bytes.
+            return a.data.compare(b.data);
+    }
+}
+
+}
+
+ShardedSelect::ShardedSelect(const std::vector<Client*>& clients, const Query& query, ShardedSelectParams params)
+    : ShardedSelect(clients, std::vector<Query>(clients.size(), query), std::move(params))
+{
+}
+
+ShardedSelect::ShardedSelect(const std::vector<Client*>& clients, const std::vector<Query>& queries, ShardedSelectParams params)
+    : params_(std::move(params))
+{
+    if (clients.size() != queries.size()) {
+        throw ValidationError("number of queries doesn't match number of shards");
+    }
+
+    for (size_t i = 0; i < clients.size(); ++i) {
+        auto shard = std::make_unique<Shard>();
+        shard->client = clients[i];
+        shard->query = queries[i];
+        shards_.push_back(std::move(shard));
+    }
+
+    for (auto& shard : shards_) {
+        shard->thread = std::thread([this, &shard = *shard] { Run(shard); });
+    }
+}
+
+ShardedSelect::~ShardedSelect() {
+    Cancel();
+}
+
+std::optional<Block> ShardedSelect::Next() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        if (cancelled_) {
+            return std::nullopt;
+        }
+    }
+
+    return params_.sort_columns.empty() ? NextUnordered() : NextMerged();
+}
+
+void ShardedSelect::Cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        // A shard may wait for the server for as long as the query runs, the flag isn't checked meanwhile.
+        for (auto& shard : shards_) {
+            if (shard->reading) {
+                shard->client->Interrupt();
+                shard->interrupted = true;
+            }
+        }
+    }
+    changed_.notify_all();
+
+    for (auto& shard : shards_) {
+        if (shard->thread.joinable()) {
+            shard->thread.join();
+        }
+    }
+}
+
+void ShardedSelect::Run(Shard& shard) {
+    const size_t max_queued_blocks = std::max<size_t>(1, params_.max_queued_blocks);
+
+    try {
+        shard.client->BeginSelect(shard.query);
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                changed_.wait(lock, [&] {
+                    if (cancelled_ || shard.blocks.empty()) {
+                        return true;
+                    }
+                    return shard.blocks.size() < max_queued_blocks
+                        && (!params_.max_queued_bytes || queued_bytes_ < params_.max_queued_bytes);
+                });
+                if (cancelled_) {
+                    break;
+                }
+                shard.reading = true;
+            }
+
+            auto block = shard.client->NextBlock();
+            const bool has_rows = block && block->GetRowCount() > 0;
+            const size_t bytes = has_rows && params_.max_queued_bytes ? block->AllocatedBytes() : 0;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                shard.reading = false;
+                if (has_rows) {
+                    shard.blocks.push_back(std::move(*block));
+                    shard.blocks_bytes.push_back(bytes);
+                    queued_bytes_ += bytes;
+                }
+            }
+            if (!block) {
+                break;
+            }
+            changed_.notify_all();
+        }
+
+        if (shard.client->IsSelecting()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                shard.reading = true;
+            }
+            shard.client->Cancel();
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Errors caused by cancellation are not interesting.
+        if (!cancelled_) {
+            error_ = std::current_exception();
+            cancelled_ = true;
+        }
+    }
+
+    bool interrupted = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shard.reading = false;
+        interrupted = shard.interrupted;
+    }
+    if (interrupted) {
+        // The connection was shut down by Cancel(), reconnect so the client may be used again.
+        try {
+            shard.client->ResetConnection();
+        } catch (...) {
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shard.done = true;
+    }
+    changed_.notify_all();
+}
+
+Block ShardedSelect::PopBlock(Shard& shard) {
+    Block block = std::move(shard.blocks.front());
+    shard.blocks.pop_front();
+    queued_bytes_ -= shard.blocks_bytes.front();
+    shard.blocks_bytes.pop_front();
+    return block;
+}
+
+std::optional<Block> ShardedSelect::NextUnordered() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+
+        bool all_done = true;
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            // Take blocks from the shards in turn, so none of them is starved.
+            Shard& shard = *shards_[(next_shard_ + i) % shards_.size()];
+            if (!shard.blocks.empty()) {
+                Block block = PopBlock(shard);
+                next_shard_ = (next_shard_ + i + 1) % shards_.size();
+
+                lock.unlock();
+                changed_.notify_all();
+                return block;
+            }
+            all_done = all_done && shard.done;
+        }
+
+        if (all_done) {
+            return std::nullopt;
+        }
+        changed_.wait(lock);
+    }
+}
+
+bool ShardedSelect::Fetch(Shard& shard) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait(lock, [&] { return !shard.blocks.empty() || shard.done || error_; });
+
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    if (shard.blocks.empty()) {
+        shard.current.reset();
+        return false;
+    }
+
+    shard.current = PopBlock(shard);
+    shard.row = 0;
+
+    lock.unlock();
+    changed_.notify_all();
+    return true;
+}
+
+int ShardedSelect::CompareRows(const Shard& a, size_t a_row, const Shard& b, size_t b_row) {
+    for (size_t i = 0; i < a.key_columns.size(); ++i) {
+        const int result = CompareItems(
+            (*a.current)[a.key_columns[i]]->GetItem(a_row),
+            (*b.current)[b.key_columns[i]]->GetItem(b_row));
+        if (result) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+std::optional<Block> ShardedSelect::NextMerged() {
+    if (!merge_started_) {
+        merge_started_ = true;
+        for (auto& shard : shards_) {
+            if (!Fetch(*shard)) {
+                continue;
+            }
+            for (const auto& name : params_.sort_columns) {
+                size_t index = 0;
+                while (index < shard->current->GetColumnCount() && shard->current->GetColumnName(index) != name) {
+                    ++index;
+                }
+                if (index == shard->current->GetColumnCount()) {
+                    throw ValidationError("sort column " + name + " is not in the result");
+                }
+                shard->key_columns.push_back(index);
+            }
+        }
+    }
+
+    std::vector<ColumnRef> columns;
+    std::vector<std::string> names;
+    for (const auto& shard : shards_) {
+        if (shard->current) {
+            for (size_t i = 0; i < shard->current->GetColumnCount(); ++i) {
+                columns.push_back((*shard->current)[i]->CloneEmpty());
+                names.push_back(shard->current->GetColumnName(i));
+            }
+            break;
+        }
+    }
+    if (columns.empty()) {
+        return std::nullopt;
+    }
+
+    size_t rows = 0;
+    while (rows < params_.max_block_size) {
+        // Shards with the smallest and the second smallest current rows.
+        Shard* first = nullptr;
+        Shard* second = nullptr;
+        for (auto& shard : shards_) {
+            if (!shard->current) {
+                continue;
+            }
+            if (!first || CompareRows(*shard, shard->row, *first, first->row) < 0) {
+                second = first;
+                first = shard.get();
+            } else if (!second || CompareRows(*shard, shard->row, *second, second->row) < 0) {
+                second = shard.get();
+            }
+        }
+        if (!first) {
+            break;
+        }
+
+        // Take all the rows of the first shard not greater than the current row of the second one at once.
+        const size_t block_rows = first->current->GetRowCount();
+        const size_t limit = std::min(block_rows, first->row + (params_.max_block_size - rows));
+        size_t end = first->row + 1;
+        while (end < limit && (!second || CompareRows(*first, end, *second, second->row) <= 0)) {
+            ++end;
+        }
+
+        for (size_t i = 0; i < columns.size(); ++i) {
+            columns[i]->Append((*first->current)[i]->SliceShared(first->row, end - first->row));
+        }
+        rows += end - first->row;
+        first->row = end;
+
+        if (first->row == block_rows) {
+            Fetch(*first);
+        }
+    }
+
+    Block block(columns.size(), rows);
+    for (size_t i = 0; i < columns.size(); ++i) {
+        block.AppendColumn(names[i], columns[i]);
+    }
+    return block;
+}
+
+}
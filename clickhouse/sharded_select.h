@@ -0,0 +1,111 @@
+#pragma once
+
+#include "block.h"
+#include "query.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace clickhouse {
+
+class Client;
+
+struct ShardedSelectParams {
+    /// Max number of blocks received from a shard and not consumed yet,
+    /// reading from the shard pauses until some of them are consumed.
+    size_t max_queued_blocks = 4;
+    /// If non-zero, max total size (Block::AllocatedBytes()) of blocks received from all the shards and not consumed yet.
+    /// Reading from a shard pauses while the limit is exceeded, unless the shard has no blocks queued
+    /// (otherwise merging sorted results could wait for a shard forever).
+    size_t max_queued_bytes = 0;
+    /// Columns the result of each shard is sorted by (in ascending order, NULLs last).
+    /// If set, blocks of the shards are merged preserving the order, otherwise they are returned as they arrive.
+    std::vector<std::string> sort_columns;
+    /// Max number of rows in merged blocks.
+    size_t max_block_size = 65536;
+};
+
+/** Runs SELECT on several shards concurrently and returns their results as a single stream of blocks.
+ *
+ *  Each shard is read by its own thread through Client::BeginSelect()/NextBlock(), so each client
+ *  must not be used by anyone else until ShardedSelect is destroyed. Query callbacks are called
+ *  from these threads.
+ *
+ *  If the caller stops reading early (calls Cancel() or destroys the object), or any shard fails,
+ *  queries still in progress are cancelled with Client::Cancel(). Shards waiting for the server at
+ *  the moment Cancel() is called are interrupted with Client::Interrupt() and reconnected, so
+ *  slow queries don't delay cancellation.
+ */
+class ShardedSelect {
+public:
+    /// Runs the same query on each of `clients`.
+    ShardedSelect(const std::vector<Client*>& clients, const Query& query, ShardedSelectParams params = {});
+    /// Runs queries[i] on clients[i].
+    ShardedSelect(const std::vector<Client*>& clients, const std::vector<Query>& queries, ShardedSelectParams params = {});
+    ~ShardedSelect();
+
+    ShardedSelect(const ShardedSelect&) = delete;
+    ShardedSelect& operator=(const ShardedSelect&) = delete;
+
+    /// Returns the next block or nullopt when all the shards are done.
+    /// Rethrows the first exception thrown by any of the shards.
+    std::optional<Block> Next();
+
+    /// Stops all the shards, waiting for them to cancel their queries.
+    void Cancel();
+
+private:
+    struct Shard {
+        Client* client;
+        Query query;
+        std::thread thread;
+        std::deque<Block> blocks;
+        /// AllocatedBytes() of each block in `blocks`.
+        std::deque<size_t> blocks_bytes;
+        bool done = false;
+        /// The shard waits for the server, see Cancel().
+        bool reading = false;
+        /// The connection was shut down to interrupt reading.
+        bool interrupted = false;
+
+        /// Block being merged and position of the next row in it.
+        std::optional<Block> current;
+        size_t row = 0;
+        std::vector<size_t> key_columns;
+    };
+
+    void Run(Shard& shard);
+    /// Takes the first queued block of the shard, must be called with mutex_ locked.
+    Block PopBlock(Shard& shard);
+
+    std::optional<Block> NextUnordered();
+    std::optional<Block> NextMerged();
+
+    /// Waits for the next block of the shard and makes it current, returns false if the shard is done.
+    bool Fetch(Shard& shard);
+    /// Compares rows of current blocks of the shards by the sort key.
+    static int CompareRows(const Shard& a, size_t a_row, const Shard& b, size_t b_row);
+
+private:
+    const ShardedSelectParams params_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool cancelled_ = false;
+    std::exception_ptr error_;
+
+    /// Total size of blocks queued by all the shards.
+    size_t queued_bytes_ = 0;
+    size_t next_shard_ = 0;
+    bool merge_started_ = false;
+};
+
+}
@@ -14,32 +14,42 @@ using clickhouse::ValidationError;
 
 namespace {
 
-std::array<uint32_t, 4> Int64LimbsToInt32(std::array<uint64_t, 2> limbs)
+template <size_t W>
+std::array<uint32_t, W * 2> Int64LimbsToInt32(const std::array<uint64_t, W>& limbs)
 {
-    std::array<uint32_t, 4> ret{0};
-    ret[0] = static_cast<uint32_t>(limbs[0] & 0xFFFFFFFFUL);
-    ret[1] = static_cast<uint32_t>(limbs[0] >> 32);
-    ret[2] = static_cast<uint32_t>(limbs[1] & 0xFFFFFFFFUL);
-    ret[3] = static_cast<uint32_t>(limbs[1] >> 32);
+    std::array<uint32_t, W * 2> ret{0};
+    for (size_t i = 0; i < W; ++i) {
+        ret[2 * i] = static_cast<uint32_t>(limbs[i] & 0xFFFFFFFFUL);
+        ret[2 * i + 1] = static_cast<uint32_t>(limbs[i] >> 32);
+    }
     return ret;
 }
 
-std::array<uint64_t, 2> Int32LimbsToInt64(std::array<uint32_t, 4> limbs)
+template <size_t W>
+std::array<uint64_t, W> Int32LimbsToInt64(const std::array<uint32_t, W * 2>& limbs)
 {
-    std::array<uint64_t, 2> ret{0};
-    ret[0] = ((uint64_t)limbs[0] | (uint64_t)limbs[1] << 32);
-    ret[1] = ((uint64_t)limbs[2] | (uint64_t)limbs[3] << 32);
+    std::array<uint64_t, W> ret{0};
+    for (size_t i = 0; i < W; ++i) {
+        ret[i] = ((uint64_t)limbs[2 * i] | (uint64_t)limbs[2 * i + 1] << 32);
+    }
     return ret;
 }
 
 template <size_t W>
-std::string Int64LimbsToStr(std::array<uint64_t, W> limbs, SignMode mode) {
-    auto limbs_32 = Int64LimbsToInt32(limbs);
-    constexpr size_t buffer_size = limb_arr_str_len(limbs_32.size());
-    static_assert(buffer_size > 0);
-    std::array<char, buffer_size> buffer{0};
-    char * str = limb_arr_to_str(limbs_32.data(), limbs_32.size(), mode, buffer.data(), buffer.size());
-    return str;
+constexpr size_t StrBufferSize = limb_arr_str_len(W * 2);
+
+/// Formats the value into `buffer`, returns pointer to the beginning of the string in it.
+template <size_t W>
+const char * Int64LimbsToStr(const std::array<uint64_t, W>& limbs, SignMode mode, std::array<char, StrBufferSize<W>>& buffer) {
+    static_assert(StrBufferSize<W> > 0);
+    const auto limbs_32 = Int64LimbsToInt32(limbs);
+    return limb_arr_to_str(limbs_32.data(), limbs_32.size(), mode, buffer.data(), buffer.size());
+}
+
+template <size_t W>
+std::string Int64LimbsToStr(const std::array<uint64_t, W>& limbs, SignMode mode) {
+    std::array<char, StrBufferSize<W>> buffer{0};
+    return Int64LimbsToStr(limbs, mode, buffer);
 }
 
 template <size_t W>
@@ -50,13 +60,43 @@ std::array<uint64_t, W> StringToInt64Limbs(std::string_view str, SignMode mode)
         case StatusCode::OK:
             break;
         case StatusCode::TOO_LARGE:
-            throw ValidationError("string \"" + std::string(str) + "\" is too big for 128-bit integer");
+            throw ValidationError("string \"" + std::string(str) + "\" is too big for " + std::to_string(W * 64) + "-bit integer");
         case StatusCode::BAD_ARGUMENT:
         case StatusCode::BAD_STRING:
-            throw ValidationError("cannot convert string \"" + std::string(str) + "\" to 128-bit integer");
+            throw ValidationError("cannot convert string \"" + std::string(str) + "\" to " + std::to_string(W * 64) + "-bit integer");
             break;
     }
-    return Int32LimbsToInt64(limbs);
+    return Int32LimbsToInt64<W>(limbs);
+}
+
+template <typename T>
+std::array<uint64_t, 4> Limbs(const T& x) {
+    return {x.limbs[0], x.limbs[1], x.limbs[2], x.limbs[3]};
+}
+
+template <typename T>
+T FromLimbs(const std::array<uint64_t, 4>& limbs) {
+    T ret;
+    for (size_t i = 0; i < limbs.size(); ++i) {
+        ret.limbs[i] = limbs[i];
+    }
+    return ret;
+}
+
+template <typename T>
+void ToStringsImpl(const T* values, size_t count, SignMode mode, std::vector<std::string>& out) {
+    out.resize(count);
+    std::array<char, StrBufferSize<4>> buffer{0};
+    for (size_t i = 0; i < count; ++i) {
+        out[i].assign(Int64LimbsToStr(Limbs(values[i]), mode, buffer));
+    }
+}
+
+template <typename T>
+void FromStringsImpl(const std::string_view* strings, size_t count, SignMode mode, T* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = FromLimbs<T>(StringToInt64Limbs<4>(strings[i], mode));
+    }
 }
 
 } // anonymous namespace
@@ -85,6 +125,48 @@ UInt128 Bignum::StringToUInt128(std::string_view str) {
     return MakeUInt128(ret[1], ret[0]);
 }
 
+std::string Bignum::Int256ToString(const Int256& x) {
+    return Int64LimbsToStr(Limbs(x), SignMode::SIGNED);
+}
+
+std::string Bignum::UInt256ToString(const UInt256& x) {
+    return Int64LimbsToStr(Limbs(x), SignMode::UNSIGNED);
+}
+
+Int256 Bignum::StringToInt256(std::string_view str) {
+    return FromLimbs<Int256>(StringToInt64Limbs<4>(str, SignMode::SIGNED));
+}
+
+UInt256 Bignum::StringToUInt256(std::string_view str) {
+    return FromLimbs<UInt256>(StringToInt64Limbs<4>(str, SignMode::UNSIGNED));
+}
+
+void Bignum::ToStrings(const Int256* values, size_t count, std::vector<std::string>& out) {
+    ToStringsImpl(values, count, SignMode::SIGNED, out);
+}
+
+void Bignum::ToStrings(const UInt256* values, size_t count, std::vector<std::string>& out) {
+    ToStringsImpl(values, count, SignMode::UNSIGNED, out);
+}
+
+void Bignum::FromStrings(const std::string_view* strings, size_t count, Int256* out) {
+    FromStringsImpl(strings, count, SignMode::SIGNED, out);
+}
+
+void Bignum::FromStrings(const std::string_view* strings, size_t count, UInt256* out) {
+    FromStringsImpl(strings, count, SignMode::UNSIGNED, out);
+}
+
+std::ostream& operator<<(std::ostream& os, const Int256& v)
+{
+    return os << Bignum::Int256ToString(v);
+}
+
+std::ostream& operator<<(std::ostream& os, const UInt256& v)
+{
+    return os << Bignum::UInt256ToString(v);
+}
+
 } // namespace clickhouse
 
 #if !CH_USE_ABSEIL_FOR_BIGNUM
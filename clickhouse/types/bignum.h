@@ -1,8 +1,13 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <limits>
+#include <ostream>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <vector>
 
 #if CH_USE_ABSEIL_FOR_BIGNUM
 #define CH_ABSEIL_BIGNUM_DEPRECATED \
@@ -46,11 +51,6 @@ using UInt128 = absl::uint128;
 
 #else
 
-#include <cstddef>
-#include <limits>
-#include <ostream>
-#include <type_traits>
-
 namespace clickhouse {
 
 struct UInt128 {
@@ -161,6 +161,84 @@ static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
 
 namespace clickhouse {
 
+/**
+ * 256-bit integers. Unlike Int128/UInt128 these do not depend on Abseil and only store the value,
+ * arithmetic is left to the user's library of choice.
+ */
+struct UInt256 {
+    UInt256() : limbs{0, 0, 0, 0} {}
+
+    explicit UInt256(uint64_t x) : limbs{x, 0, 0, 0} {}
+
+    bool operator==(const UInt256& other) const {
+        return limbs[0] == other.limbs[0] && limbs[1] == other.limbs[1]
+            && limbs[2] == other.limbs[2] && limbs[3] == other.limbs[3];
+    }
+
+    bool operator!=(const UInt256& other) const { return !(*this == other); }
+
+    bool operator<(const UInt256& other) const {
+        for (size_t i = 4; i-- > 0;) {
+            if (limbs[i] != other.limbs[i]) {
+                return limbs[i] < other.limbs[i];
+            }
+        }
+        return false;
+    }
+
+    bool operator>(const UInt256& other) const { return other < *this; }
+    bool operator<=(const UInt256& other) const { return !(other < *this); }
+    bool operator>=(const UInt256& other) const { return !(*this < other); }
+
+    // The value as four 64-bit limbs in little-endian order, `limbs[0]` is the lowest one.
+    uint64_t limbs[4];
+};
+
+struct Int256 {
+    Int256() : limbs{0, 0, 0, 0} {}
+
+    explicit Int256(int64_t x)
+        : limbs{static_cast<uint64_t>(x), 0, 0, 0}
+    {
+        if (x < 0) {
+            limbs[1] = limbs[2] = limbs[3] = 0xFFFFFFFFFFFFFFFFUL;
+        }
+    }
+
+    bool operator==(const Int256& other) const {
+        return limbs[0] == other.limbs[0] && limbs[1] == other.limbs[1]
+            && limbs[2] == other.limbs[2] && limbs[3] == other.limbs[3];
+    }
+
+    bool operator!=(const Int256& other) const { return !(*this == other); }
+
+    // The highest limb is compared as signed, the rest as unsigned.
+    bool operator<(const Int256& other) const {
+        if (limbs[3] != other.limbs[3]) {
+            return static_cast<int64_t>(limbs[3]) < static_cast<int64_t>(other.limbs[3]);
+        }
+        for (size_t i = 3; i-- > 0;) {
+            if (limbs[i] != other.limbs[i]) {
+                return limbs[i] < other.limbs[i];
+            }
+        }
+        return false;
+    }
+
+    bool operator>(const Int256& other) const { return other < *this; }
+    bool operator<=(const Int256& other) const { return !(other < *this); }
+    bool operator>=(const Int256& other) const { return !(*this < other); }
+
+    // The value as four 64-bit limbs in little-endian order (two's complement), `limbs[0]` is the lowest one.
+    uint64_t limbs[4];
+};
+
+// Serialized as raw bytes the same way as Int128/UInt128.
+static_assert(sizeof(UInt256) == 32 && std::is_trivially_copyable_v<UInt256>,
+              "UInt256 must be exactly 32 bytes and trivially copyable for raw wire serialization");
+static_assert(sizeof(Int256) == 32 && std::is_trivially_copyable_v<Int256>,
+              "Int256 must be exactly 32 bytes and trivially copyable for raw wire serialization");
+
 class Bignum {
 public:
 
@@ -228,6 +306,20 @@ public:
 
 #endif
 
+    static std::string Int256ToString(const Int256& x);
+    static std::string UInt256ToString(const UInt256& x);
+
+    static Int256 StringToInt256(std::string_view str);
+    static UInt256 StringToUInt256(std::string_view str);
+
+    /// Bulk conversions, `out` is resized to `count` and strings already in it are reused
+    /// to avoid allocations when the same vector is used for several blocks.
+    static void ToStrings(const Int256* values, size_t count, std::vector<std::string>& out);
+    static void ToStrings(const UInt256* values, size_t count, std::vector<std::string>& out);
+
+    /// Bulk conversions, `out` must have room for `count` values.
+    static void FromStrings(const std::string_view* strings, size_t count, Int256* out);
+    static void FromStrings(const std::string_view* strings, size_t count, UInt256* out);
 };
 
 
@@ -297,3 +389,65 @@ public:
 } // namespace std
 
 #endif
+
+namespace clickhouse {
+
+std::ostream& operator<<(std::ostream& os, const Int256& v);
+std::ostream& operator<<(std::ostream& os, const UInt256& v);
+
+} // namespace clickhouse
+
+namespace std {
+
+template <>
+class numeric_limits<clickhouse::UInt256> {
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = false;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = true;
+    static constexpr int digits = 256;
+    static constexpr int digits10 = 77;
+    static constexpr int radix = 2;
+
+    static clickhouse::UInt256 max() noexcept {
+        clickhouse::UInt256 ret;
+        ret.limbs[0] = ret.limbs[1] = ret.limbs[2] = ret.limbs[3] = 0xFFFFFFFFFFFFFFFFULL;
+        return ret;
+    }
+    static clickhouse::UInt256 min() noexcept { return clickhouse::UInt256{}; }
+    static clickhouse::UInt256 lowest() noexcept { return min(); }
+};
+
+template <>
+class numeric_limits<clickhouse::Int256> {
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = true;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = false;
+    static constexpr int digits = 255;
+    static constexpr int digits10 = 76;
+    static constexpr int radix = 2;
+
+    // 2^255 - 1: sign bit clear, all other bits set.
+    static clickhouse::Int256 max() noexcept {
+        clickhouse::Int256 ret;
+        ret.limbs[0] = ret.limbs[1] = ret.limbs[2] = 0xFFFFFFFFFFFFFFFFULL;
+        ret.limbs[3] = 0x7FFFFFFFFFFFFFFFULL;
+        return ret;
+    }
+    // -2^255: only the sign bit set.
+    static clickhouse::Int256 min() noexcept {
+        clickhouse::Int256 ret;
+        ret.limbs[3] = 0x8000000000000000ULL;
+        return ret;
+    }
+    static clickhouse::Int256 lowest() noexcept { return min(); }
+};
+
+} // namespace std
@@ -62,10 +62,13 @@ static const std::unordered_map<std::string, Type::Code> kTypeCode = {
     { "IPv6",        Type::IPv6 },
     { "Int128",      Type::Int128 },
     { "UInt128",     Type::UInt128 },
+    { "Int256",      Type::Int256 },
+    { "UInt256",     Type::UInt256 },
     { "Decimal",     Type::Decimal },
     { "Decimal32",   Type::Decimal32 },
     { "Decimal64",   Type::Decimal64 },
     { "Decimal128",  Type::Decimal128 },
+    { "Decimal256",  Type::Decimal256 },
     { "LowCardinality", Type::LowCardinality },
     { "Map",         Type::Map },
     { "Point",       Type::Point },
@@ -72,6 +72,9 @@ const char* Type::TypeName(Type::Code code) {
         case Type::Code::Time64:         return "Time64";
         case Type::Code::JSON:           return "JSON";
         case Type::Code::Bool:           return "Bool";
+        case Type::Code::Int256:         return "Int256";
+        case Type::Code::UInt256:        return "UInt256";
+        case Type::Code::Decimal256:     return "Decimal256";
     }
 
     return "Unknown type";
@@ -105,6 +108,8 @@ std::string Type::GetName() const {
         case MultiPolygon:
         case JSON:
         case Bool:
+        case Int256:
+        case UInt256:
             return TypeName(code_);
         case Time64:
             return As<Time64Type>()->GetName();
@@ -127,6 +132,7 @@ std::string Type::GetName() const {
         case Decimal32:
         case Decimal64:
         case Decimal128:
+        case Decimal256:
             return As<DecimalType>()->GetName();
         case LowCardinality:
             return As<LowCardinalityType>()->GetName();
@@ -168,6 +174,8 @@ uint64_t Type::GetTypeUniqueId() const {
         case Polygon:
         case MultiPolygon:
         case Bool:
+        case Int256:
+        case UInt256:
             // For simple types, unique ID is the same as Type::Code
             return code_;
 
@@ -185,6 +193,7 @@ uint64_t Type::GetTypeUniqueId() const {
         case Decimal32:
         case Decimal64:
         case Decimal128:
+        case Decimal256:
         case LowCardinality:
         case Map: {
             // For complex types, exact unique ID depends on nested types and/or parameters,
@@ -346,6 +355,8 @@ std::string DecimalType::GetName() const {
             return "Decimal64(" + std::to_string(scale_) + ")";
         case Decimal128:
             return "Decimal128(" + std::to_string(scale_) + ")";
+        case Decimal256:
+            return "Decimal256(" + std::to_string(scale_) + ")";
         default:
             /// XXX: NOT REACHED!
             return "";
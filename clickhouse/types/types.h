@@ -58,6 +58,9 @@ public:
         Time64,
         JSON,
         Bool,
+        Int256,
+        UInt256,
+        Decimal256,
     };
 
     using EnumItem = std::pair<std::string /* name */, int16_t /* value */>;
@@ -372,6 +375,16 @@ inline TypeRef Type::CreateSimple<UInt128>() {
     return TypeRef(new Type(UInt128));
 }
 
+template <>
+inline TypeRef Type::CreateSimple<Int256>() {
+    return TypeRef(new Type(Int256));
+}
+
+template <>
+inline TypeRef Type::CreateSimple<UInt256>() {
+    return TypeRef(new Type(UInt256));
+}
+
 template <>
 inline TypeRef Type::CreateSimple<uint8_t>() {
     return TypeRef(new Type(UInt8));
@@ -0,0 +1,36 @@
+find_path(liburing_INCLUDE_DIR
+  NAMES liburing.h
+  DOC "liburing include directory")
+mark_as_advanced(liburing_INCLUDE_DIR)
+find_library(liburing_LIBRARY
+  NAMES uring liburing
+  DOC "liburing library")
+mark_as_advanced(liburing_LIBRARY)
+
+if (liburing_INCLUDE_DIR AND EXISTS "${liburing_INCLUDE_DIR}/liburing/io_uring_version.h")
+  file(STRINGS "${liburing_INCLUDE_DIR}/liburing/io_uring_version.h" _liburing_version_lines
+    REGEX "#define[ \t]+IO_URING_VERSION_(MAJOR|MINOR)")
+  string(REGEX REPLACE ".*IO_URING_VERSION_MAJOR *\([0-9]*\).*" "\\1" _liburing_version_major "${_liburing_version_lines}")
+  string(REGEX REPLACE ".*IO_URING_VERSION_MINOR *\([0-9]*\).*" "\\1" _liburing_version_minor "${_liburing_version_lines}")
+  set(liburing_VERSION "${_liburing_version_major}.${_liburing_version_minor}")
+  unset(_liburing_version_major)
+  unset(_liburing_version_minor)
+  unset(_liburing_version_lines)
+endif ()
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(liburing
+  REQUIRED_VARS liburing_LIBRARY liburing_INCLUDE_DIR
+  VERSION_VAR liburing_VERSION)
+
+if (liburing_FOUND)
+  set(liburing_INCLUDE_DIRS "${liburing_INCLUDE_DIR}")
+  set(liburing_LIBRARIES "${liburing_LIBRARY}")
+
+  if (NOT TARGET liburing::liburing)
+    add_library(liburing::liburing UNKNOWN IMPORTED)
+    set_target_properties(liburing::liburing PROPERTIES
+      IMPORTED_LOCATION "${liburing_LIBRARY}"
+      INTERFACE_INCLUDE_DIRECTORIES "${liburing_INCLUDE_DIR}")
+  endif ()
+endif ()
@@ -0,0 +1,12 @@
+MACRO (USE_LIBURING)
+
+    IF (WITH_LIBURING)
+        IF (NOT CMAKE_SYSTEM_NAME STREQUAL "Linux")
+            MESSAGE (FATAL_ERROR "io_uring is supported only on Linux")
+        ENDIF ()
+        # io_uring_prep_cancel64() and 64-bit user_data helpers appeared in liburing 2.2
+        FIND_PACKAGE (liburing 2.2 REQUIRED)
+        ADD_COMPILE_DEFINITIONS (WITH_LIBURING=1)
+    ENDIF ()
+
+ENDMACRO ()
@@ -124,11 +124,11 @@ public:
             }
         }
 
-        if constexpr (std::is_same_v<ColumnType, ColumnInt128>) {
+        if constexpr (is_one_of_v<ColumnType, ColumnInt128, ColumnInt256, ColumnUInt256>) {
             const auto server_info = client.GetServerInfo();
             if (versionNumber(server_info) < versionNumber(21, 7)) {
                 std::stringstream buffer;
-                buffer <<  "ColumnInt128 is available since v21.7.2.7-stable and can't be tested against server: " << server_info;
+                buffer <<  "Int128 and 256-bit integer columns are available since v21.7.2.7-stable and can't be tested against server: " << server_info;
                 return buffer.str();
             }
         }
@@ -230,6 +230,8 @@ using TestCases = ::testing::Types<
 
     GenericColumnTestCase<ColumnInt128, &makeColumn<ColumnInt128>, clickhouse::Int128, &MakeInt128s>,
     GenericColumnTestCase<ColumnUInt128, &makeColumn<ColumnUInt128>, clickhouse::UInt128, &MakeUInt128s>,
+    GenericColumnTestCase<ColumnInt256, &makeColumn<ColumnInt256>, clickhouse::Int256, &MakeInt256s>,
+    GenericColumnTestCase<ColumnUInt256, &makeColumn<ColumnUInt256>, clickhouse::UInt256, &MakeUInt256s>,
     GenericColumnTestCase<ColumnUUID, &makeColumn<ColumnUUID>, clickhouse::UUID, &MakeUUIDs>,
 
     DecimalColumnTestCase<ColumnDecimal, 18, 0>,
@@ -245,6 +247,9 @@ using TestCases = ::testing::Types<
     DecimalColumnTestCase<ColumnDecimal, 6, 0>,
     DecimalColumnTestCase<ColumnDecimal, 6, 3>,
 
+    DecimalColumnTestCase<ColumnDecimal, 76, 0>,
+    DecimalColumnTestCase<ColumnDecimal, 76, 12>,
+
     GenericColumnTestCase<ColumnLowCardinalityT<ColumnString>, &makeColumn<ColumnLowCardinalityT<ColumnString>>, std::string, &MakeStrings>
 
     // Array(String)
@@ -340,6 +345,17 @@ TYPED_TEST(GenericColumnTest, GetItem) {
         EXPECT_EQ(column->GetItem(0).type, column->GetType().GetCode());
     }
 
+    if constexpr (std::is_same_v<typename TestFixture::ColumnType, ColumnDecimal>) {
+        if (column->GetItem(0).data.size() == sizeof(Int256)) {
+            // Generated values are Int128, while items of Decimal256 are 256-bit wide.
+            for (size_t i = 0; i < values.size(); ++i) {
+                ASSERT_EQ(Int256(static_cast<int64_t>(values[i])), column->GetItem(i).template get<Int256>())
+                    << " On item " << i << " of " << PrintContainer{values};
+            }
+            return;
+        }
+    }
+
     for (size_t i = 0; i < values.size(); ++i) {
         const auto v = convertValueForGetItem(*column, values[i]);
         const ItemView item = column->GetItem(i);
@@ -361,6 +377,46 @@ TYPED_TEST(GenericColumnTest, Slice) {
     // TODO: slices of different sizes
 }
 
+TYPED_TEST(GenericColumnTest, GatherFilterPermute) {
+    auto [column, values] = this->MakeColumnWithValues(1'000);
+
+    std::vector<size_t> indices;
+    std::vector<uint8_t> mask(values.size());
+    std::vector<size_t> reversed;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i % 3 == 0) {
+            indices.push_back(i);
+            mask[i] = 1;
+        }
+        reversed.push_back(values.size() - 1 - i);
+    }
+    // Rows may repeat and go in any order.
+    indices.push_back(0);
+    indices.push_back(values.size() - 1);
+
+    auto expected = values;
+    expected.clear();
+    for (const auto index : indices) {
+        expected.push_back(values[index]);
+    }
+    auto gathered = column->Gather(indices)->template AsStrict<typename TestFixture::ColumnType>();
+    EXPECT_EQ(column->GetType(), gathered->GetType());
+    EXPECT_TRUE(CompareRecursive(expected, *gathered));
+
+    expected.resize(expected.size() - 2);
+    auto filtered = column->Filter(mask)->template AsStrict<typename TestFixture::ColumnType>();
+    EXPECT_EQ(column->GetType(), filtered->GetType());
+    EXPECT_TRUE(CompareRecursive(expected, *filtered));
+
+    expected.assign(values.rbegin(), values.rend());
+    auto permuted = column->Permute(reversed)->template AsStrict<typename TestFixture::ColumnType>();
+    EXPECT_TRUE(CompareRecursive(expected, *permuted));
+
+    EXPECT_EQ(0u, column->Gather(Span<const size_t>{})->Size());
+    EXPECT_THROW(column->Gather(std::vector<size_t>{values.size()}), ValidationError);
+    EXPECT_THROW(column->Filter(std::vector<uint8_t>(values.size() + 1)), ValidationError);
+}
+
 TYPED_TEST(GenericColumnTest, CloneEmpty) {
     auto [column, values] = this->MakeColumnWithValues(10'000);
     EXPECT_EQ(values.size(), column->Size());
@@ -466,6 +522,40 @@ TYPED_TEST(GenericColumnTest, LoadAndSave) {
     EXPECT_TRUE(CompareRecursive(*column_A, *column_B));
 }
 
+TYPED_TEST(GenericColumnTest, ByteSize) {
+    using column_type = typename TestFixture::ColumnType;
+    auto [column, values] = this->MakeColumnWithValues(100);
+
+    if constexpr (is_one_of_v<column_type, ColumnString, ColumnJSON>) {
+        // Characters and an 8-byte offset per row.
+        size_t expected = values.size() * sizeof(uint64_t);
+        for (const auto & value : values) {
+            expected += value.size();
+        }
+        EXPECT_EQ(expected, column->ByteSize());
+    } else if constexpr (!std::is_same_v<column_type, ColumnLowCardinalityT<ColumnString>>) {
+        // Values of fixed-size types take as much space as they do in the native format.
+        Buffer buffer;
+        BufferOutput output(&buffer);
+        column->SaveBody(&output);
+        output.Flush();
+        EXPECT_EQ(buffer.size(), column->ByteSize());
+    }
+
+    EXPECT_GT(column->ByteSize(), 0u);
+    EXPECT_GE(column->AllocatedBytes(), column->ByteSize());
+
+    const size_t allocated = column->AllocatedBytes();
+    column->Reserve(values.size() * 10);
+    EXPECT_GE(column->AllocatedBytes(), allocated);
+
+    Block block;
+    block.AppendColumn("a", column);
+    block.AppendColumn("b", column->Slice(0, values.size()));
+    EXPECT_EQ(2 * column->ByteSize(), block.ByteSize());
+    EXPECT_GE(block.AllocatedBytes(), block.ByteSize());
+}
+
 const auto LocalHostEndpoint = ClientOptions()
         .SetHost(           getEnvOrDefault("CLICKHOUSE_HOST",     "localhost"))
         .SetPort(   getEnvOrDefault<size_t>("CLICKHOUSE_PORT",     "9000"))
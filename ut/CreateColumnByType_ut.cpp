@@ -1,6 +1,7 @@
 #include <clickhouse/columns/bool.h>
 #include <clickhouse/columns/factory.h>
 #include <clickhouse/columns/date.h>
+#include <clickhouse/columns/decimal.h>
 #include <clickhouse/columns/lowcardinality.h>
 #include <clickhouse/columns/numeric.h>
 #include <clickhouse/columns/string.h>
@@ -253,11 +254,18 @@ TEST_P(CreateColumnByTypeWithName, CreateColumnByType)
     EXPECT_EQ(col->GetType().GetName(), GetParam());
 }
 
+TEST(CreateColumnByType, Decimal256) {
+    const auto col = CreateColumnByType("Decimal256(10)");
+    ASSERT_NE(nullptr, col);
+    EXPECT_EQ("Decimal(76,10)", col->GetType().GetName());
+    EXPECT_EQ(76u, col->As<ColumnDecimal>()->GetPrecision());
+}
+
 INSTANTIATE_TEST_SUITE_P(Basic, CreateColumnByTypeWithName, ::testing::Values(
     "Int8", "Int16", "Int32", "Int64",
     "UInt8", "UInt16", "UInt32", "UInt64",
     "String", "Date", "DateTime",
-    "UUID", "Int128", "UInt128"
+    "UUID", "Int128", "UInt128", "Int256", "UInt256"
 ));
 #if !CH_MAP_BOOL_TO_UINT8
 INSTANTIATE_TEST_SUITE_P(BasicBool, CreateColumnByTypeWithName, ::testing::Values("Bool"));
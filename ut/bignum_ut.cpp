@@ -190,3 +190,57 @@ TEST(BignumCompare, UInt128CastToNative) {
     }
 }
 #endif
+
+TEST(Bignum256, Compare) {
+    using clickhouse::Int256;
+    using clickhouse::UInt256;
+
+    EXPECT_TRUE(Int256(-1) < Int256(0));
+    EXPECT_TRUE(Int256(std::numeric_limits<int64_t>::min()) < Int256(-1));
+    EXPECT_TRUE(std::numeric_limits<Int256>::min() < Int256(std::numeric_limits<int64_t>::min()));
+    EXPECT_TRUE(Int256(std::numeric_limits<int64_t>::max()) < std::numeric_limits<Int256>::max());
+    EXPECT_EQ(Int256(-1), Int256(-1));
+
+    UInt256 high;
+    high.limbs[3] = 1;
+    EXPECT_TRUE(UInt256(std::numeric_limits<uint64_t>::max()) < high);
+    EXPECT_TRUE(high < std::numeric_limits<UInt256>::max());
+    EXPECT_EQ(UInt256(), std::numeric_limits<UInt256>::min());
+}
+
+TEST(Bignum256, StringRoundtrip) {
+    const std::vector<std::string> signed_values = {
+        "0", "1", "-1", "-9223372036854775808", "18446744073709551616",
+        "57896044618658097711785492504343953926634992332820282019728792003956564819967",
+        "-57896044618658097711785492504343953926634992332820282019728792003956564819968",
+    };
+    for (const auto& value : signed_values) {
+        EXPECT_EQ(value, Bignum::Int256ToString(Bignum::StringToInt256(value)));
+    }
+    EXPECT_EQ(std::numeric_limits<clickhouse::Int256>::max(), Bignum::StringToInt256(signed_values[5]));
+    EXPECT_EQ(std::numeric_limits<clickhouse::Int256>::min(), Bignum::StringToInt256(signed_values[6]));
+
+    const std::string uint256_max =
+        "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+    EXPECT_EQ(uint256_max, Bignum::UInt256ToString(Bignum::StringToUInt256(uint256_max)));
+    EXPECT_EQ(std::numeric_limits<clickhouse::UInt256>::max(), Bignum::StringToUInt256(uint256_max));
+
+    EXPECT_ANY_THROW(Bignum::StringToInt256(signed_values[5] + "0"));
+    EXPECT_ANY_THROW(Bignum::StringToUInt256("115792089237316195423570985008687907853269984665640564039457584007913129639936"));
+    EXPECT_ANY_THROW(Bignum::StringToUInt256("-1"));
+    EXPECT_ANY_THROW(Bignum::StringToInt256("1x"));
+}
+
+TEST(Bignum256, BulkConversions) {
+    const std::vector<std::string_view> strings = {"0", "-42", "340282366920938463463374607431768211456"};
+    std::vector<clickhouse::Int256> values(strings.size());
+    Bignum::FromStrings(strings.data(), strings.size(), values.data());
+    EXPECT_EQ(clickhouse::Int256(-42), values[1]);
+
+    std::vector<std::string> result{"some", "longer", "strings", "to reuse"};
+    Bignum::ToStrings(values.data(), values.size(), result);
+    ASSERT_EQ(strings.size(), result.size());
+    for (size_t i = 0; i < strings.size(); ++i) {
+        EXPECT_EQ(strings[i], result[i]);
+    }
+}
@@ -179,3 +179,49 @@ TEST(BlockTest, Reserve) {
         ++i;
     }
 }
+
+TEST(BlockTest, ByteSize) {
+    auto numbers = std::make_shared<ColumnUInt32>(std::vector<uint32_t>{1, 2, 3, 4, 5});
+    auto strings = std::make_shared<ColumnString>(std::vector<std::string>{"a", "bb", "ccc", "", "eeeee"});
+    auto lc = std::make_shared<ColumnLowCardinalityT<ColumnString>>(std::vector<std::string>{"1", "2", "1", "2", "1"});
+
+    auto nullable = std::make_shared<ColumnNullable>(numbers->Slice(0, 5), std::make_shared<ColumnUInt8>(std::vector<uint8_t>{0, 1, 0, 1, 0}));
+    auto array = std::make_shared<ColumnArray>(std::make_shared<ColumnUInt32>());
+    for (size_t i = 0; i < 5; ++i) {
+        array->AppendAsColumn(numbers->Slice(0, i));
+    }
+    auto tuple = std::make_shared<ColumnTuple>(std::vector<ColumnRef>{numbers, strings});
+
+    EXPECT_EQ(5 * sizeof(uint32_t), numbers->ByteSize());
+    EXPECT_EQ(11 + 5 * sizeof(uint64_t), strings->ByteSize());
+    EXPECT_EQ(numbers->ByteSize() + 5, nullable->ByteSize());
+    EXPECT_EQ(10 * sizeof(uint32_t) + 5 * sizeof(uint64_t), array->ByteSize());
+    EXPECT_EQ(numbers->ByteSize() + strings->ByteSize(), tuple->ByteSize());
+    // Dictionary with the default item and an index of UInt32.
+    EXPECT_EQ(3 * sizeof(uint64_t) + 2 + 5 * sizeof(uint32_t), lc->ByteSize());
+    // The hash map of the dictionary.
+    EXPECT_GT(lc->AllocatedBytes(), lc->ByteSize() + 3 * sizeof(uint64_t));
+
+    auto block = MakeBlock({
+        {"numbers", numbers},
+        {"strings", strings},
+        {"lc", lc},
+        {"nullable", nullable},
+        {"array", array},
+        {"tuple", tuple},
+    });
+
+    size_t byte_size = 0;
+    size_t allocated_bytes = 0;
+    for (const auto & c : block) {
+        byte_size += c.Column()->ByteSize();
+        allocated_bytes += c.Column()->AllocatedBytes();
+        EXPECT_GE(c.Column()->AllocatedBytes(), c.Column()->ByteSize()) << c.Name();
+    }
+    EXPECT_EQ(byte_size, block.ByteSize());
+    EXPECT_EQ(allocated_bytes, block.AllocatedBytes());
+
+    numbers->Reserve(1000);
+    EXPECT_EQ(byte_size, block.ByteSize());
+    EXPECT_GE(block.AllocatedBytes(), allocated_bytes + 995 * sizeof(uint32_t));
+}
@@ -1,10 +1,14 @@
 #include <clickhouse/client.h>
+#include <clickhouse/result_cache.h>
+#include <clickhouse/sharded_select.h>
 #include <clickhouse/columns/bool.h>
 
+#include "clickhouse/base/endpoints_iterator.h"
 #include "clickhouse/base/socket.h"
 #include "clickhouse/types/bignum.h"
 #include "clickhouse/version.h"
 #include "clickhouse/error_codes.h"
+#include "clickhouse/protocol.h"
 
 #include "readonly_client_test.h"
 #include "connection_failed_client_test.h"
@@ -15,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <ostream>
@@ -766,6 +771,187 @@ TEST_P(ClientCase, SimpleAggregateFunctionLowCardinality) {
     EXPECT_EQ(data.size(), total_rows);
 }
 
+TEST_P(ClientCase, ShardedSelectMerged) {
+    // Each "shard" returns a part of the sequence, merged result must be sorted.
+    Client shard1(GetParam());
+    Client shard2(GetParam());
+    std::vector<Client*> clients = {client_.get(), &shard1, &shard2};
+    std::vector<Query> queries;
+    for (size_t i = 0; i < clients.size(); ++i) {
+        queries.emplace_back("SELECT number, toString(number) AS s FROM system.numbers WHERE number % 3 = "
+            + std::to_string(i) + " LIMIT 100000 SETTINGS max_block_size = 1000");
+    }
+
+    ShardedSelectParams params;
+    params.sort_columns = {"number"};
+    params.max_block_size = 4096;
+    ShardedSelect select(clients, queries, params);
+
+    uint64_t expected = 0;
+    while (auto block = select.Next()) {
+        EXPECT_LE(block->GetRowCount(), params.max_block_size);
+        auto numbers = (*block)[0]->As<ColumnUInt64>();
+        auto strings = (*block)[1]->As<ColumnString>();
+        for (size_t i = 0; i < block->GetRowCount(); ++i, ++expected) {
+            ASSERT_EQ(expected, numbers->At(i));
+            ASSERT_EQ(std::to_string(expected), strings->At(i));
+        }
+    }
+    EXPECT_EQ(300000u, expected);
+}
+
+TEST_P(ClientCase, ShardedSelectCancelsEarly) {
+    Client shard(GetParam());
+    std::vector<Client*> clients = {client_.get(), &shard};
+
+    {
+        // Endless queries are cancelled when the caller stops reading.
+        ShardedSelect select(clients, Query("SELECT number FROM system.numbers"));
+        size_t rows = 0;
+        while (rows < 100000) {
+            auto block = select.Next();
+            ASSERT_TRUE(block.has_value());
+            rows += block->GetRowCount();
+        }
+    }
+
+    // Both clients are usable after cancellation.
+    for (auto client : clients) {
+        size_t rows = 0;
+        client->Select("SELECT 1", [&rows](const Block& block) { rows += block.GetRowCount(); });
+        EXPECT_EQ(1u, rows);
+    }
+}
+
+TEST_P(ClientCase, EndpointsStatsCountServerExceptionsAsFailures) {
+    auto stats = std::make_shared<EndpointsStats>();
+    Client client(ClientOptions(GetParam()).SetEndpointsStats(stats));
+    const Endpoint endpoint = client.GetCurrentEndpoint().value();
+
+    EXPECT_THROW(client.Execute("SELECT throwIf(1, 'failed')"), ServerException);
+    EXPECT_EQ(1u, stats->Get(endpoint).consecutive_failures);
+
+    // Time spent in callbacks isn't counted as latency.
+    client.Select("SELECT 1", [](const Block&) { std::this_thread::sleep_for(std::chrono::milliseconds(500)); });
+    EXPECT_EQ(0u, stats->Get(endpoint).consecutive_failures);
+    EXPECT_LT(stats->Get(endpoint).latency, std::chrono::milliseconds(500));
+}
+
+TEST_P(ClientCase, ShardedSelectInterruptsSlowQuery) {
+    Client shard(GetParam());
+    std::vector<Client*> clients = {client_.get(), &shard};
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        // Shards wait for the server without receiving anything.
+        ShardedSelect select(clients, Query("SELECT sleep(3)"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+
+    // Interrupted clients are reconnected.
+    for (auto client : clients) {
+        size_t rows = 0;
+        client->Select("SELECT 1", [&rows](const Block& block) { rows += block.GetRowCount(); });
+        EXPECT_EQ(1u, rows);
+    }
+}
+
+TEST_P(ClientCase, ShardedSelectRethrowsShardError) {
+    Client shard(GetParam());
+    std::vector<Client*> clients = {client_.get(), &shard};
+    std::vector<Query> queries = {
+        Query("SELECT number FROM system.numbers"),
+        Query("SELECT throwIf(1, 'shard failed')"),
+    };
+
+    ShardedSelect select(clients, queries);
+    EXPECT_THROW(
+        while (select.Next()) {
+            ;
+        },
+        ServerException);
+}
+
+TEST_P(ClientCase, ResultCache) {
+    auto cache = std::make_shared<QueryResultCache>();
+    Client client(ClientOptions(GetParam()).SetResultCache(cache));
+
+    const std::string query = "SELECT number, rand() FROM system.numbers LIMIT 10";
+    auto select = [&client](const std::string& text) {
+        std::vector<uint32_t> values;
+        client.Select(text, [&values](const Block& block) {
+            for (size_t i = 0; i < block.GetRowCount(); ++i) {
+                values.push_back(block[1]->As<ColumnUInt32>()->At(i));
+            }
+        });
+        return values;
+    };
+
+    const auto first = select(query);
+    EXPECT_EQ(10u, first.size());
+    // rand() gives the same values only if the result came from the cache.
+    EXPECT_EQ(first, select("  " + query + ";"));
+    EXPECT_EQ(1u, cache->Hits());
+    EXPECT_EQ(1u, cache->Size());
+
+    cache->Clear();
+    EXPECT_NE(first, select(query));
+}
+
+TEST_P(ClientCase, ResultCacheMaxBufferedResultBytes) {
+    auto cache = std::make_shared<QueryResultCache>();
+    Client client(ClientOptions(GetParam()).SetResultCache(cache).SetMaxBufferedResultBytes(1024));
+
+    size_t rows = 0;
+    client.Select("SELECT number FROM system.numbers LIMIT 10", [&rows](const Block& block) { rows += block.GetRowCount(); });
+    EXPECT_EQ(1u, cache->Size());
+
+    // Larger results are returned, but not buffered for the cache.
+    client.Select("SELECT number FROM system.numbers LIMIT 1000", [&rows](const Block& block) { rows += block.GetRowCount(); });
+    EXPECT_EQ(1010u, rows);
+    EXPECT_EQ(1u, cache->Size());
+}
+
+TEST_P(ClientCase, ShardedSelectMaxQueuedBytes) {
+    Client shard(GetParam());
+    std::vector<Client*> clients = {client_.get(), &shard};
+
+    ShardedSelectParams params;
+    params.max_queued_bytes = 1;
+    ShardedSelect select(clients, Query("SELECT number FROM system.numbers LIMIT 100000 SETTINGS max_block_size = 1000"), params);
+
+    size_t rows = 0;
+    while (auto block = select.Next()) {
+        rows += block->GetRowCount();
+    }
+    EXPECT_EQ(200000u, rows);
+}
+
+TEST_P(ClientCase, Stats) {
+    ClientStats query_stats;
+    client_->Select(Query("SELECT number, toString(number) FROM system.numbers LIMIT 100000")
+        .OnFinish([&query_stats](const ClientStats& stats) { query_stats = stats; }));
+
+    EXPECT_EQ(1u, query_stats.queries);
+    EXPECT_GT(query_stats.bytes_received, 100000u * sizeof(uint64_t));
+    EXPECT_GT(query_stats.bytes_sent, 0u);
+    EXPECT_GT(query_stats.recv_calls, 0u);
+    EXPECT_GT(query_stats.send_calls, 0u);
+    EXPECT_GT(query_stats.packets_received[ServerCodes::Data], 0u);
+    EXPECT_EQ(1u, query_stats.packets_received[ServerCodes::EndOfStream]);
+    EXPECT_GT(query_stats.column_load_ns, 0u);
+    if (GetParam().compression_method != CompressionMethod::None) {
+        EXPECT_GT(query_stats.uncompressed_bytes_received, query_stats.compressed_bytes_received);
+    }
+
+    const ClientStats& total = client_->GetStats();
+    EXPECT_GE(total.queries, query_stats.queries);
+    EXPECT_GE(total.bytes_received, query_stats.bytes_received);
+    // Handshake.
+    EXPECT_EQ(1u, total.packets_received[ServerCodes::Hello]);
+}
+
 TEST_P(ClientCase, Cancellable) {
     /// Create a table.
     client_->Execute(
@@ -1368,6 +1554,61 @@ TEST_P(ClientCase, OnProgress) {
     EXPECT_LE(received_progress->written_bytes, 10000u);
 }
 
+TEST_P(ClientCase, TotalsAndExtremes) {
+    const std::string query_text =
+        "SELECT number % 2 AS k, count() AS c FROM numbers(10) GROUP BY k WITH TOTALS ORDER BY k SETTINGS extremes = 1";
+
+    uint64_t data_rows = 0;
+    std::optional<uint64_t> totals;
+    std::optional<std::pair<uint64_t, uint64_t>> extremes;
+    client_->Execute(Query(query_text)
+        .OnData([&](const Block& block) {
+            data_rows += block.GetRowCount();
+        })
+        .OnTotals([&](const Block& block) {
+            ASSERT_EQ(1u, block.GetRowCount());
+            totals = block[1]->As<ColumnUInt64>()->At(0);
+        })
+        .OnExtremes([&](const Block& block) {
+            ASSERT_EQ(2u, block.GetRowCount());
+            extremes = std::make_pair(block[0]->As<ColumnUInt8>()->At(0), block[0]->As<ColumnUInt8>()->At(1));
+        }));
+
+    EXPECT_EQ(2u, data_rows);
+    EXPECT_EQ(10u, totals);
+    EXPECT_EQ(std::make_pair(uint64_t(0), uint64_t(1)), extremes);
+
+    // The same through NextBlock().
+    client_->BeginSelect(query_text);
+    std::vector<BlockKind> kinds;
+    BlockKind kind;
+    while (auto block = client_->NextBlock(kind)) {
+        if (kinds.empty() || kinds.back() != kind) {
+            kinds.push_back(kind);
+        }
+    }
+    EXPECT_NE(kinds.end(), std::find(kinds.begin(), kinds.end(), BlockKind::Data));
+    EXPECT_NE(kinds.end(), std::find(kinds.begin(), kinds.end(), BlockKind::Totals));
+    EXPECT_NE(kinds.end(), std::find(kinds.begin(), kinds.end(), BlockKind::Extremes));
+}
+
+TEST_P(ClientCase, ServerTimeInProgress) {
+    Progress total;
+    Query query("SELECT sleepEachRow(0.01) FROM numbers(10) SETTINGS max_block_size = 1");
+    query.OnProgress([&total](const Progress& progress) {
+        total.rows += progress.rows;
+        total.total_bytes += progress.total_bytes;
+        total.elapsed_ns += progress.elapsed_ns;
+    });
+    client_->Execute(query);
+
+    EXPECT_EQ(10u, total.rows);
+    const uint64_t DBMS_MIN_PROTOCOL_VERSION_WITH_SERVER_QUERY_TIME_IN_PROGRESS = 54460;
+    if (client_->GetServerInfo().revision >= DBMS_MIN_PROTOCOL_VERSION_WITH_SERVER_QUERY_TIME_IN_PROGRESS) {
+        EXPECT_GE(total.elapsed_ns, 100'000'000u);
+    }
+}
+
 TEST_P(ClientCase, QuerySettings) {
     client_->Execute("DROP TEMPORARY TABLE IF EXISTS test_clickhouse_query_settings_table_1;");
     client_->Execute("CREATE TEMPORARY TABLE IF NOT EXISTS test_clickhouse_query_settings_table_1 ( id  Int64 )");
@@ -1488,6 +1729,39 @@ TEST_P(ClientCase, OnProfileEvents) {
     }
 }
 
+TEST_P(ClientCase, OnProfileEventsSnapshot) {
+    std::optional<ProfileEventsSnapshot> snapshot;
+    client_->Execute(Query("SELECT sum(number) FROM numbers(1000000)")
+        .OnProfileEventsSnapshot([&snapshot](const ProfileEventsSnapshot& s) { snapshot = s; }));
+
+    ASSERT_TRUE(snapshot.has_value());
+    const int DBMS_MIN_REVISION_WITH_INCREMENTAL_PROFILE_EVENTS = 54451;
+    if (client_->GetServerInfo().revision >= DBMS_MIN_REVISION_WITH_INCREMENTAL_PROFILE_EVENTS) {
+        EXPECT_FALSE(snapshot->Empty());
+        EXPECT_GT(snapshot->Get("SelectedRows"), 0);
+    }
+}
+
+TEST_P(ClientCase, OnProfileEventsSnapshotAfterServerException) {
+    std::optional<ProfileEventsSnapshot> snapshot;
+    Query query("SELECT sum(number) FROM test_clickhouse_cpp_profile_events");
+    query.OnProfileEventsSnapshot([&snapshot](const ProfileEventsSnapshot& s) { snapshot = s; });
+
+    // The table doesn't exist yet.
+    EXPECT_THROW(client_->Execute(query), ServerException);
+
+    client_->Execute("CREATE TEMPORARY TABLE IF NOT EXISTS test_clickhouse_cpp_profile_events (number UInt64)");
+    client_->Execute("INSERT INTO test_clickhouse_cpp_profile_events SELECT number FROM numbers(1000)");
+    snapshot.reset();
+    client_->Execute(query);
+
+    ASSERT_TRUE(snapshot.has_value());
+    const int DBMS_MIN_REVISION_WITH_INCREMENTAL_PROFILE_EVENTS = 54451;
+    if (client_->GetServerInfo().revision >= DBMS_MIN_REVISION_WITH_INCREMENTAL_PROFILE_EVENTS) {
+        EXPECT_EQ(1000, snapshot->Get("SelectedRows"));
+    }
+}
+
 TEST_P(ClientCase, OnProfile) {
     try {
         Query query("SELECT * FROM system.numbers LIMIT 10;");
@@ -1847,6 +2121,25 @@ INSTANTIATE_TEST_SUITE_P(MultipleEndpointsFailed, ConnectionFailedClientTest,
     }
 ));
 
+INSTANTIATE_TEST_SUITE_P(MultipleEndpointsFailedRacing, ConnectionFailedClientTest,
+    ::testing::Values(ConnectionFailedClientTest::ParamType{
+        ClientOptions()
+            .SetEndpoints({
+                     {"deadaginghost", 9000}
+                    ,{"somedeadhost",  1245}
+                    ,{"localhost",     19995}
+                })
+            .SetUser(           getEnvOrDefault("CLICKHOUSE_USER",     "default"))
+            .SetPassword(       getEnvOrDefault("CLICKHOUSE_PASSWORD", ""))
+            .SetDefaultDatabase(getEnvOrDefault("CLICKHOUSE_DB",       "default"))
+            .SetPingBeforeQuery(true)
+            .SetConnectionConnectTimeout(std::chrono::milliseconds(200))
+            .SetConnectionAttemptDelay(std::chrono::milliseconds(50))
+            .SetRetryTimeout(std::chrono::seconds(1)),
+        ExpectingException{""}
+    }
+));
+
 class ResetConnectionTestCase : public testing::TestWithParam<ClientOptions> {};
 
 TEST_P(ResetConnectionTestCase, ResetConnectionEndpointTest) {
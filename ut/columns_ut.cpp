@@ -21,6 +21,7 @@
 #include "value_generators.h"
 
 #include <memory>
+#include <numeric>
 #include <string_view>
 #include <vector>
 
@@ -203,6 +204,223 @@ TEST(ColumnsCase, NumericSlice) {
     ASSERT_EQ(sub->At(2), 13u);
 }
 
+TEST(ColumnsCase, NumericSliceCopiesData) {
+    auto col = std::make_shared<ColumnUInt32>(MakeNumbers());
+    auto& values = col->GetWritableData();
+    const auto* data = values.data();
+    auto sub = col->Slice(3, 3)->As<ColumnUInt32>();
+    EXPECT_NE(col->RawData().data() + 3, sub->RawData().data());
+
+    // The column still owns its values, so they aren't copied on modification
+    // and writes through a reference taken before Slice() don't reach the slice.
+    values[3] = 100;
+    EXPECT_EQ(data, col->GetWritableData().data());
+    EXPECT_EQ(100u, col->At(3));
+    EXPECT_EQ(7u, sub->At(0));
+}
+
+TEST(ColumnsCase, NumericSliceSharesData) {
+    auto col = std::make_shared<ColumnUInt32>(MakeNumbers());
+    auto sub = col->SliceShared(3, 3)->As<ColumnUInt32>();
+    EXPECT_EQ(col->RawData().data() + 3, sub->RawData().data());
+    EXPECT_EQ(sub->RawData().data() + 1, sub->SliceShared(1, 10)->As<ColumnUInt32>()->RawData().data());
+
+    // Modification of either of them copies the values.
+    col->GetWritableData()[3] = 100;
+    col->Append(200);
+    EXPECT_EQ(7u, sub->At(0));
+    EXPECT_EQ(3u, sub->Size());
+
+    sub->Append(300);
+    EXPECT_EQ(100u, col->At(3));
+    EXPECT_EQ(200u, col->At(col->Size() - 1));
+    EXPECT_EQ(4u, sub->Size());
+    EXPECT_EQ(300u, sub->At(3));
+    EXPECT_THROW(sub->At(4), std::out_of_range);
+
+    auto other = col->SliceShared(0, 2);
+    col->Clear();
+    EXPECT_EQ(0u, col->Size());
+    EXPECT_EQ(2u, other->Size());
+    EXPECT_EQ(1u, other->As<ColumnUInt32>()->At(0));
+}
+
+TEST(ColumnsCase, DateAndBoolSliceSharesData) {
+    auto date = std::make_shared<ColumnDate>(std::vector<uint16_t>{1, 2, 3});
+    EXPECT_EQ(date->RawData().data() + 1, date->SliceShared(1, 2)->As<ColumnDate>()->RawData().data());
+
+    auto date_time = std::make_shared<ColumnDateTime>(std::vector<uint32_t>{1, 2, 3});
+    EXPECT_EQ(date_time->RawData().data() + 2, date_time->SliceShared(2, 1)->As<ColumnDateTime>()->RawData().data());
+
+    auto boolean = std::make_shared<ColumnBool>(std::vector<uint8_t>{1, 0, 1});
+    auto slice = boolean->SliceShared(1, 2)->As<ColumnBool>();
+    EXPECT_EQ(boolean->RawData().data() + 1, slice->RawData().data());
+    boolean->Append(true);
+    EXPECT_EQ(2u, slice->Size());
+}
+
+TEST(ColumnsCase, StringSliceSharesData) {
+    const auto values = MakeStrings();
+    auto col = std::make_shared<ColumnString>(values);
+    col->Append(std::string("stolen value"));
+    auto sub = col->SliceShared(2, 10)->As<ColumnString>();
+    ASSERT_EQ(values.size() - 1, sub->Size());
+    EXPECT_EQ(col->At(2).data(), sub->At(0).data());
+    EXPECT_EQ(col->At(values.size()).data(), sub->At(values.size() - 2).data());
+
+    // Slices keep the character data alive and don't see modifications of the column.
+    col->Append("one more");
+    col->Clear();
+    col.reset();
+    for (size_t i = 2; i < values.size(); ++i) {
+        EXPECT_EQ(values[i], sub->At(i - 2));
+    }
+    EXPECT_EQ("stolen value", sub->At(values.size() - 2));
+
+    sub->Append("appended");
+    auto sub2 = sub->SliceShared(1, 100)->As<ColumnString>();
+    sub->Append("appended to the first slice");
+    ASSERT_EQ(values.size() - 1, sub2->Size());
+    EXPECT_EQ("appended", sub2->At(values.size() - 2));
+    EXPECT_EQ("appended to the first slice", sub->At(sub->Size() - 1));
+}
+
+TEST(ColumnsCase, FixedStringAndArraySliceShareData) {
+    auto col = std::make_shared<ColumnFixedString>(3, MakeFixedStrings(3));
+    auto sub = col->SliceShared(1, 2)->As<ColumnFixedString>();
+    EXPECT_EQ(col->RawData().data() + 3, sub->RawData().data());
+    col->Append("xyz");
+    EXPECT_EQ(2u, sub->Size());
+    EXPECT_EQ(col->At(1), sub->At(0));
+
+    auto array = std::make_shared<ColumnArrayT<ColumnUInt64>>();
+    array->Append(std::vector<uint64_t>{1, 2});
+    array->Append(std::vector<uint64_t>{3});
+    array->Append(std::vector<uint64_t>{4, 5, 6});
+    auto array_slice = array->SliceShared(1, 2)->As<ColumnArray>();
+    const auto nested = array->GetData()->As<ColumnUInt64>();
+    EXPECT_EQ(nested->RawData().data() + 2, array_slice->GetData()->As<ColumnUInt64>()->RawData().data());
+    EXPECT_EQ(3u, array_slice->GetOffsets()->At(1) - array_slice->GetOffsets()->At(0));
+    EXPECT_EQ(6u, array_slice->GetAsColumnTyped<ColumnUInt64>(1)->At(2));
+}
+
+TEST(ColumnsCase, NumericAppendRange) {
+    const auto values = MakeNumbers();
+    auto col = std::make_shared<ColumnUInt32>();
+    col->AppendRange(values.data(), values.size());
+    col->AppendRange(values.data(), 0);
+    EXPECT_TRUE(CompareRecursive(values, *col));
+
+    // Appending a column to itself or to its slice copies the values once.
+    auto slice = col->Slice(0, 2);
+    col->Append(col);
+    col->Append(slice);
+    ASSERT_EQ(values.size() * 2 + 2, col->Size());
+    EXPECT_EQ(values.back(), col->At(values.size() * 2 - 1));
+    EXPECT_EQ(values[1], col->At(values.size() * 2 + 1));
+    EXPECT_EQ(2u, slice->Size());
+}
+
+TEST(ColumnsCase, FixedStringAppendFixedStrings) {
+    auto col = std::make_shared<ColumnFixedString>(4);
+    const char packed[] = "abcdefgh";
+    col->AppendFixedStrings(packed, 2, 4);
+    // Shorter values are padded.
+    const char short_values[] = "xyz";
+    col->AppendFixedStrings(short_values, 3, 1);
+    EXPECT_THROW(col->AppendFixedStrings(packed, 1, 5), ValidationError);
+
+    ASSERT_EQ(5u, col->Size());
+    EXPECT_EQ("abcd", col->At(0));
+    EXPECT_EQ("efgh", col->At(1));
+    EXPECT_EQ(std::string_view("y\0\0\0", 4), col->At(3));
+
+    col->Append(col);
+    ASSERT_EQ(10u, col->Size());
+    EXPECT_EQ("efgh", col->At(6));
+    EXPECT_EQ(std::string_view("z\0\0\0", 4), col->At(9));
+    EXPECT_EQ(40u, col->ByteSize());
+}
+
+TEST(ColumnsCase, GatherNestedColumns) {
+    auto array = std::make_shared<ColumnArrayT<ColumnUInt64>>();
+    array->Append(std::vector<uint64_t>{1, 2});
+    array->Append(std::vector<uint64_t>{});
+    array->Append(std::vector<uint64_t>{3, 4, 5});
+    auto gathered_array = array->Gather(std::vector<size_t>{2, 1, 0, 2});
+    auto typed_array = gathered_array->AsStrict<ColumnArrayT<ColumnUInt64>>();
+    ASSERT_EQ(4u, typed_array->Size());
+    EXPECT_TRUE(CompareRecursive(std::vector<uint64_t>{3, 4, 5}, (*typed_array)[0]));
+    EXPECT_EQ(0u, (*typed_array)[1].size());
+    EXPECT_TRUE(CompareRecursive(std::vector<uint64_t>{1, 2}, (*typed_array)[2]));
+    EXPECT_TRUE(CompareRecursive(std::vector<uint64_t>{3, 4, 5}, (*typed_array)[3]));
+
+    auto nullable = std::make_shared<ColumnNullableT<ColumnUInt32>>();
+    nullable->Append(1);
+    nullable->Append(std::nullopt);
+    nullable->Append(3);
+    auto filtered = nullable->Filter(std::vector<uint8_t>{0, 1, 1})->AsStrict<ColumnNullableT<ColumnUInt32>>();
+    ASSERT_EQ(2u, filtered->Size());
+    EXPECT_TRUE(filtered->IsNull(0));
+    EXPECT_EQ(3u, *filtered->At(1));
+
+    auto tuple = std::make_shared<ColumnTuple>(std::vector<ColumnRef>{
+        std::make_shared<ColumnUInt32>(std::vector<uint32_t>{1, 2, 3}),
+        std::make_shared<ColumnString>(std::vector<std::string>{"a", "b", "c"})});
+    auto permuted = tuple->Permute(std::vector<size_t>{2, 0, 1})->As<ColumnTuple>();
+    EXPECT_EQ(tuple->GetType().GetName(), permuted->GetType().GetName());
+    EXPECT_EQ(3u, (*permuted)[0]->As<ColumnUInt32>()->At(0));
+    EXPECT_EQ("b", (*permuted)[1]->As<ColumnString>()->At(2));
+}
+
+TEST(ColumnsCase, DateTimeKeepsTimezone) {
+    auto col = std::make_shared<ColumnDateTime>("Europe/Moscow", std::vector<uint32_t>{1, 2, 3});
+    const std::string type_name = col->GetType().GetName();
+    EXPECT_EQ("DateTime('Europe/Moscow')", type_name);
+
+    for (const auto& result : {
+            col->Slice(1, 2),
+            col->Gather(std::vector<size_t>{2, 0}),
+            col->Filter(std::vector<uint8_t>{1, 0, 1}),
+            col->Permute(std::vector<size_t>{2, 1, 0}),
+            col->CloneEmpty()}) {
+        EXPECT_EQ(type_name, result->GetType().GetName());
+        EXPECT_EQ("Europe/Moscow", result->As<ColumnDateTime>()->Timezone());
+    }
+}
+
+TEST(ColumnsCase, LowCardinalityGatherKeepsDictionary) {
+    auto lc = std::make_shared<ColumnLowCardinalityT<ColumnString>>();
+    for (const auto & value : {"a", "b", "a", "c"}) {
+        lc->Append(value);
+    }
+    auto gathered = lc->Gather(std::vector<size_t>{3, 0})->AsStrict<ColumnLowCardinalityT<ColumnString>>();
+    ASSERT_EQ(2u, gathered->Size());
+    EXPECT_EQ("c", gathered->At(0));
+    EXPECT_EQ("a", gathered->At(1));
+    EXPECT_EQ(lc->GetDictionarySize(), gathered->GetDictionarySize());
+
+    // Existing items are found in the dictionary, new ones don't affect the source column.
+    gathered->Append("b");
+    gathered->Append("d");
+    EXPECT_EQ(lc->GetDictionarySize() + 1, gathered->GetDictionarySize());
+    EXPECT_EQ("b", gathered->At(2));
+    EXPECT_EQ("d", gathered->At(3));
+    EXPECT_EQ(4u, lc->Size());
+    EXPECT_EQ("c", lc->At(3));
+}
+
+TEST(ColumnsCase, PermuteValidatesArgument) {
+    auto col = std::make_shared<ColumnUInt32>(std::vector<uint32_t>{1, 2, 3});
+    EXPECT_THROW(col->Permute(std::vector<size_t>{0, 1}), ValidationError);
+    EXPECT_THROW(col->Permute(std::vector<size_t>{0, 1, 1}), ValidationError);
+    EXPECT_THROW(col->Permute(std::vector<size_t>{0, 1, 3}), ValidationError);
+    EXPECT_THROW(col->Gather(std::vector<size_t>{0, 3}), ValidationError);
+
+    auto permuted = col->Permute(std::vector<size_t>{1, 2, 0})->As<ColumnUInt32>();
+    EXPECT_TRUE(CompareRecursive(std::vector<uint32_t>{2, 3, 1}, *permuted));
+}
+
 
 TEST(ColumnsCase, FixedStringInit) {
     const auto column_data = MakeFixedStrings(3);
@@ -792,6 +1010,53 @@ TEST(ColumnsCase, UUIDSlice) {
     ASSERT_EQ(sub->At(1), UUID(0x3507213c178649f9llu, 0x9faf035d662f60aellu));
 }
 
+TEST(ColumnsCase, RawData) {
+    auto numbers = std::make_shared<ColumnUInt32>(std::vector<uint32_t>{1, 2, 3});
+    const auto raw = numbers->RawData();
+    ASSERT_EQ(3u, raw.size());
+    EXPECT_EQ(6u, std::accumulate(raw.begin(), raw.end(), 0u));
+    EXPECT_EQ(2u, raw.subspan(1).size());
+    EXPECT_EQ(3u, raw.subspan(2, 10)[0]);
+    EXPECT_TRUE(raw.subspan(5).empty());
+    EXPECT_TRUE(ColumnUInt32().RawData().empty());
+
+    ColumnDate date;
+    date.AppendRaw(100);
+    EXPECT_EQ(100u, date.RawData()[0]);
+
+    ColumnDateTime64 dt64(3);
+    dt64.Append(123456);
+    EXPECT_EQ(123456, dt64.RawData()[0]);
+
+    ColumnDecimal decimal(18, 2);
+    decimal.Append("1.5");
+    EXPECT_EQ(150, decimal.RawData<int64_t>()[0]);
+    EXPECT_THROW(decimal.RawData<int32_t>(), ValidationError);
+
+    ColumnIPv4 ip4;
+    ip4.Append("1.2.3.4");
+    EXPECT_EQ(0x01020304u, ip4.RawData()[0]);
+
+    ColumnUUID uuid;
+    uuid.Append(UUID(1, 2));
+    EXPECT_EQ(2u, uuid.RawData().size());
+    EXPECT_EQ(2u, uuid.RawData()[1]);
+
+    ColumnFixedString fixed(2);
+    fixed.Append("ab");
+    fixed.Append("c");
+    EXPECT_EQ(std::string("abc\0", 4), std::string(fixed.RawData().data(), fixed.RawData().size()));
+
+    ColumnNullableT<ColumnInt64> nullable;
+    nullable.Append(std::optional<int64_t>(5));
+    nullable.Append(std::nullopt);
+    const auto null_map = nullable.NullMap();
+    ASSERT_EQ(2u, null_map.size());
+    EXPECT_EQ(0u, null_map[0]);
+    EXPECT_EQ(1u, null_map[1]);
+    EXPECT_EQ(5, nullable.RawData()[0]);
+}
+
 TEST(ColumnsCase, Int128) {
     auto col = std::make_shared<ColumnInt128>(std::vector<Int128>{
             Bignum::MakeInt128(0xffffffffffffffffll, 0xffffffffffffffffll), // -1
@@ -814,6 +1079,127 @@ TEST(ColumnsCase, Int128) {
     EXPECT_EQ(Int128(0), col->At(4));
 }
 
+TEST(ColumnsCase, Decimal256) {
+    auto col = std::make_shared<ColumnDecimal>(76, 2);
+    EXPECT_EQ("Decimal(76,2)", col->GetType().GetName());
+
+    const std::string max = std::string(74, '9') + ".99";
+    col->Append(max);
+    col->Append("-" + max);
+    col->Append("-1.5");
+    col->Append(Int128(123));
+
+    ASSERT_EQ(4u, col->Size());
+    EXPECT_EQ(max, col->StringAt(0));
+    EXPECT_EQ("-" + max, col->StringAt(1));
+    EXPECT_EQ("-1.50", col->StringAt(2));
+    EXPECT_EQ("1.23", col->StringAt(3));
+
+    EXPECT_EQ(Int128(-150), col->At(2));
+    EXPECT_EQ(Int256(-150), col->AtInt256(2));
+    // Doesn't fit into Int128.
+    EXPECT_THROW(col->At(0), ValidationError);
+
+    EXPECT_EQ(32u, col->GetItem(0).data.size());
+    EXPECT_THROW(col->Append(std::string(75, '9') + ".99"), ValidationError);
+}
+
+TEST(ColumnsCase, ColumnDecimalT) {
+    auto col = std::make_shared<ColumnDecimal64T>(18, 2);
+    col->Append(12345);
+    col->Append("-1.5");
+
+    ASSERT_EQ(2u, col->Size());
+    EXPECT_EQ(12345, col->At(0));
+    EXPECT_EQ(-150, (*col)[1]);
+    EXPECT_EQ("123.45", col->StringAt(0));
+    EXPECT_EQ(2u, col->GetWritableData().size());
+
+    // Shares values with the wrapped column.
+    ColumnRef plain = std::make_shared<ColumnDecimal>(9, 3);
+    plain->As<ColumnDecimal>()->Append("1.5");
+    auto typed = plain->AsStrict<ColumnDecimal32T>();
+    EXPECT_EQ(1500, typed->At(0));
+    typed->Append(-1);
+    EXPECT_EQ("-0.001", plain->As<ColumnDecimal>()->StringAt(1));
+
+    EXPECT_EQ(nullptr, plain->As<ColumnDecimal64T>());
+    EXPECT_THROW(plain->AsStrict<ColumnDecimal128T>(), ValidationError);
+    EXPECT_THROW(ColumnDecimal32T(18, 2), ValidationError);
+
+    auto slice = typed->Slice(1, 1)->AsStrict<ColumnDecimal32T>();
+    EXPECT_EQ(-1, slice->At(0));
+}
+
+TEST(ColumnsCase, DecimalScaleGreaterThanPrecision) {
+    EXPECT_THROW(ColumnDecimal(9, 20), ValidationError);
+    EXPECT_THROW(CreateColumnByType("Decimal(9, 20)"), ValidationError);
+
+    // All the digits are after the point.
+    ColumnDecimal col(9, 9);
+    col.Append(std::string("-0.000000001"));
+    EXPECT_EQ("-0.000000001", col.StringAt(0));
+
+    std::string arena;
+    std::vector<std::string_view> formatted;
+    col.ToStrings(arena, formatted);
+    ASSERT_EQ(1u, formatted.size());
+    EXPECT_EQ(col.StringAt(0), formatted[0]);
+}
+
+TEST(ColumnsCase, DecimalBulkConversions) {
+    for (size_t precision : {9, 18, 38, 76}) {
+        ColumnDecimal col(precision, 3);
+        const std::vector<std::string_view> strings = {"0.000", "1.500", "-2.250", "-0.001", "123456.789"};
+        col.AppendStrings(strings.data(), strings.size());
+
+        std::string arena;
+        std::vector<std::string_view> formatted;
+        col.ToStrings(arena, formatted);
+        ASSERT_EQ(strings.size(), formatted.size());
+        for (size_t i = 0; i < strings.size(); ++i) {
+            EXPECT_EQ(strings[i], formatted[i]) << "precision " << precision;
+            EXPECT_EQ(col.StringAt(i), formatted[i]);
+        }
+
+        std::vector<double> doubles;
+        col.ToDoubles(doubles);
+        EXPECT_EQ((std::vector<double>{0, 1.5, -2.25, -0.001, 123456.789}), doubles);
+
+        std::vector<int64_t> ints;
+        col.ToScaledInt64(ints);
+        EXPECT_EQ((std::vector<int64_t>{0, 1500, -2250, -1, 123456789}), ints);
+
+        ColumnDecimal from_doubles(precision, 3);
+        from_doubles.AppendDoubles(doubles.data(), doubles.size());
+        ColumnDecimal from_ints(precision, 3);
+        from_ints.AppendScaledInt64(ints.data(), ints.size());
+        for (size_t i = 0; i < strings.size(); ++i) {
+            EXPECT_EQ(strings[i], from_doubles.StringAt(i)) << "precision " << precision;
+            EXPECT_EQ(strings[i], from_ints.StringAt(i)) << "precision " << precision;
+        }
+    }
+
+    ColumnDecimal col(9, 3);
+    const double too_large = 1e6;
+    EXPECT_THROW(col.AppendDoubles(&too_large, 1), ValidationError);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_THROW(col.AppendDoubles(&nan, 1), ValidationError);
+    const int64_t too_large_int = 1000000000;
+    EXPECT_THROW(col.AppendScaledInt64(&too_large_int, 1), ValidationError);
+    EXPECT_EQ(0u, col.Size());
+
+    ColumnDecimal wide(76, 0);
+    wide.Append(std::string(40, '9'));
+    std::vector<int64_t> ints;
+    EXPECT_THROW(wide.ToScaledInt64(ints), ValidationError);
+    const double big = -1e60;
+    wide.AppendDoubles(&big, 1);
+    std::vector<double> doubles;
+    wide.ToDoubles(doubles);
+    EXPECT_DOUBLE_EQ(-1e60, doubles[1]);
+}
+
 TEST(ColumnsCase, UInt128) {
     auto col = std::make_shared<ColumnUInt128>(std::vector<UInt128>{
             Bignum::MakeUInt128(0xffffffffffffffffll, 0xffffffffffffffffll), // 2^128 - 1
@@ -0,0 +1,133 @@
+#include <clickhouse/base/endpoints_iterator.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace clickhouse;
+using namespace std::chrono_literals;
+
+namespace {
+
+const std::vector<Endpoint> kEndpoints = {
+    {"host1", 9000},
+    {"host2", 9000},
+    {"host3", 9000},
+};
+
+std::shared_ptr<EndpointsStats> MakeStats(std::chrono::milliseconds ejection_time = 30s) {
+    EndpointsStatsParams params;
+    params.max_failures = 2;
+    params.ejection_time = ejection_time;
+    return std::make_shared<EndpointsStats>(params);
+}
+
+}
+
+TEST(EndpointsStatsCase, EjectsAfterConsecutiveFailures) {
+    auto stats = MakeStats();
+
+    stats->OnConnect(kEndpoints[0], false);
+    EXPECT_FALSE(stats->Get(kEndpoints[0]).ejected);
+    stats->OnConnect(kEndpoints[0], true);
+    stats->OnConnect(kEndpoints[0], false);
+    EXPECT_FALSE(stats->Get(kEndpoints[0]).ejected);
+
+    stats->OnRequestStart(kEndpoints[0]);
+    stats->OnRequestFinish(kEndpoints[0], 1ms, false);
+    EXPECT_TRUE(stats->Get(kEndpoints[0]).ejected);
+    EXPECT_EQ(2u, stats->Get(kEndpoints[0]).consecutive_failures);
+    EXPECT_FALSE(stats->Get(kEndpoints[1]).ejected);
+}
+
+TEST(EndpointsStatsCase, TracksOutstandingAndLatency) {
+    auto stats = MakeStats();
+
+    stats->OnRequestStart(kEndpoints[0]);
+    stats->OnRequestStart(kEndpoints[0]);
+    EXPECT_EQ(2u, stats->Get(kEndpoints[0]).outstanding);
+
+    stats->OnRequestFinish(kEndpoints[0], 10ms, true);
+    EXPECT_EQ(1u, stats->Get(kEndpoints[0]).outstanding);
+    EXPECT_EQ(10ms, stats->Get(kEndpoints[0]).latency);
+
+    stats->OnRequestFinish(kEndpoints[0], 20ms, true);
+    EXPECT_EQ(0u, stats->Get(kEndpoints[0]).outstanding);
+    EXPECT_GT(stats->Get(kEndpoints[0]).latency, 10ms);
+    EXPECT_LT(stats->Get(kEndpoints[0]).latency, 20ms);
+}
+
+TEST(EndpointsIteratorCase, InOrderFailsOverAndBack) {
+    auto stats = MakeStats(50ms);
+    InOrderEndpointsIterator iterator(kEndpoints, stats);
+
+    // Connection attempts go through all the endpoints in order.
+    EXPECT_EQ(kEndpoints[0], iterator.Next());
+    EXPECT_EQ(kEndpoints[1], iterator.Next());
+    iterator.OnConnected(kEndpoints[1]);
+
+    EXPECT_EQ(kEndpoints[0], iterator.Next());
+    stats->OnConnect(kEndpoints[0], false);
+    stats->OnConnect(kEndpoints[0], false);
+    iterator.OnConnected(kEndpoints[0]);
+
+    EXPECT_EQ(kEndpoints[1], iterator.Next());
+    iterator.OnConnected(kEndpoints[1]);
+
+    std::this_thread::sleep_for(100ms);
+    EXPECT_EQ(kEndpoints[0], iterator.Next());
+}
+
+TEST(EndpointsIteratorCase, TriesEjectedWhenNothingElseLeft) {
+    auto stats = MakeStats();
+    InOrderEndpointsIterator iterator(kEndpoints, stats);
+    for (const auto& endpoint : kEndpoints) {
+        stats->OnConnect(endpoint, false);
+        stats->OnConnect(endpoint, false);
+    }
+
+    EXPECT_EQ(kEndpoints[0], iterator.Next());
+    EXPECT_EQ(kEndpoints[1], iterator.Next());
+    EXPECT_EQ(kEndpoints[2], iterator.Next());
+    EXPECT_EQ(kEndpoints[0], iterator.Next());
+}
+
+TEST(EndpointsIteratorCase, LeastOutstanding) {
+    auto stats = MakeStats();
+    LeastOutstandingEndpointsIterator iterator(kEndpoints, stats);
+
+    stats->OnRequestStart(kEndpoints[0]);
+    stats->OnRequestStart(kEndpoints[1]);
+    EXPECT_EQ(kEndpoints[2], iterator.Next());
+    iterator.OnConnected(kEndpoints[2]);
+
+    // Ties are resolved in round-robin order.
+    stats->OnRequestStart(kEndpoints[2]);
+    EXPECT_EQ(kEndpoints[0], iterator.Next());
+    iterator.OnConnected(kEndpoints[0]);
+    EXPECT_EQ(kEndpoints[1], iterator.Next());
+    iterator.OnConnected(kEndpoints[1]);
+}
+
+TEST(EndpointsIteratorCase, PowerOfTwoChoicesAvoidsSlowEndpoint) {
+    auto stats = MakeStats();
+    PowerOfTwoChoicesEndpointsIterator iterator(kEndpoints, stats);
+
+    for (const auto& endpoint : kEndpoints) {
+        stats->OnRequestStart(endpoint);
+        stats->OnRequestFinish(endpoint, endpoint == kEndpoints[1] ? 1s : 1ms, true);
+    }
+
+    size_t slow_chosen = 0;
+    for (int i = 0; i < 300; ++i) {
+        const auto endpoint = iterator.Next();
+        iterator.OnConnected(endpoint);
+        slow_chosen += endpoint == kEndpoints[1];
+    }
+
+    // The slow endpoint loses to any other one it is compared with.
+    EXPECT_EQ(0u, slow_chosen);
+}
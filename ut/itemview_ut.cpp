@@ -38,6 +38,7 @@ TEST(ItemView, StorableTypes) {
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Int32, int32_t);
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Int64, int64_t);
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Int128, Int128);
+    TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Int256, Int256);
 
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::UInt8,  uint8_t);
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::UInt16, uint16_t);
@@ -65,6 +66,8 @@ TEST(ItemView, StorableTypes) {
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Decimal32,  int32_t);
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Decimal64,  int64_t);
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Decimal128, Int128);
+    TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Decimal,    Int256);
+    TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Decimal256, Int256);
 
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Enum8, uint8_t);
     TEST_ITEMVIEW_TYPE_VALUES(Type::Code::Enum16, uint16_t);
@@ -0,0 +1,81 @@
+/** Kernel TLS offload tests, run against a local TLS server with a self-signed certificate.
+ */
+#include "tls_server.h"
+
+#include <clickhouse/base/input.h>
+#include <clickhouse/base/sslsocket.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace clickhouse;
+
+namespace {
+
+SSLParams MakeClientParams(bool use_ktls) {
+    SSLParams params{};
+    params.use_default_ca_locations = false;
+    params.context_options = -1;
+    params.min_protocol_version = -1;
+    params.max_protocol_version = -1;
+    params.use_SNI = true;
+    params.skip_verification = true;
+    params.host_flags = -1;
+    params.use_ktls = use_ktls;
+    return params;
+}
+
+/// Downloads `size` bytes of pattern from the local TLS server, returns number of bytes received as sent.
+size_t Download(size_t size, bool use_ktls, bool* ktls_recv) {
+    std::vector<uint8_t> pattern(64 * 1024);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        pattern[i] = static_cast<uint8_t>(i * 11);
+    }
+
+    LocalTlsServer server(0, use_ktls);
+    std::thread sender([&] {
+        auto connection = server.accept();
+        ASSERT_NE(nullptr, connection);
+        for (size_t sent = 0; sent < size; sent += pattern.size()) {
+            ASSERT_TRUE(connection->write(pattern.data(), std::min(pattern.size(), size - sent)));
+        }
+    });
+
+    size_t received = 0;
+    {
+        const auto params = MakeClientParams(use_ktls);
+        SSLContext context(params);
+        SSLSocket socket(NetworkAddress("localhost", std::to_string(server.port())), SocketTimeoutParams{}, params, context);
+        BufferedInput input(socket.makeInputStream(), 8192, 1024 * 1024);
+
+        std::vector<uint8_t> buf(pattern.size());
+        while (received < size && input.ReadAll(buf.data(), buf.size()) == buf.size() && buf == pattern) {
+            received += buf.size();
+        }
+        *ktls_recv = socket.IsKTLSRecvEnabled();
+        // Closing the socket unblocks the sender if reading stopped early.
+    }
+
+    sender.join();
+    return received;
+}
+
+}
+
+TEST(KTLSCase, FallsBackToUserSpaceTLS) {
+    // Works either way: with kTLS if kernel and OpenSSL support it, or with regular TLS otherwise.
+    const size_t size = 4 * 1024 * 1024;
+    bool ktls_recv = false;
+    EXPECT_EQ(size, Download(size, true, &ktls_recv));
+}
+
+TEST(KTLSCase, UserSpaceTLSWhenDisabled) {
+    const size_t size = 1024 * 1024;
+    bool ktls_recv = true;
+    EXPECT_EQ(size, Download(size, false, &ktls_recv));
+    EXPECT_FALSE(ktls_recv);
+}
@@ -0,0 +1,105 @@
+#include <clickhouse/base/memory_resource.h>
+#include <clickhouse/base/input.h>
+#include <clickhouse/base/output.h>
+#include <clickhouse/columns/array.h>
+#include <clickhouse/columns/factory.h>
+#include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/nullable.h>
+#include <clickhouse/columns/string.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+using namespace clickhouse;
+
+TEST(ArenaMemoryResourceCase, Allocate) {
+    ArenaMemoryResource arena(1024);
+    EXPECT_EQ(0u, arena.AllocatedBytes());
+    EXPECT_EQ(0u, arena.ChunkCount());
+
+    char* first = static_cast<char*>(arena.Allocate(10, 1));
+    char* second = static_cast<char*>(arena.Allocate(10, 1));
+    EXPECT_EQ(first + 10, second);
+    EXPECT_EQ(1u, arena.ChunkCount());
+    EXPECT_EQ(1024u, arena.AllocatedBytes());
+    EXPECT_EQ(20u, arena.UsedBytes());
+
+    void* aligned = arena.Allocate(8, 64);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(aligned) % 64);
+
+    // Doesn't fit into the rest of the chunk.
+    arena.Allocate(1000, 1);
+    EXPECT_EQ(2u, arena.ChunkCount());
+
+    // Large allocations get a chunk of their own and don't waste the current one.
+    char* large = static_cast<char*>(arena.Allocate(4096, 1));
+    EXPECT_EQ(3u, arena.ChunkCount());
+    large[4095] = 1;
+    char* small = static_cast<char*>(arena.Allocate(10, 1));
+    EXPECT_EQ(3u, arena.ChunkCount());
+    arena.Deallocate(small, 10, 1);
+}
+
+TEST(ArenaMemoryResourceCase, ColumnString) {
+    auto arena = std::make_shared<ArenaMemoryResource>();
+
+    auto column = std::make_shared<ColumnString>(arena);
+    EXPECT_EQ(arena, column->GetMemoryResource());
+    for (size_t i = 0; i < 1000; ++i) {
+        const auto value = std::to_string(i);
+        column->Append(std::string_view(value));
+    }
+    EXPECT_GT(arena->UsedBytes(), 0u);
+    EXPECT_EQ("999", column->At(999));
+
+    EXPECT_EQ(arena, column->CloneEmpty()->As<ColumnString>()->GetMemoryResource());
+    const auto slice = column->Slice(10, 10)->As<ColumnString>();
+    EXPECT_EQ(arena, slice->GetMemoryResource());
+    EXPECT_EQ("15", slice->At(5));
+
+    // The arena lives as long as columns allocated from it do.
+    std::weak_ptr<ArenaMemoryResource> weak = arena;
+    arena.reset();
+    column.reset();
+    EXPECT_FALSE(weak.expired());
+    EXPECT_EQ("15", slice->At(5));
+    slice->Clear();
+    EXPECT_FALSE(weak.expired());
+}
+
+TEST(ArenaMemoryResourceCase, CreateColumnByType) {
+    ColumnString source;
+    for (size_t i = 0; i < 100; ++i) {
+        source.Append(std::string(i, 'x'));
+    }
+
+    Buffer buffer;
+    BufferOutput output(&buffer);
+    source.SaveBody(&output);
+    output.Flush();
+
+    CreateColumnByTypeSettings settings;
+    auto arena = std::make_shared<ArenaMemoryResource>();
+    settings.memory_resource = arena;
+
+    auto column = CreateColumnByType("String", settings)->As<ColumnString>();
+    ArrayInput input(buffer.data(), buffer.size());
+    ASSERT_TRUE(column->LoadBody(&input, source.Size()));
+    EXPECT_EQ(source.At(99), column->At(99));
+    EXPECT_GE(arena->UsedBytes(), 99u * 100 / 2);
+
+    // Nested String columns use the resource too.
+    auto array = CreateColumnByType("Array(Nullable(String))", settings)->As<ColumnArray>();
+    EXPECT_EQ(arena, array->GetData()->As<ColumnNullable>()->Nested()->As<ColumnString>()->GetMemoryResource());
+
+    // Dictionary of LowCardinality is created with the default item.
+    const size_t used = arena->UsedBytes();
+    auto lc = CreateColumnByType("LowCardinality(String)", settings)->As<ColumnLowCardinalityT<ColumnString>>();
+    EXPECT_GT(arena->UsedBytes(), used);
+    lc->Append("some value");
+    EXPECT_EQ("some value", lc->At(0));
+
+    EXPECT_EQ(nullptr, CreateColumnByType("String")->As<ColumnString>()->GetMemoryResource());
+}
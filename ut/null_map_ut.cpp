@@ -0,0 +1,98 @@
+#include <clickhouse/columns/null_map.h>
+#include <clickhouse/columns/nullable.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace clickhouse;
+
+namespace {
+
+const SimdLevel kLevels[] = {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::Auto};
+
+std::vector<uint8_t> MakeNullMap(size_t rows, double null_ratio, uint32_t seed) {
+    std::mt19937 gen(seed);
+    std::bernoulli_distribution is_null(null_ratio);
+    std::vector<uint8_t> null_map(rows);
+    for (auto& value : null_map) {
+        value = is_null(gen);
+    }
+    return null_map;
+}
+
+}
+
+TEST(NullMapCase, MatchScalar) {
+    for (size_t rows : {0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 100, 1000}) {
+        for (double null_ratio : {0.0, 0.1, 0.5, 1.0}) {
+            SCOPED_TRACE(testing::Message() << "rows " << rows << " null_ratio " << null_ratio);
+            const auto null_map = MakeNullMap(rows, null_ratio, static_cast<uint32_t>(rows));
+            const Span<const uint8_t> span(null_map.data(), null_map.size());
+
+            size_t nulls = 0;
+            size_t first = rows;
+            std::vector<uint32_t> valid_rows, null_rows;
+            std::vector<uint8_t> bitmap((rows + 7) / 8, 0);
+            for (size_t i = 0; i < rows; ++i) {
+                if (null_map[i]) {
+                    ++nulls;
+                    first = std::min(first, i);
+                    null_rows.push_back(static_cast<uint32_t>(i));
+                } else {
+                    valid_rows.push_back(static_cast<uint32_t>(i));
+                    bitmap[i / 8] = static_cast<uint8_t>(bitmap[i / 8] | 1 << (i % 8));
+                }
+            }
+
+            for (auto level : kLevels) {
+                SCOPED_TRACE(static_cast<int>(level));
+                EXPECT_EQ(nulls, CountNulls(span, level));
+                EXPECT_EQ(first, FindFirstNull(span, level));
+
+                std::vector<uint32_t> selection{42};
+                BuildSelection(span, selection, false, level);
+                EXPECT_EQ(valid_rows, selection);
+                BuildSelection(span, selection, true, level);
+                EXPECT_EQ(null_rows, selection);
+
+                std::vector<uint8_t> result(bitmap.size(), 0xFF);
+                NullMapToValidityBitmap(span, result.data(), level);
+                EXPECT_EQ(bitmap, result);
+            }
+
+            std::vector<uint8_t> restored(rows);
+            ValidityBitmapToNullMap(bitmap.data(), rows, restored.data());
+            EXPECT_EQ(null_map, restored);
+        }
+    }
+}
+
+TEST(NullMapCase, NonZeroBytesAreNulls) {
+    const std::vector<uint8_t> null_map(40, 0x80);
+    for (auto level : kLevels) {
+        EXPECT_EQ(40u, CountNulls({null_map.data(), null_map.size()}, level));
+    }
+}
+
+TEST(NullMapCase, AppendValidityBitmap) {
+    ColumnNullableT<ColumnUInt32> col;
+    col.Append(1u);
+
+    // Rows 1, 3 and 8 are valid.
+    const uint8_t bitmap[] = {0b00001010, 0b00000001};
+    col.AppendValidityBitmap(bitmap, 9);
+    col.Nested()->As<ColumnUInt32>()->GetWritableData().resize(10);
+
+    ASSERT_EQ(10u, col.Size());
+    EXPECT_EQ(6u, CountNulls(col.NullMap()));
+    EXPECT_FALSE(col.IsNull(0));
+    EXPECT_TRUE(col.IsNull(1));
+    EXPECT_FALSE(col.IsNull(2));
+    EXPECT_FALSE(col.IsNull(9));
+
+    col.AppendNullFlags(true, 3);
+    EXPECT_EQ(13u, col.NullMap().size());
+    EXPECT_EQ(9u, CountNulls(col.NullMap()));
+}
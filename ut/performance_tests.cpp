@@ -2,6 +2,7 @@
 #include <clickhouse/columns/date.h>
 #include <clickhouse/columns/enum.h>
 #include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/null_map.h>
 #include <clickhouse/columns/nullable.h>
 #include <clickhouse/columns/numeric.h>
 #include <clickhouse/columns/string.h>
@@ -9,11 +10,29 @@
 #include <clickhouse/client.h>
 #include <clickhouse/base/output.h>
 #include <clickhouse/base/input.h>
+#include <clickhouse/base/socket.h>
+#if defined(WITH_OPENSSL)
+#   include <clickhouse/base/sslsocket.h>
+#endif
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
 #include <string>
+#include <thread>
+
+#if !defined(_WIN32)
+#   include <sys/socket.h>
+#   include <unistd.h>
+#endif
 
+#include "tcp_server.h"
+#if defined(WITH_OPENSSL)
+#   include "tls_server.h"
+#endif
 #include "utils.h"
 #include "utils_performance.h"
 
@@ -261,3 +280,285 @@ INSTANTIATE_TYPED_TEST_SUITE_P(SimpleColumns, ColumnPerformanceTest, SimpleColum
 
 using LowCardinalityColumnTypes = ::testing::Types<ColumnLowCardinalityT<ColumnString>, ColumnLowCardinalityT<ColumnFixedString>>;
 INSTANTIATE_TYPED_TEST_SUITE_P(LowCardinality, ColumnPerformanceTest, LowCardinalityColumnTypes);
+
+TEST(NullMapPerformance, Kernels) {
+    SKIP_IN_DEBUG_BUILDS();
+
+    using Timer = Timer<std::chrono::microseconds>;
+    const size_t ROWS = 10'000'000;
+
+    std::vector<uint8_t> null_map(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        // About 10% of NULLs, the first one far enough from the beginning.
+        null_map[i] = i > ROWS / 2 && (i * 2654435761u) % 10 == 0;
+    }
+    const Span<const uint8_t> span(null_map.data(), null_map.size());
+
+    std::vector<uint32_t> selection;
+    std::vector<uint8_t> bitmap((ROWS + 7) / 8);
+    std::vector<uint8_t> restored(ROWS);
+
+    std::cerr << "\n===========================================================" << std::endl;
+    std::cerr << "\t" << ROWS << " rows of null map" << std::endl;
+
+    const std::pair<SimdLevel, const char*> levels[] = {
+        {SimdLevel::Scalar, "Scalar"}, {SimdLevel::SSE2, "SSE2"}, {SimdLevel::AVX2, "AVX2"}};
+    for (const auto& [level, name] : levels) {
+        Timer timer;
+        const size_t nulls = CountNulls(span, level);
+        const auto count_elapsed = timer.Elapsed();
+
+        timer.Restart();
+        const size_t first = FindFirstNull(span, level);
+        const auto find_elapsed = timer.Elapsed();
+
+        timer.Restart();
+        BuildSelection(span, selection, false, level);
+        const auto selection_elapsed = timer.Elapsed();
+
+        timer.Restart();
+        NullMapToValidityBitmap(span, bitmap.data(), level);
+        const auto bitmap_elapsed = timer.Elapsed();
+
+        EXPECT_EQ(ROWS, nulls + selection.size());
+        EXPECT_GT(first, ROWS / 2);
+
+        std::cerr << name << ":\tCountNulls " << count_elapsed
+                  << "\tFindFirstNull " << find_elapsed
+                  << "\tBuildSelection " << selection_elapsed
+                  << "\tToValidityBitmap " << bitmap_elapsed << std::endl;
+    }
+
+    Timer timer;
+    ValidityBitmapToNullMap(bitmap.data(), ROWS, restored.data());
+    std::cerr << "ValidityBitmapToNullMap:\t" << timer.Elapsed() << std::endl;
+    EXPECT_EQ(null_map, restored);
+}
+
+#if !defined(_WIN32)
+TEST(DateTimePerformance, ToCivilTimes) {
+    SKIP_IN_DEBUG_BUILDS();
+
+    using Timer = Timer<std::chrono::microseconds>;
+    const size_t ROWS = 10'000'000;
+    const std::string TIMEZONE = "Europe/Amsterdam";
+
+    std::shared_ptr<const TimeZone> timezone;
+    try {
+        timezone = TimeZone::Get(TIMEZONE);
+    } catch (const ValidationError&) {
+        GTEST_SKIP() << "tz database is not available";
+    }
+
+    ColumnDateTime column(TIMEZONE);
+    column.Reserve(ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        // A second apart, as timestamps of an export usually are.
+        column.AppendRaw(static_cast<uint32_t>(1'600'000'000 + i));
+    }
+
+    std::cerr << "\n===========================================================" << std::endl;
+    std::cerr << "\t" << ROWS << " rows of DateTime('" << TIMEZONE << "')" << std::endl;
+
+    const char* old_tz = std::getenv("TZ");
+    const std::string saved = old_tz ? old_tz : "";
+    setenv("TZ", TIMEZONE.c_str(), 1);
+    tzset();
+
+    Timer timer;
+    int64_t libc_checksum = 0;
+    for (const auto value : column.RawData()) {
+        const std::time_t t = value;
+        std::tm tm{};
+        localtime_r(&t, &tm);
+        libc_checksum += tm.tm_hour;
+    }
+    std::cerr << "localtime_r:\t" << timer.Elapsed() << std::endl;
+
+    if (old_tz) {
+        setenv("TZ", saved.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+
+    std::vector<CivilTime> times;
+    timer.Restart();
+    column.ToCivilTimes(times);
+    std::cerr << "ToCivilTimes:\t" << timer.Elapsed() << std::endl;
+
+    int64_t checksum = 0;
+    for (const auto& time : times) {
+        checksum += time.hour;
+    }
+    EXPECT_EQ(libc_checksum, checksum);
+
+    std::string arena;
+    std::vector<std::string_view> strings;
+    timer.Restart();
+    column.ToStrings(arena, strings);
+    std::cerr << "ToStrings:\t" << timer.Elapsed() << std::endl;
+    EXPECT_EQ(ROWS, strings.size());
+}
+#endif
+
+#if !defined(_WIN32)
+namespace {
+
+/// Counts reads from the underlying socket stream, i.e. recv() calls.
+class CountingInput : public InputStream {
+public:
+    explicit CountingInput(std::unique_ptr<InputStream> source)
+        : source_(std::move(source))
+    { }
+
+    bool Skip(size_t) override {
+        return false;
+    }
+
+    size_t reads = 0;
+
+protected:
+    size_t DoRead(void* buf, size_t len) override {
+        ++reads;
+        return source_->Read(buf, len);
+    }
+
+private:
+    std::unique_ptr<InputStream> source_;
+};
+
+/// Reads `size` bytes from loopback with small reads, returns number of recv() calls.
+size_t ReadFromLoopback(size_t size, size_t buflen, size_t max_buflen) {
+    LocalTcpServer server(0);
+    server.start();
+
+    std::thread writer([&] {
+        const int fd = server.accept();
+        ASSERT_GE(fd, 0);
+
+        const std::vector<uint8_t> chunk(256 * 1024, 0x5a);
+        for (size_t sent = 0; sent < size;) {
+            const ssize_t ret = ::send(fd, chunk.data(), std::min(chunk.size(), size - sent), 0);
+            ASSERT_GT(ret, 0);
+            sent += ret;
+        }
+        close(fd);
+    });
+
+    Socket socket(NetworkAddress("localhost", std::to_string(server.port())));
+    auto counting = std::make_unique<CountingInput>(socket.makeInputStream());
+    auto* counting_ptr = counting.get();
+    BufferedInput input(std::move(counting), buflen, max_buflen);
+
+    // Small reads, like the ones made while parsing packets and columns.
+    uint8_t buf[1024];
+    size_t received = 0;
+    while (received < size) {
+        const size_t len = input.Read(buf, std::min(sizeof(buf), size - received));
+        if (len == 0) {
+            break;
+        }
+        received += len;
+    }
+
+    writer.join();
+    EXPECT_EQ(size, received);
+    return counting_ptr->reads;
+}
+
+}
+
+TEST(SocketPerformance, AdaptiveInputBufferLoopback) {
+    SKIP_IN_DEBUG_BUILDS();
+
+    using Timer = Timer<std::chrono::microseconds>;
+    const size_t SIZE = 256 * 1024 * 1024;
+
+    std::cerr << "\n===========================================================" << std::endl;
+    std::cerr << "\tReading " << SIZE << " bytes from loopback" << std::endl;
+
+    Timer timer;
+    const size_t fixed = ReadFromLoopback(SIZE, 8192, 0);
+    std::cerr << "fixed 8KB buffer:\t" << fixed << " recv() calls, " << timer.Elapsed() << std::endl;
+
+    timer.Restart();
+    const size_t adaptive = ReadFromLoopback(SIZE, 8192, 1024 * 1024);
+    std::cerr << "adaptive 8KB..1MB buffer:\t" << adaptive << " recv() calls, " << timer.Elapsed() << std::endl;
+
+    EXPECT_LT(adaptive, fixed);
+}
+#endif
+
+#if defined(WITH_OPENSSL)
+namespace {
+
+/// Downloads `size` bytes from the local TLS server, returns whether kTLS was used for receiving.
+bool DownloadOverTLS(size_t size, bool use_ktls) {
+    const std::vector<uint8_t> chunk(64 * 1024, 0x5a);
+
+    LocalTlsServer server(0, use_ktls);
+    std::thread sender([&] {
+        auto connection = server.accept();
+        ASSERT_NE(nullptr, connection);
+        for (size_t sent = 0; sent < size; sent += chunk.size()) {
+            ASSERT_TRUE(connection->write(chunk.data(), std::min(chunk.size(), size - sent)));
+        }
+    });
+
+    SSLParams params{};
+    params.context_options = -1;
+    params.min_protocol_version = -1;
+    params.max_protocol_version = -1;
+    params.use_SNI = true;
+    params.skip_verification = true;
+    params.host_flags = -1;
+    params.use_ktls = use_ktls;
+
+    size_t received = 0;
+    bool ktls_recv = false;
+    {
+        SSLContext context(params);
+        SSLSocket socket(NetworkAddress("localhost", std::to_string(server.port())), SocketTimeoutParams{}, params, context);
+        BufferedInput input(socket.makeInputStream(), 8192, 1024 * 1024);
+
+        std::vector<uint8_t> buf(chunk.size());
+        while (received < size) {
+            const size_t len = input.ReadAll(buf.data(), std::min(buf.size(), size - received));
+            if (len == 0) {
+                break;
+            }
+            received += len;
+        }
+        ktls_recv = socket.IsKTLSRecvEnabled();
+    }
+
+    sender.join();
+    EXPECT_EQ(size, received);
+    return ktls_recv;
+}
+
+}
+
+TEST(TLSPerformance, KTLSThroughput) {
+    SKIP_IN_DEBUG_BUILDS();
+
+    using Timer = Timer<std::chrono::microseconds>;
+    const size_t SIZE = 256 * 1024 * 1024;
+
+    const auto throughput = [SIZE] (const Timer::DurationType& elapsed) {
+        return static_cast<double>(SIZE) / 1024 / 1024 / std::max<double>(1, static_cast<double>(elapsed.count())) * 1000000;
+    };
+
+    std::cerr << "\n===========================================================" << std::endl;
+    std::cerr << "\tDownloading " << SIZE << " bytes over TLS from loopback" << std::endl;
+
+    Timer timer;
+    EXPECT_FALSE(DownloadOverTLS(SIZE, false));
+    std::cerr << "user-space TLS:\t" << throughput(timer.Elapsed()) << " MB/s" << std::endl;
+
+    timer.Restart();
+    const bool ktls_recv = DownloadOverTLS(SIZE, true);
+    std::cerr << "kTLS (" << (ktls_recv ? "enabled" : "fallback") << "):\t" << throughput(timer.Elapsed()) << " MB/s" << std::endl;
+}
+#endif
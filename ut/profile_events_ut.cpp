@@ -0,0 +1,134 @@
+#include <clickhouse/profile_events.h>
+#include <clickhouse/query.h>
+#include <clickhouse/columns/date.h>
+#include <clickhouse/columns/enum.h>
+#include <clickhouse/columns/lowcardinality.h>
+#include <clickhouse/columns/numeric.h>
+#include <clickhouse/columns/string.h>
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+
+using namespace clickhouse;
+
+namespace {
+
+struct Event {
+    std::string host;
+    uint64_t thread_id;
+    int8_t type;
+    std::string name;
+    int64_t value;
+};
+
+/// Makes a block of the same structure as server sends in ProfileEvents packets.
+Block MakeBlock(const std::vector<Event>& events) {
+    auto host_name = std::make_shared<ColumnString>();
+    auto current_time = std::make_shared<ColumnDateTime>();
+    auto thread_id = std::make_shared<ColumnUInt64>();
+    auto type = std::make_shared<ColumnEnum8>(Type::CreateEnum8({{"increment", 1}, {"gauge", 2}}));
+    auto name = std::make_shared<ColumnLowCardinalityT<ColumnString>>();
+    auto value = std::make_shared<ColumnInt64>();
+
+    for (const auto& event : events) {
+        host_name->Append(event.host);
+        current_time->Append(0);
+        thread_id->Append(event.thread_id);
+        type->Append(event.type);
+        name->Append(event.name);
+        value->Append(event.value);
+    }
+
+    Block block;
+    block.AppendColumn("host_name", host_name);
+    block.AppendColumn("current_time", current_time);
+    block.AppendColumn("thread_id", thread_id);
+    block.AppendColumn("type", type);
+    block.AppendColumn("name", name);
+    block.AppendColumn("value", value);
+    return block;
+}
+
+}
+
+TEST(ProfileEventsSnapshotCase, SumsIncrements) {
+    ProfileEventsSnapshot snapshot;
+    EXPECT_TRUE(snapshot.Empty());
+
+    snapshot.Append(MakeBlock({
+        {"a", 1, 1, "ReadCompressedBytes", 100},
+        {"a", 2, 1, "ReadCompressedBytes", 10},
+        {"b", 1, 1, "ReadCompressedBytes", 1},
+    }));
+    snapshot.Append(MakeBlock({
+        {"a", 1, 1, "ReadCompressedBytes", 100},
+    }));
+
+    EXPECT_FALSE(snapshot.Empty());
+    EXPECT_EQ(211, snapshot.Get("ReadCompressedBytes"));
+    EXPECT_EQ(0, snapshot.Get("NoSuchEvent"));
+
+    const auto counters = snapshot.Counters();
+    ASSERT_EQ(3u, counters.size());
+    for (const auto& counter : counters) {
+        EXPECT_EQ("ReadCompressedBytes", counter.name);
+        EXPECT_EQ(ProfileEventsSnapshot::Type::Increment, counter.type);
+        if (counter.host == "a" && counter.thread_id == 1) {
+            EXPECT_EQ(200, counter.value);
+        }
+    }
+}
+
+TEST(ProfileEventsSnapshotCase, GaugesKeepLatestValue) {
+    ProfileEventsSnapshot snapshot;
+    snapshot.Append(MakeBlock({
+        {"a", 0, 2, "MemoryTrackerUsage", 1000},
+        {"b", 0, 2, "MemoryTrackerUsage", 500},
+    }));
+    snapshot.Append(MakeBlock({
+        {"a", 0, 2, "MemoryTrackerUsage", 300},
+    }));
+
+    EXPECT_EQ(800, snapshot.Get("MemoryTrackerUsage"));
+
+    const auto totals = snapshot.Totals();
+    ASSERT_EQ(1u, totals.size());
+    EXPECT_EQ("MemoryTrackerUsage", totals[0].name);
+    EXPECT_EQ(ProfileEventsSnapshot::Type::Gauge, totals[0].type);
+    EXPECT_EQ(800, totals[0].value);
+
+    snapshot.Clear();
+    EXPECT_TRUE(snapshot.Empty());
+    EXPECT_EQ(0, snapshot.Get("MemoryTrackerUsage"));
+}
+
+TEST(ProfileEventsSnapshotCase, QueryDropsEventsOfFailedExecution) {
+    std::optional<ProfileEventsSnapshot> snapshot;
+    Query query("SELECT 1");
+    query.OnProfileEventsSnapshot([&snapshot](const ProfileEventsSnapshot& s) { snapshot = s; });
+    QueryEvents& events = query;
+
+    // Fails after some events, without OnFinishWithStats().
+    events.OnStart();
+    events.OnProfileEvents(MakeBlock({{"a", 1, 1, "SelectedRows", 100}}));
+    events.OnServerException(Exception{});
+    EXPECT_FALSE(snapshot.has_value());
+
+    events.OnStart();
+    events.OnProfileEvents(MakeBlock({{"a", 1, 1, "SelectedRows", 1}}));
+    events.OnFinishWithStats(ClientStats{});
+    ASSERT_TRUE(snapshot.has_value());
+    EXPECT_EQ(1, snapshot->Get("SelectedRows"));
+}
+
+TEST(ProfileEventsSnapshotCase, MissingColumn) {
+    Block block;
+    auto value = std::make_shared<ColumnInt64>();
+    value->Append(1);
+    block.AppendColumn("value", value);
+
+    ProfileEventsSnapshot snapshot;
+    EXPECT_THROW(snapshot.Append(block), ValidationError);
+}
@@ -0,0 +1,124 @@
+#include "tcp_server.h"
+
+#include <clickhouse/base/resolver.h>
+#include <clickhouse/client.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace clickhouse;
+using namespace std::chrono_literals;
+
+namespace {
+
+/// Counts actual resolutions and optionally fails them.
+class CountingResolver : public CachingResolver {
+public:
+    using CachingResolver::CachingResolver;
+
+    std::atomic<size_t> calls{0};
+    std::atomic<bool> fail{false};
+
+protected:
+    std::shared_ptr<const NetworkAddress> doResolve(const std::string& host, const std::string& port) override {
+        ++calls;
+        if (fail) {
+            throw std::system_error(std::make_error_code(std::errc::host_unreachable), "resolution failed");
+        }
+        return CachingResolver::doResolve(host, port);
+    }
+};
+
+CachingResolverParams MakeParams(std::chrono::milliseconds ttl, bool background_refresh) {
+    CachingResolverParams params;
+    params.ttl = ttl;
+    params.negative_ttl = 60s;
+    params.background_refresh = background_refresh;
+    return params;
+}
+
+}
+
+TEST(CachingResolverCase, ResolvesOnce) {
+    CountingResolver resolver(MakeParams(60s, true));
+
+    const auto first = resolver.resolve("localhost", "9000");
+    const auto second = resolver.resolve("localhost", "9000");
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(1u, resolver.calls);
+    EXPECT_EQ(1u, resolver.Hits());
+    EXPECT_EQ(1u, resolver.Misses());
+
+    resolver.resolve("localhost", "9001");
+    EXPECT_EQ(2u, resolver.calls);
+    EXPECT_EQ(2u, resolver.Size());
+
+    resolver.Clear();
+    resolver.resolve("localhost", "9000");
+    EXPECT_EQ(3u, resolver.calls);
+}
+
+TEST(CachingResolverCase, CachesFailures) {
+    CountingResolver resolver(MakeParams(60s, true));
+    resolver.fail = true;
+
+    EXPECT_THROW(resolver.resolve("localhost", "9000"), std::system_error);
+    // Served from the cache without resolving, even though the host is resolvable now.
+    resolver.fail = false;
+    EXPECT_THROW(resolver.resolve("localhost", "9000"), std::system_error);
+    EXPECT_EQ(1u, resolver.calls);
+}
+
+TEST(CachingResolverCase, RefreshesInBackground) {
+    CountingResolver resolver(MakeParams(50ms, true));
+
+    const auto first = resolver.resolve("localhost", "9000");
+    for (int i = 0; i < 100 && resolver.calls < 3; ++i) {
+        std::this_thread::sleep_for(20ms);
+    }
+    EXPECT_GE(resolver.calls, 3u);
+
+    // Failed refresh keeps last known addresses.
+    resolver.fail = true;
+    const auto calls = resolver.calls.load();
+    for (int i = 0; i < 100 && resolver.calls == calls; ++i) {
+        std::this_thread::sleep_for(20ms);
+    }
+    EXPECT_NE(nullptr, resolver.resolve("localhost", "9000"));
+    EXPECT_EQ(1u, resolver.Misses());
+}
+
+TEST(CachingResolverCase, ResolvesExpiredOnAccessWithoutBackgroundRefresh) {
+    CountingResolver resolver(MakeParams(10ms, false));
+
+    resolver.resolve("localhost", "9000");
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(1u, resolver.calls);
+
+    resolver.resolve("localhost", "9000");
+    EXPECT_EQ(2u, resolver.calls);
+    EXPECT_EQ(2u, resolver.Misses());
+}
+
+TEST(CachingResolverCase, UsedBySocketFactory) {
+    const int port = 20000;
+    LocalTcpServer server(port);
+    server.start();
+
+    auto resolver = std::make_shared<CountingResolver>();
+    NonSecureSocketFactory factory(resolver);
+    const auto opts = ClientOptions().SetHost("localhost").SetPort(port);
+
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_NE(nullptr, factory.connect(opts, Endpoint{"localhost", port}));
+    }
+    EXPECT_EQ(1u, resolver->calls);
+    EXPECT_EQ(2u, resolver->Hits());
+
+    server.stop();
+}
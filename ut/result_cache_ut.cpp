@@ -0,0 +1,138 @@
+#include <clickhouse/result_cache.h>
+#include <clickhouse/columns/numeric.h>
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace clickhouse;
+using namespace std::chrono_literals;
+
+namespace {
+
+QueryResultCache::Blocks MakeBlocks(size_t rows) {
+    auto column = std::make_shared<ColumnUInt64>();
+    for (size_t i = 0; i < rows; ++i) {
+        column->Append(i);
+    }
+
+    Block block;
+    block.AppendColumn("x", column);
+    return {block};
+}
+
+std::string Key(const Query& query) {
+    return QueryResultCache::MakeKey(query, "localhost:9000/server", "default", "user");
+}
+
+}
+
+TEST(QueryResultCacheCase, IsCacheable) {
+    EXPECT_TRUE(QueryResultCache::IsCacheable(Query("SELECT 1")));
+    EXPECT_TRUE(QueryResultCache::IsCacheable(Query("  \n select 1")));
+    EXPECT_TRUE(QueryResultCache::IsCacheable(Query("WITH 1 AS x SELECT x")));
+    EXPECT_FALSE(QueryResultCache::IsCacheable(Query("SELECTED")));
+    EXPECT_FALSE(QueryResultCache::IsCacheable(Query("INSERT INTO t SELECT 1")));
+    EXPECT_FALSE(QueryResultCache::IsCacheable(Query("SYSTEM FLUSH LOGS")));
+}
+
+TEST(QueryResultCacheCase, KeyIsNormalized) {
+    EXPECT_EQ(Key(Query("SELECT 1")), Key(Query("  SELECT\n\t 1 ;")));
+    // Whitespace inside literals matters.
+    EXPECT_NE(Key(Query("SELECT 'a  b'")), Key(Query("SELECT 'a b'")));
+    EXPECT_NE(Key(Query("SELECT 1")), Key(Query("SELECT 2")));
+    EXPECT_NE(Key(Query("SELECT 1")), QueryResultCache::MakeKey(Query("SELECT 1"), "localhost:9000/server", "other", "user"));
+    EXPECT_NE(Key(Query("SELECT 1")), QueryResultCache::MakeKey(Query("SELECT 1"), "localhost:9001/server", "default", "user"));
+
+    EXPECT_EQ(
+        Key(Query("SELECT 1").SetSetting("a", {"1"}).SetSetting("b", {"2"})),
+        Key(Query("SELECT 1").SetSetting("b", {"2"}).SetSetting("a", {"1"})));
+    EXPECT_NE(
+        Key(Query("SELECT 1").SetSetting("a", {"1"})),
+        Key(Query("SELECT 1").SetSetting("a", {"2"})));
+    EXPECT_NE(
+        Key(Query("SELECT {x:String}").SetParam("x", std::nullopt)),
+        Key(Query("SELECT {x:String}").SetParam("x", "")));
+}
+
+TEST(QueryResultCacheCase, GetPut) {
+    QueryResultCache cache;
+
+    EXPECT_EQ(nullptr, cache.Get("a"));
+    cache.Put("a", MakeBlocks(10));
+
+    const auto blocks = cache.Get("a");
+    ASSERT_NE(nullptr, blocks);
+    ASSERT_EQ(1u, blocks->size());
+    EXPECT_EQ(10u, blocks->front().GetRowCount());
+    EXPECT_EQ(1u, cache.Hits());
+    EXPECT_EQ(1u, cache.Misses());
+    EXPECT_GE(cache.Bytes(), 10 * sizeof(uint64_t));
+}
+
+TEST(QueryResultCacheCase, ExpiresAfterTTL) {
+    QueryResultCacheParams params;
+    params.ttl = 10ms;
+    QueryResultCache cache(params);
+
+    cache.Put("a", MakeBlocks(10));
+    EXPECT_NE(nullptr, cache.Get("a"));
+
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(nullptr, cache.Get("a"));
+    EXPECT_EQ(0u, cache.Size());
+    EXPECT_EQ(0u, cache.Bytes());
+}
+
+TEST(QueryResultCacheCase, EvictsLeastRecentlyUsed) {
+    QueryResultCacheParams params;
+    // Fits two results of 100 rows only.
+    params.max_bytes = 2 * 100 * sizeof(uint64_t) + 100;
+    QueryResultCache cache(params);
+
+    cache.Put("a", MakeBlocks(100));
+    cache.Put("b", MakeBlocks(100));
+    EXPECT_NE(nullptr, cache.Get("a"));
+
+    cache.Put("c", MakeBlocks(100));
+    EXPECT_EQ(2u, cache.Size());
+    EXPECT_NE(nullptr, cache.Get("a"));
+    EXPECT_EQ(nullptr, cache.Get("b"));
+    EXPECT_NE(nullptr, cache.Get("c"));
+}
+
+TEST(QueryResultCacheCase, SkipsLargeResults) {
+    QueryResultCacheParams params;
+    params.max_entry_bytes = 100;
+    QueryResultCache cache(params);
+
+    cache.Put("a", MakeBlocks(100));
+    EXPECT_EQ(nullptr, cache.Get("a"));
+    EXPECT_EQ(0u, cache.Size());
+}
+
+TEST(QueryResultCacheCase, ModificationsDontAffectCachedResult) {
+    QueryResultCache cache;
+
+    auto blocks = MakeBlocks(10);
+    const auto put = blocks.front()[0]->As<ColumnUInt64>();
+    cache.Put("a", blocks);
+    put->GetWritableData()[0] = 100;
+    put->Append(200);
+
+    const auto first = cache.Get("a");
+    ASSERT_NE(nullptr, first);
+    auto column = first->front()[0]->As<ColumnUInt64>();
+    ASSERT_EQ(10u, column->Size());
+    EXPECT_EQ(0u, column->At(0));
+    column->GetWritableData()[0] = 300;
+    column->Erase(0, 5);
+
+    const auto second = cache.Get("a");
+    ASSERT_NE(nullptr, second);
+    ASSERT_EQ(10u, second->front()[0]->Size());
+    EXPECT_EQ(0u, second->front()[0]->As<ColumnUInt64>()->At(0));
+}
@@ -3,16 +3,22 @@
 #include <clickhouse/base/socket.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <stdio.h>
 #include <string.h>
 #include <thread>
+#include <vector>
 
 // for EAI_* error codes
 #if defined(_win_)
 #   include <ws2tcpip.h>
 #else
 #   include <netdb.h>
+#   include <unistd.h>
 #endif
 
 using namespace clickhouse;
@@ -113,6 +119,43 @@ TEST(Socketcase, connecttimeout) {
     }
 }
 
+TEST(Socketcase, ConnectAnySkipsRefusedAddress) {
+    NetworkAddress refused("localhost", "19996");
+    NetworkAddress listening("localhost", "19997");
+    LocalTcpServer server(19997);
+    server.start();
+
+    size_t index = 100;
+    Socket socket = Socket::ConnectAny({&refused, &listening}, SocketTimeoutParams{}, &index);
+    EXPECT_EQ(1u, index);
+
+    server.stop();
+}
+
+TEST(Socketcase, ConnectAnyRacesBlackholedAddress) {
+    using Clock = std::chrono::steady_clock;
+
+    NetworkAddress blackholed("10.255.255.1", "19998");  // non-routable, SYN is never answered
+    NetworkAddress listening("localhost", "19999");
+    LocalTcpServer server(19999);
+    server.start();
+
+    SocketTimeoutParams timeout_params;
+    timeout_params.connect_timeout = std::chrono::seconds(5);
+    timeout_params.connection_attempt_delay = std::chrono::milliseconds(50);
+
+    const auto connect_start = Clock::now();
+    size_t index = 100;
+    Socket socket = Socket::ConnectAny({&blackholed, &listening}, timeout_params, &index);
+    const auto elapsed = Clock::now() - connect_start;
+
+    EXPECT_EQ(1u, index);
+    // Second attempt starts after the delay instead of waiting for the connect timeout of the first one.
+    EXPECT_LT(elapsed, std::chrono::seconds(1));
+
+    server.stop();
+}
+
 // Test to verify that reading from empty socket doesn't hangs.
 //TEST(Socketcase, ReadFromEmptySocket) {
 //    const int port = 12345;
@@ -129,3 +172,260 @@ TEST(Socketcase, connecttimeout) {
 //    auto input = socket.makeInputStream();
 //    input->Read(buffer, sizeof(buffer));
 //}
+
+#if defined(_linux_)
+TEST(Socketcase, ZeroCopySend) {
+    const int port = 19981;
+    const NetworkAddress addr("localhost", std::to_string(port));
+    LocalTcpServer server(port);
+    server.start();
+
+    std::vector<uint8_t> data(4 * 1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    std::vector<uint8_t> received;
+    std::thread reader([&] {
+        const int fd = server.accept();
+        ASSERT_GE(fd, 0);
+
+        uint8_t buf[64 * 1024];
+        ssize_t ret;
+        while ((ret = ::recv(fd, buf, sizeof(buf), 0)) > 0) {
+            received.insert(received.end(), buf, buf + ret);
+        }
+        close(fd);
+    });
+
+    bool zero_copy_supported = false;
+    {
+        Socket socket(addr);
+        zero_copy_supported = socket.SetZeroCopy(true);
+
+        auto output = socket.makeOutputStream();
+        size_t written = 0;
+        while (written < data.size()) {
+            written += output->Write(data.data() + written, data.size() - written);
+        }
+        // Returns only after kernel released pages of the data.
+        output->Flush();
+    }
+
+    reader.join();
+    EXPECT_EQ(data, received);
+
+    if (!zero_copy_supported) {
+        GTEST_SKIP() << "SO_ZEROCOPY is not supported, regular send() was used";
+    }
+}
+
+TEST(Socketcase, ZeroCopySendRetainsBlockUntilCompletion) {
+    LocalTcpServer server(0);
+    server.start();
+
+    // Small enough to be sent without running out of optmem, which would reap completions early.
+    auto block = std::make_shared<std::vector<uint8_t>>(4 * SocketOutput::kZeroCopyThreshold);
+    for (size_t i = 0; i < block->size(); ++i) {
+        (*block)[i] = static_cast<uint8_t>(i * 7);
+    }
+    const std::vector<uint8_t> expected = *block;
+    const std::weak_ptr<std::vector<uint8_t>> weak_block = block;
+
+    std::vector<uint8_t> received;
+    std::thread reader([&] {
+        const int fd = server.accept();
+        if (fd < 0) {
+            return;
+        }
+
+        uint8_t buf[64 * 1024];
+        ssize_t ret;
+        while ((ret = ::recv(fd, buf, sizeof(buf), 0)) > 0) {
+            received.insert(received.end(), buf, buf + ret);
+        }
+        close(fd);
+    });
+
+    bool zero_copy_supported = false;
+    bool retained_until_flush = false;
+    {
+        Socket socket(NetworkAddress("localhost", std::to_string(server.port())));
+        zero_copy_supported = socket.SetZeroCopy(true);
+
+        auto output = socket.makeOutputStream();
+        size_t written = 0;
+        while (written < block->size()) {
+            written += output->Write(block->data() + written, block->size() - written);
+        }
+
+        // Caller drops its reference before the kernel has released the pages.
+        output->Retain(block);
+        block.reset();
+        retained_until_flush = !weak_block.expired();
+
+        output->Flush();
+        EXPECT_TRUE(weak_block.expired());
+    }
+
+    reader.join();
+    EXPECT_EQ(expected, received);
+
+    if (!zero_copy_supported) {
+        GTEST_SKIP() << "SO_ZEROCOPY is not supported, regular send() was used";
+    }
+    EXPECT_TRUE(retained_until_flush);
+}
+#endif
+
+#if defined(_unix_)
+namespace {
+
+/// Counts reads from the underlying socket stream, i.e. recv() calls.
+class CountingInput : public InputStream {
+public:
+    explicit CountingInput(std::unique_ptr<InputStream> source)
+        : source_(std::move(source))
+    { }
+
+    bool Skip(size_t) override {
+        return false;
+    }
+
+    size_t reads = 0;
+
+protected:
+    size_t DoRead(void* buf, size_t len) override {
+        ++reads;
+        return source_->Read(buf, len);
+    }
+
+private:
+    std::unique_ptr<InputStream> source_;
+};
+
+}
+
+TEST(Socketcase, AdaptiveInputBufferReadsLoopbackData) {
+    const size_t size = 4 * 1024 * 1024;
+    const size_t buflen = 8192;
+    LocalTcpServer server(0);
+    server.start();
+
+    std::thread writer([&] {
+        const int fd = server.accept();
+        ASSERT_GE(fd, 0);
+
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<uint8_t>(i % 251);
+        }
+        for (size_t sent = 0; sent < size;) {
+            const ssize_t ret = ::send(fd, data.data() + sent, size - sent, 0);
+            ASSERT_GT(ret, 0);
+            sent += ret;
+        }
+        close(fd);
+    });
+
+    Socket socket(NetworkAddress("localhost", std::to_string(server.port())));
+    auto counting = std::make_unique<CountingInput>(socket.makeInputStream());
+    auto* counting_ptr = counting.get();
+    BufferedInput input(std::move(counting), buflen, 1024 * 1024);
+
+    // Small reads, like the ones made while parsing packets and columns.
+    uint8_t buf[1000];
+    size_t received = 0;
+    while (received < size) {
+        const size_t len = input.Read(buf, std::min(sizeof(buf), size - received));
+        bool matches = len > 0;
+        for (size_t i = 0; i < len && matches; ++i) {
+            matches = buf[i] == static_cast<uint8_t>((received + i) % 251);
+        }
+        if (!matches) {
+            break;
+        }
+        received += len;
+    }
+    writer.join();
+
+    EXPECT_EQ(size, received);
+
+    // A fixed 8KB buffer would need at least one recv() per 8KB.
+    EXPECT_LT(counting_ptr->reads, size / buflen);
+}
+#endif
+
+#if defined(_unix_)
+TEST(Socketcase, LargeReadFromPartialWrites) {
+    const int port = 19986;
+    const NetworkAddress addr("localhost", std::to_string(port));
+    LocalTcpServer server(port);
+    server.start();
+
+    std::vector<uint8_t> data(4 * 1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 3);
+    }
+
+    // Sends data in pieces with pauses, so reads on the other side are partial.
+    std::thread writer([&] {
+        const int fd = server.accept();
+        ASSERT_GE(fd, 0);
+
+        const size_t piece = 100 * 1000;
+        for (size_t sent = 0; sent < data.size();) {
+            const ssize_t ret = ::send(fd, data.data() + sent, std::min(piece, data.size() - sent), 0);
+            ASSERT_GT(ret, 0);
+            sent += ret;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        close(fd);
+    });
+
+    Socket socket(addr);
+    BufferedInput input(socket.makeInputStream());
+
+    std::vector<uint8_t> received(data.size());
+    // A small read first, so part of the data is taken from the buffer.
+    ASSERT_EQ(10u, input.ReadAll(received.data(), 10));
+    ASSERT_EQ(data.size() - 10, input.ReadAll(received.data() + 10, data.size() - 10));
+
+    writer.join();
+    EXPECT_EQ(data, received);
+}
+
+TEST(Socketcase, LargeReadTimeout) {
+    const int port = 19987;
+    const NetworkAddress addr("localhost", std::to_string(port));
+    LocalTcpServer server(port);
+    server.start();
+
+    // Sends only part of the data and holds the connection open.
+    std::promise<void> done;
+    std::thread writer([&] {
+        const int fd = server.accept();
+        ASSERT_GE(fd, 0);
+
+        std::vector<uint8_t> data(64 * 1024, 1);
+        ASSERT_EQ(ssize_t(data.size()), ::send(fd, data.data(), data.size(), 0));
+        done.get_future().wait();
+        close(fd);
+    });
+
+    try {
+        Socket socket(addr, SocketTimeoutParams { std::chrono::seconds(5), std::chrono::milliseconds(200), std::chrono::seconds(5) });
+        BufferedInput input(socket.makeInputStream());
+
+        std::vector<uint8_t> received(1024 * 1024);
+        input.ReadAll(received.data(), received.size());
+        ADD_FAILURE() << "ReadAll is expected to time out";
+    }
+    catch (const std::system_error& e) {
+        EXPECT_EQ(EAGAIN, e.code().value());
+    }
+
+    done.set_value();
+    writer.join();
+}
+#endif
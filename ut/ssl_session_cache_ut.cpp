@@ -0,0 +1,135 @@
+/** TLS session resumption tests, run against a local TLS server with a self-signed certificate.
+ */
+#include "tls_server.h"
+
+#include <clickhouse/base/sslsocket.h>
+
+#include <gtest/gtest.h>
+
+#include <openssl/ssl.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+using namespace clickhouse;
+
+namespace {
+
+SSLParams MakeClientParams() {
+    SSLParams params{};
+    params.use_default_ca_locations = false;
+    params.context_options = -1;
+    params.min_protocol_version = -1;
+    params.max_protocol_version = -1;
+    params.use_SNI = true;
+    params.skip_verification = true;
+    params.host_flags = -1;
+    return params;
+}
+
+/// Makes `count` connections to the server, each receives a few bytes and disconnects.
+void Connect(LocalTlsServer& server, int port, const SSLParams& params, SSLContext& context, size_t count = 1) {
+    std::thread acceptor([&] {
+        for (size_t i = 0; i < count; ++i) {
+            auto connection = server.accept();
+            ASSERT_NE(nullptr, connection);
+            ASSERT_TRUE(connection->write("hello", 5));
+            // Waits until client closes the connection.
+            char buf[16];
+            connection->read(buf, sizeof(buf));
+        }
+    });
+
+    for (size_t i = 0; i < count; ++i) {
+        SSLSocket socket(NetworkAddress("localhost", std::to_string(port)), SocketTimeoutParams{}, params, context);
+        auto input = socket.makeInputStream();
+        char buf[5];
+        // Reading also processes session tickets sent by the server after handshake (TLS 1.3).
+        EXPECT_EQ(sizeof(buf), input->ReadAll(buf, sizeof(buf)));
+    }
+
+    acceptor.join();
+}
+
+}
+
+TEST(SSLSessionCacheCase, ResumesSessionOnReconnect) {
+    const int port = 19991;
+    LocalTlsServer server(port);
+
+    const auto params = MakeClientParams();
+    auto cache = std::make_shared<SSLSessionCache>();
+    SSLContext context(params, cache);
+
+    Connect(server, port, params, context, 3);
+
+    EXPECT_EQ(1u, cache->Misses());
+    EXPECT_EQ(2u, cache->Hits());
+    EXPECT_EQ(1u, cache->Size());
+}
+
+TEST(SSLSessionCacheCase, ResumesTLS12Session) {
+    const int port = 19992;
+    LocalTlsServer server(port);
+
+    auto params = MakeClientParams();
+    params.max_protocol_version = TLS1_2_VERSION;
+    auto cache = std::make_shared<SSLSessionCache>();
+    SSLContext context(params, cache);
+
+    Connect(server, port, params, context, 3);
+
+    EXPECT_EQ(1u, cache->Misses());
+    EXPECT_EQ(2u, cache->Hits());
+}
+
+TEST(SSLSessionCacheCase, KeyedBySNI) {
+    const int port = 19993;
+    LocalTlsServer server(port);
+
+    auto params = MakeClientParams();
+    auto cache = std::make_shared<SSLSessionCache>();
+    SSLContext context(params, cache);
+
+    Connect(server, port, params, context);
+    params.server_host_name = "replica.localhost";
+    Connect(server, port, params, context);
+    EXPECT_EQ(2u, cache->Misses());
+    EXPECT_EQ(2u, cache->Size());
+
+    Connect(server, port, params, context);
+    EXPECT_EQ(1u, cache->Hits());
+}
+
+TEST(SSLSessionCacheCase, SharedBetweenContexts) {
+    const int port = 19994;
+    LocalTlsServer server(port);
+
+    const auto params = MakeClientParams();
+    auto cache = std::make_shared<SSLSessionCache>();
+
+    // Like two Clients sharing the cache.
+    SSLContext first(params, cache);
+    Connect(server, port, params, first);
+    SSLContext second(params, cache);
+    Connect(server, port, params, second);
+
+    EXPECT_EQ(1u, cache->Misses());
+    EXPECT_EQ(1u, cache->Hits());
+
+    cache->Clear();
+    Connect(server, port, params, second);
+    EXPECT_EQ(2u, cache->Misses());
+}
+
+TEST(SSLSessionCacheCase, NoCache) {
+    const int port = 19995;
+    LocalTlsServer server(port);
+
+    const auto params = MakeClientParams();
+    SSLContext context(params);
+    EXPECT_EQ(nullptr, context.getSessionCache());
+
+    Connect(server, port, params, context, 2);
+}
@@ -1,9 +1,14 @@
+#include <clickhouse/base/compressed.h>
 #include <clickhouse/base/wire_format.h>
 #include <clickhouse/base/output.h>
 #include <clickhouse/base/input.h>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 using namespace clickhouse;
 
 TEST(CodedStreamCase, Varint64) {
@@ -22,3 +27,186 @@ TEST(CodedStreamCase, Varint64) {
         ASSERT_EQ(value, 18446744071965638648ULL);
     }
 }
+
+namespace {
+
+/// Returns at most `chunk` bytes per read, counting reads.
+class ChunkedInput : public InputStream {
+public:
+    ChunkedInput(size_t size, size_t chunk)
+        : size_(size)
+        , chunk_(chunk)
+    { }
+
+    bool Skip(size_t) override {
+        return false;
+    }
+
+    size_t reads = 0;
+    /// Largest number of bytes requested by a single read.
+    size_t max_requested = 0;
+
+protected:
+    size_t DoRead(void* buf, size_t len) override {
+        max_requested = std::max(max_requested, len);
+        len = std::min({len, chunk_, size_ - position_});
+        for (size_t i = 0; i < len; ++i) {
+            static_cast<uint8_t*>(buf)[i] = static_cast<uint8_t>(position_ + i);
+        }
+        position_ += len;
+        ++reads;
+        return len;
+    }
+
+private:
+    size_t size_;
+    size_t chunk_;
+    size_t position_ = 0;
+};
+
+}
+
+TEST(BufferedInputCase, AdaptiveBufferSize) {
+    const size_t size = 16 * 1024 * 1024;
+    auto source = std::make_unique<ChunkedInput>(size, size);
+    auto* source_ptr = source.get();
+    BufferedInput input(std::move(source), 8192, 1024 * 1024);
+
+    uint8_t buf[1000];
+    for (size_t position = 0; position < size;) {
+        const size_t len = input.Read(buf, std::min(sizeof(buf), size - position));
+        ASSERT_GT(len, 0u);
+        for (size_t i = 0; i < len; ++i) {
+            ASSERT_EQ(static_cast<uint8_t>(position + i), buf[i]);
+        }
+        position += len;
+    }
+
+    EXPECT_EQ(1024u * 1024u, input.BufferSize());
+    // Fixed-size buffer would take 2048 reads.
+    EXPECT_LT(source_ptr->reads, 64u);
+}
+
+TEST(BufferedInputCase, AdaptiveBufferShrinks) {
+    const size_t size = 4 * 1024 * 1024;
+    auto source = std::make_unique<ChunkedInput>(size, size);
+    auto* source_ptr = source.get();
+    BufferedInput input(std::move(source), 8192, 1024 * 1024);
+
+    std::vector<uint8_t> buf(1024);
+    while (input.BufferSize() < 1024 * 1024) {
+        ASSERT_GT(input.Read(buf.data(), buf.size()), 0u);
+    }
+
+    // Turns source into a slow one, which returns just a few bytes per read.
+    *source_ptr = ChunkedInput(size, 16);
+    while (input.BufferSize() > 8192) {
+        ASSERT_GT(input.Read(buf.data(), buf.size()), 0u);
+    }
+}
+
+TEST(BufferedInputCase, FixedBufferSize) {
+    auto source = std::make_unique<ChunkedInput>(1024 * 1024, 1024 * 1024);
+    auto* source_ptr = source.get();
+    BufferedInput input(std::move(source), 8192);
+
+    uint8_t buf[1000];
+    while (input.Read(buf, sizeof(buf)) && source_ptr->reads < 128) {
+    }
+
+    EXPECT_EQ(8192u, input.BufferSize());
+    EXPECT_EQ(128u, source_ptr->reads);
+}
+
+TEST(BufferedInputCase, LargeReadBypassesBuffer) {
+    const size_t size = 1024 * 1024;
+    // Source returns data in small pieces, like a socket does.
+    auto source = std::make_unique<ChunkedInput>(size, 3000);
+    auto* source_ptr = source.get();
+    BufferedInput input(std::move(source), 8192);
+
+    // Small read fills the buffer.
+    uint8_t byte = 0;
+    ASSERT_TRUE(WireFormat::ReadFixed(input, &byte));
+    EXPECT_EQ(0u, byte);
+
+    std::vector<uint8_t> data(size - 1);
+    ASSERT_TRUE(WireFormat::ReadBytes(input, data.data(), data.size()));
+    for (size_t i = 0; i < data.size(); ++i) {
+        ASSERT_EQ(static_cast<uint8_t>(i + 1), data[i]) << i;
+    }
+
+    // Rest of the data after buffered part was requested directly into destination.
+    EXPECT_EQ(size - 3000, source_ptr->max_requested);
+    EXPECT_FALSE(WireFormat::ReadFixed(input, &byte));
+}
+
+TEST(BufferedInputCase, PartialReadAtEndOfStream) {
+    auto source = std::make_unique<ChunkedInput>(100 * 1024, 5000);
+    BufferedInput input(std::move(source), 8192);
+
+    std::vector<uint8_t> data(200 * 1024);
+    EXPECT_EQ(100u * 1024u, input.ReadAll(data.data(), data.size()));
+}
+
+TEST(CompressedInputCase, LargeReadDecompressesIntoDestination) {
+    std::vector<uint64_t> values(1024 * 1024);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = i * 7;
+    }
+
+    for (auto method : {CompressionMethod::LZ4, CompressionMethod::ZSTD}) {
+        Buffer buf;
+        {
+            BufferOutput output(&buf);
+            CompressedOutput compressed(&output, 65535, method);
+            WireFormat::WriteFixed(compressed, uint32_t(42));
+            WireFormat::WriteBytes(compressed, values.data(), values.size() * sizeof(values[0]));
+            compressed.Flush();
+        }
+
+        ArrayInput array(buf.data(), buf.size());
+        CompressedInput input(&array);
+
+        uint32_t header = 0;
+        ASSERT_TRUE(WireFormat::ReadFixed(input, &header));
+        EXPECT_EQ(42u, header);
+
+        std::vector<uint64_t> result(values.size());
+        ASSERT_TRUE(WireFormat::ReadBytes(input, result.data(), result.size() * sizeof(result[0])));
+        EXPECT_EQ(values, result);
+
+        uint8_t byte;
+        EXPECT_FALSE(WireFormat::ReadFixed(input, &byte));
+    }
+}
+
+TEST(CompressedInputCase, CountsStats) {
+    std::vector<uint64_t> values(100 * 1024);
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = i % 10;
+    }
+
+    ClientStats sent;
+    Buffer buf;
+    {
+        BufferOutput output(&buf);
+        CompressedOutput compressed(&output, 65535, CompressionMethod::LZ4, &sent);
+        WireFormat::WriteBytes(compressed, values.data(), values.size() * sizeof(values[0]));
+        compressed.Flush();
+    }
+    EXPECT_EQ(values.size() * sizeof(values[0]), sent.uncompressed_bytes_sent);
+    EXPECT_EQ(buf.size(), sent.compressed_bytes_sent);
+    EXPECT_LT(sent.compressed_bytes_sent, sent.uncompressed_bytes_sent);
+
+    ClientStats received;
+    ArrayInput array(buf.data(), buf.size());
+    CompressedInput input(&array, &received);
+    std::vector<uint64_t> result(values.size());
+    ASSERT_TRUE(WireFormat::ReadBytes(input, result.data(), result.size() * sizeof(result[0])));
+    EXPECT_EQ(values, result);
+
+    EXPECT_EQ(sent.compressed_bytes_sent, received.compressed_bytes_received);
+    EXPECT_EQ(sent.uncompressed_bytes_sent, received.uncompressed_bytes_received);
+    EXPECT_GT(received.decompression_ns, 0u);
+}
@@ -58,9 +58,34 @@ void LocalTcpServer::start() {
         std::cerr << "Error binding socket to local address: " << error << std::endl;
         throw std::runtime_error("Error binding socket to local address: " + std::string(error ? error : ""));
     }
+    if (port_ == 0) {
+#if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+        int len = sizeof(servAddr);
+#else
+        socklen_t len = sizeof(servAddr);
+#endif
+        if (getsockname(serverSd_, (struct sockaddr*) &servAddr, &len) < 0) {
+            throw std::runtime_error("Error getting local address of server socket");
+        }
+        port_ = ntohs(servAddr.sin_port);
+    }
     listen(serverSd_, 3);
 }
 
+int LocalTcpServer::accept() {
+    sockaddr_in clientAddr;
+#if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+    int len = sizeof(clientAddr);
+#else
+    socklen_t len = sizeof(clientAddr);
+#endif
+    return static_cast<int>(::accept(serverSd_, (struct sockaddr*) &clientAddr, &len));
+}
+
+int LocalTcpServer::port() const {
+    return port_;
+}
+
 void LocalTcpServer::stop() {
     if(serverSd_ > 0) {
 
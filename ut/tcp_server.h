@@ -9,12 +9,19 @@ class OutputStream;
 
 class LocalTcpServer {
 public:
+    /// Port 0 makes the system pick a free port, see port().
     LocalTcpServer(int port);
     ~LocalTcpServer();
 
     void start();
     void stop();
 
+    /// Blocks until a client connects, returns descriptor of the accepted socket or -1 on error.
+    int accept();
+
+    /// Port the server listens on, valid after start().
+    int port() const;
+
 private:
 
     int port_;
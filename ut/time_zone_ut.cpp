@@ -0,0 +1,304 @@
+#include <clickhouse/base/time_zone.h>
+#include <clickhouse/columns/date.h>
+#include <clickhouse/exceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace clickhouse;
+
+namespace {
+
+void AppendBigEndian(std::string& data, uint64_t value, size_t bytes) {
+    for (size_t i = bytes; i > 0; --i) {
+        data += static_cast<char>(value >> (8 * (i - 1)) & 0xFF);
+    }
+}
+
+/// TZif version 2 data with given transitions (UTC time and index of offset) and footer.
+std::string MakeTZif(const std::vector<std::pair<int64_t, uint8_t>>& transitions, const std::vector<int32_t>& offsets,
+    const std::string& footer)
+{
+    std::string data;
+    for (size_t time_size : {4, 8}) {
+        data += "TZif2";
+        data.append(15, '\0');
+        for (size_t count : {size_t(0), size_t(0), size_t(0), transitions.size(), offsets.size(), size_t(4)}) {
+            AppendBigEndian(data, count, 4);
+        }
+        for (const auto& transition : transitions) {
+            AppendBigEndian(data, static_cast<uint64_t>(transition.first), time_size);
+        }
+        for (const auto& transition : transitions) {
+            data += static_cast<char>(transition.second);
+        }
+        for (int32_t offset : offsets) {
+            AppendBigEndian(data, static_cast<uint32_t>(offset), 4);
+            data += '\0';
+            data += '\0';
+        }
+        data.append("XXX", 4);
+    }
+    return data + "\n" + footer + "\n";
+}
+
+/// Seconds since UNIX epoch of UTC time.
+int64_t Unix(int year, int month, int day, int hour = 0, int minute = 0, int second = 0) {
+    std::tm tm{};
+    tm.tm_year = year - 1900;
+    tm.tm_mon = month - 1;
+    tm.tm_mday = day;
+    tm.tm_hour = hour;
+    tm.tm_min = minute;
+    tm.tm_sec = second;
+#if defined(_WIN32)
+    return _mkgmtime(&tm);
+#else
+    return timegm(&tm);
+#endif
+}
+
+/// Midnight of the last Sunday of the month in UTC.
+int64_t LastSunday(int year, int month) {
+    for (int day = 31;; --day) {
+        const int64_t time = Unix(year, month, day);
+        // 1970-01-01 is Thursday.
+        if (CivilTimeFromUnix(time).month == month && ((time / 86400 + 4) % 7 + 7) % 7 == 0) {
+            return time;
+        }
+    }
+}
+
+std::string Format(const CivilTime& time, size_t fraction_digits = 0) {
+    char buffer[kMaxFormattedDateTimeLength];
+    return std::string(buffer, FormatDateTime(time, fraction_digits, buffer));
+}
+
+}
+
+TEST(TimeZoneCase, CivilTimeFromUnix) {
+    EXPECT_EQ("1970-01-01 00:00:00", Format(CivilTimeFromUnix(0)));
+    EXPECT_EQ("1969-12-31 23:59:59", Format(CivilTimeFromUnix(-1)));
+    EXPECT_EQ("2000-02-29 12:34:56", Format(CivilTimeFromUnix(Unix(2000, 2, 29, 12, 34, 56))));
+    EXPECT_EQ("2106-02-07 06:28:15", Format(CivilTimeFromUnix(0xFFFFFFFF)));
+    EXPECT_EQ("1900-01-01 00:00:00", Format(CivilTimeFromUnix(Unix(1900, 1, 1))));
+    EXPECT_EQ("2299-12-31 23:59:59", Format(CivilTimeFromUnix(Unix(2299, 12, 31, 23, 59, 59))));
+
+    // Every day of a few 400-year cycles matches timegm().
+    for (int64_t days = -150000; days < 150000; days += 7) {
+        const auto time = CivilTimeFromUnix(days * 86400);
+        ASSERT_EQ(days * 86400, Unix(time.year, time.month, time.day));
+    }
+}
+
+TEST(TimeZoneCase, Format) {
+    CivilTime time;
+    time.year = 2024;
+    time.month = 3;
+    time.day = 9;
+    time.hour = 7;
+    time.minute = 5;
+    time.second = 3;
+    time.nanosecond = 12345678;
+
+    char buffer[kMaxFormattedDateTimeLength];
+    EXPECT_EQ("2024-03-09", std::string(buffer, FormatDate(time, buffer)));
+    EXPECT_EQ("2024-03-09 07:05:03", Format(time));
+    EXPECT_EQ("2024-03-09 07:05:03.012", Format(time, 3));
+    EXPECT_EQ("2024-03-09 07:05:03.012345678", Format(time, 9));
+
+    time.year = 12345;
+    EXPECT_EQ("12345-03-09", std::string(buffer, FormatDate(time, buffer)));
+    time.year = -1;
+    EXPECT_EQ("-0001-03-09", std::string(buffer, FormatDate(time, buffer)));
+}
+
+TEST(TimeZoneCase, UTC) {
+    const auto utc = TimeZone::Get("");
+    EXPECT_EQ(utc, TimeZone::Get("UTC"));
+    EXPECT_EQ("UTC", utc->Name());
+    EXPECT_EQ(0, utc->UtcOffset(Unix(2024, 7, 1)));
+    EXPECT_EQ(CivilTimeFromUnix(123456789), utc->ToCivil(123456789));
+}
+
+TEST(TimeZoneCase, PosixRule) {
+    // Footer only, as in "slim" TZif files: Central European Time.
+    const auto zone = TimeZone::FromTZif("CET", MakeTZif({}, {3600}, "CET-1CEST,M3.5.0,M10.5.0/3"));
+
+    for (int year : {1975, 2021, 2024, 2299}) {
+        SCOPED_TRACE(year);
+        // Last Sundays of March and October at 01:00 UTC.
+        const int64_t start = LastSunday(year, 3) + 3600;
+        const int64_t end = LastSunday(year, 10) + 3600;
+        EXPECT_EQ(3600, zone->UtcOffset(start - 1));
+        EXPECT_EQ(7200, zone->UtcOffset(start));
+        EXPECT_EQ(7200, zone->UtcOffset(end - 1));
+        EXPECT_EQ(3600, zone->UtcOffset(end));
+        EXPECT_EQ(3600, zone->UtcOffset(Unix(year, 1, 1)));
+    }
+
+    // 2021-03-28 01:00:00 UTC is 03:00:00 CEST.
+    EXPECT_EQ("2021-03-28 03:00:00", Format(zone->ToCivil(Unix(2021, 3, 28, 1))));
+    EXPECT_EQ(7200, zone->ToCivil(Unix(2021, 3, 28, 1)).utc_offset);
+}
+
+TEST(TimeZoneCase, Transitions) {
+    // +03:00 until 2011-03-26 23:00:00 UTC, +04:00 until 2014-10-25 22:00:00 UTC, then +03:00 with no DST.
+    const auto zone = TimeZone::FromTZif("Test",
+        MakeTZif({{Unix(2011, 3, 26, 23), 1}, {Unix(2014, 10, 25, 22), 0}}, {10800, 14400}, "<+03>-3"));
+
+    EXPECT_EQ(10800, zone->UtcOffset(Unix(1950, 1, 1)));
+    EXPECT_EQ(10800, zone->UtcOffset(Unix(2011, 3, 26, 23) - 1));
+    EXPECT_EQ(14400, zone->UtcOffset(Unix(2011, 3, 26, 23)));
+    EXPECT_EQ(14400, zone->UtcOffset(Unix(2014, 10, 25, 22) - 1));
+    EXPECT_EQ(10800, zone->UtcOffset(Unix(2014, 10, 25, 22)));
+    EXPECT_EQ(10800, zone->UtcOffset(Unix(2200, 1, 1)));
+
+    // The hint gives the same results for values in any order.
+    size_t hint = 0;
+    for (int64_t time : {Unix(2012, 1, 1), Unix(2013, 1, 1), Unix(1990, 1, 1), Unix(2020, 1, 1), Unix(2012, 6, 1)}) {
+        EXPECT_EQ(zone->ToCivil(time), zone->ToCivil(time, hint));
+    }
+}
+
+TEST(TimeZoneCase, Errors) {
+    EXPECT_THROW(TimeZone::FromTZif("Test", "TZif"), ValidationError);
+    EXPECT_THROW(TimeZone::FromTZif("Test", MakeTZif({}, {3600}, "CET-1CEST,M3.5.0")), ValidationError);
+    EXPECT_THROW(TimeZone::Get("../../etc/passwd"), ValidationError);
+    EXPECT_THROW(TimeZone::Get("Nowhere/Nothing"), ValidationError);
+}
+
+#if !defined(_WIN32)
+TEST(TimeZoneCase, MatchesLibc) {
+    const std::vector<std::string> zones = {
+        "Europe/Moscow", "America/New_York", "Australia/Lord_Howe", "Europe/Dublin", "Asia/Kolkata", "America/Santiago"};
+
+    const char* old_tz = std::getenv("TZ");
+    const std::string saved = old_tz ? old_tz : "";
+
+    for (const auto& name : zones) {
+        SCOPED_TRACE(name);
+        std::shared_ptr<const TimeZone> zone;
+        try {
+            zone = TimeZone::Get(name);
+        } catch (const ValidationError&) {
+            continue;
+        }
+        EXPECT_EQ(zone, TimeZone::Get(name));
+
+        setenv("TZ", name.c_str(), 1);
+        tzset();
+
+        size_t hint = 0;
+        // 1970..2037, so time_t and libc behave the same on all platforms.
+        for (int64_t time = 0; time < Unix(2037, 12, 31); time += 3 * 3600 + 17) {
+            const std::time_t t = static_cast<std::time_t>(time);
+            std::tm tm{};
+            localtime_r(&t, &tm);
+
+            const auto civil = zone->ToCivil(time, hint);
+            ASSERT_EQ(tm.tm_gmtoff, civil.utc_offset) << time;
+            ASSERT_EQ(tm.tm_year + 1900, civil.year) << time;
+            ASSERT_EQ(tm.tm_mon + 1, civil.month) << time;
+            ASSERT_EQ(tm.tm_mday, civil.day) << time;
+            ASSERT_EQ(tm.tm_hour, civil.hour) << time;
+            ASSERT_EQ(tm.tm_min, civil.minute) << time;
+            ASSERT_EQ(tm.tm_sec, civil.second) << time;
+        }
+    }
+
+    if (old_tz) {
+        setenv("TZ", saved.c_str(), 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+}
+#endif
+
+TEST(TimeZoneCase, DateColumns) {
+    ColumnDate date;
+    date.AppendRaw(0);
+    date.AppendRaw(19000);
+
+    std::string arena;
+    std::vector<std::string_view> strings;
+    date.ToStrings(arena, strings);
+    EXPECT_EQ((std::vector<std::string_view>{"1970-01-01", "2022-01-08"}), strings);
+
+    ColumnDate32 date32;
+    date32.AppendRaw(-25567);
+    date32.AppendRaw(-1);
+    date32.AppendRaw(120529);
+
+    std::vector<CivilTime> times;
+    date32.ToCivilTimes(times);
+    ASSERT_EQ(3u, times.size());
+    EXPECT_EQ(1900, times[0].year);
+    EXPECT_EQ(1, times[0].month);
+    EXPECT_EQ(1, times[0].day);
+
+    date32.ToStrings(arena, strings);
+    EXPECT_EQ((std::vector<std::string_view>{"1900-01-01", "1969-12-31", "2299-12-31"}), strings);
+}
+
+TEST(TimeZoneCase, DateTimeColumns) {
+    const auto zone = TimeZone::FromTZif("Test", MakeTZif({{Unix(2020, 1, 1), 1}}, {0, 10800}, "<+03>-3"));
+
+    ColumnDateTime datetime;
+    datetime.Append(Unix(2019, 12, 31, 23, 59, 59));
+    datetime.Append(Unix(2020, 1, 1));
+
+    std::string arena;
+    std::vector<std::string_view> strings;
+    datetime.ToStrings(arena, strings);
+    EXPECT_EQ((std::vector<std::string_view>{"2019-12-31 23:59:59", "2020-01-01 00:00:00"}), strings);
+    datetime.ToStrings(*zone, arena, strings);
+    EXPECT_EQ((std::vector<std::string_view>{"2019-12-31 23:59:59", "2020-01-01 03:00:00"}), strings);
+
+    std::vector<CivilTime> times;
+    datetime.ToCivilTimes(*zone, times);
+    ASSERT_EQ(2u, times.size());
+    EXPECT_EQ(0, times[0].utc_offset);
+    EXPECT_EQ(10800, times[1].utc_offset);
+
+    ColumnDateTime64 datetime64(3);
+    datetime64.Append(Unix(2020, 1, 1) * 1000 + 5);
+    // Sub-second part of values before the epoch is rounded down.
+    datetime64.Append(-1);
+    datetime64.Append(Unix(1900, 1, 1) * 1000 + 999);
+
+    datetime64.ToCivilTimes(*zone, times);
+    ASSERT_EQ(3u, times.size());
+    EXPECT_EQ(5000000u, times[0].nanosecond);
+    EXPECT_EQ(999000000u, times[1].nanosecond);
+
+    datetime64.ToStrings(*zone, arena, strings);
+    EXPECT_EQ((std::vector<std::string_view>{"2020-01-01 03:00:00.005", "1969-12-31 23:59:59.999", "1900-01-01 00:00:00.999"}), strings);
+}
+
+TEST(TimeZoneCase, ColumnTimezone) {
+    std::shared_ptr<const TimeZone> zone;
+    try {
+        zone = TimeZone::Get("Asia/Kolkata");
+    } catch (const ValidationError&) {
+        GTEST_SKIP() << "tz database is not available";
+    }
+
+    ColumnDateTime datetime("Asia/Kolkata");
+    datetime.Append(Unix(2024, 1, 1));
+
+    std::string arena;
+    std::vector<std::string_view> strings;
+    datetime.ToStrings(arena, strings);
+    EXPECT_EQ((std::vector<std::string_view>{"2024-01-01 05:30:00"}), strings);
+
+    ColumnDateTime64 datetime64(6, "Asia/Kolkata");
+    datetime64.Append(Unix(2024, 1, 1) * 1000000 + 123456);
+    datetime64.ToStrings(arena, strings);
+    EXPECT_EQ((std::vector<std::string_view>{"2024-01-01 05:30:00.123456"}), strings);
+}
@@ -0,0 +1,132 @@
+#include "tls_server.h"
+
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+#   include <winsock2.h>
+#else
+#   include <unistd.h>
+#endif
+
+namespace clickhouse {
+
+namespace {
+
+EVP_PKEY* makeKey() {
+    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), &EVP_PKEY_CTX_free);
+    EVP_PKEY* key = nullptr;
+    if (!ctx
+        || EVP_PKEY_keygen_init(ctx.get()) <= 0
+        || EVP_PKEY_CTX_set_ec_paramgen_curve_nid(ctx.get(), NID_X9_62_prime256v1) <= 0
+        || EVP_PKEY_keygen(ctx.get(), &key) <= 0) {
+        throw std::runtime_error("Failed to generate private key");
+    }
+    return key;
+}
+
+X509* makeSelfSignedCertificate(EVP_PKEY* key) {
+    std::unique_ptr<X509, decltype(&X509_free)> cert(X509_new(), &X509_free);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 3600);
+    X509_set_pubkey(cert.get(), key);
+
+    X509_NAME* name = X509_get_subject_name(cert.get());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert.get(), name);
+
+    if (!X509_sign(cert.get(), key, EVP_sha256())) {
+        throw std::runtime_error("Failed to sign certificate");
+    }
+    return cert.release();
+}
+
+void closeSocket(int fd) {
+#if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+    closesocket(fd);
+#else
+    close(fd);
+#endif
+}
+
+}
+
+LocalTlsConnection::LocalTlsConnection(int fd, SSL* ssl)
+    : fd_(fd)
+    , ssl_(ssl)
+{}
+
+LocalTlsConnection::~LocalTlsConnection() {
+    SSL_shutdown(ssl_);
+    SSL_free(ssl_);
+    closeSocket(fd_);
+}
+
+bool LocalTlsConnection::write(const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        const int chunk = static_cast<int>(std::min<size_t>(len, 1 << 30));
+        const int ret = SSL_write(ssl_, p, chunk);
+        if (ret <= 0) {
+            return false;
+        }
+        p += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+size_t LocalTlsConnection::read(void* buf, size_t len) {
+    const int ret = SSL_read(ssl_, buf, static_cast<int>(std::min<size_t>(len, 1 << 30)));
+    return ret > 0 ? static_cast<size_t>(ret) : 0;
+}
+
+LocalTlsServer::LocalTlsServer(int port, bool use_ktls)
+    : tcp_server_(port)
+    , context_(SSL_CTX_new(TLS_server_method()))
+    , key_(makeKey())
+    , cert_(makeSelfSignedCertificate(key_))
+{
+    SSL_CTX_use_certificate(context_, cert_);
+    SSL_CTX_use_PrivateKey(context_, key_);
+#if defined(SSL_OP_ENABLE_KTLS)
+    if (use_ktls) {
+        SSL_CTX_set_options(context_, SSL_OP_ENABLE_KTLS);
+    }
+#else
+    (void)use_ktls;
+#endif
+    tcp_server_.start();
+}
+
+LocalTlsServer::~LocalTlsServer() {
+    X509_free(cert_);
+    EVP_PKEY_free(key_);
+    SSL_CTX_free(context_);
+}
+
+int LocalTlsServer::port() const {
+    return tcp_server_.port();
+}
+
+std::unique_ptr<LocalTlsConnection> LocalTlsServer::accept() {
+    const int fd = tcp_server_.accept();
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    SSL* ssl = SSL_new(context_);
+    SSL_set_fd(ssl, fd);
+    auto connection = std::make_unique<LocalTlsConnection>(fd, ssl);
+    if (SSL_accept(ssl) != 1) {
+        return nullptr;
+    }
+    return connection;
+}
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "tcp_server.h"
+
+#include <cstddef>
+#include <memory>
+
+typedef struct ssl_ctx_st SSL_CTX;
+typedef struct ssl_st SSL;
+typedef struct evp_pkey_st EVP_PKEY;
+typedef struct x509_st X509;
+
+namespace clickhouse {
+
+/// Server side of a TLS connection accepted by LocalTlsServer.
+class LocalTlsConnection {
+public:
+    LocalTlsConnection(int fd, SSL* ssl);
+    ~LocalTlsConnection();
+
+    LocalTlsConnection(const LocalTlsConnection&) = delete;
+    LocalTlsConnection& operator=(const LocalTlsConnection&) = delete;
+
+    /// Writes all the data, returns false on error.
+    bool write(const void* data, size_t len);
+    /// Reads some data, returns number of bytes read or 0 on error.
+    size_t read(void* buf, size_t len);
+
+private:
+    int fd_;
+    SSL* ssl_;
+};
+
+/// TLS server on localhost with a self-signed certificate for `localhost`, generated on start.
+class LocalTlsServer {
+public:
+    /// Port 0 makes the system pick a free port, see port().
+    explicit LocalTlsServer(int port, bool use_ktls = false);
+    ~LocalTlsServer();
+
+    int port() const;
+
+    /// Blocks until a client connects and completes handshake, returns null on error.
+    std::unique_ptr<LocalTlsConnection> accept();
+
+private:
+    LocalTcpServer tcp_server_;
+    SSL_CTX* context_;
+    EVP_PKEY* key_;
+    X509* cert_;
+};
+
+}
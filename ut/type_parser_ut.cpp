@@ -309,6 +309,27 @@ TEST(TypeParserCase, ParseDecimal128) {
     ASSERT_EQ(ast.elements[0].value, 3);
 }
 
+TEST(TypeParserCase, ParseDecimal256) {
+    TypeAst ast;
+    TypeParser("Decimal256(40)").Parse(&ast);
+    ASSERT_EQ(ast.meta, TypeAst::Terminal);
+    ASSERT_EQ(ast.name, "Decimal256");
+    ASSERT_EQ(ast.code, Type::Decimal256);
+    ASSERT_EQ(ast.elements.size(), 1u);
+    ASSERT_EQ(ast.elements[0].value, 40);
+}
+
+TEST(TypeParserCase, ParseInt256) {
+    TypeAst ast;
+    TypeParser("Int256").Parse(&ast);
+    ASSERT_EQ(ast.meta, TypeAst::Terminal);
+    ASSERT_EQ(ast.code, Type::Int256);
+
+    TypeParser("UInt256").Parse(&ast);
+    ASSERT_EQ(ast.meta, TypeAst::Terminal);
+    ASSERT_EQ(ast.code, Type::UInt256);
+}
+
 TEST(TypeParserCase, ParseDateTime_NO_TIMEZONE) {
     TypeAst ast;
     TypeParser("DateTime").Parse(&ast);
@@ -0,0 +1,164 @@
+#include "tcp_server.h"
+
+#include <clickhouse/base/uring_socket.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace clickhouse;
+
+namespace {
+
+std::unique_ptr<IoUringSocket> Connect(const NetworkAddress& addr, const SocketTimeoutParams& timeout_params, const IoUringParams& params) {
+    try {
+        return std::make_unique<IoUringSocket>(addr, timeout_params, params);
+    } catch (const std::system_error&) {
+        return nullptr;
+    }
+}
+
+/// Writes 1MB to an echo peer in portions of `sizes`, repeated in a loop, and checks that the same data comes back.
+void EchoRoundTrip(const IoUringParams& params, const std::vector<size_t>& sizes, bool flush_each_write) {
+    LocalTcpServer server(0);
+    server.start();
+    const NetworkAddress addr("localhost", std::to_string(server.port()));
+
+    std::vector<uint8_t> data(1024 * 1024 + 17);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 13);
+    }
+
+    auto socket = Connect(addr, SocketTimeoutParams{}, params);
+    if (!socket) {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+
+    // Receives all the data first and only then sends it back,
+    // so neither side blocks on a full socket buffer.
+    std::thread echo([&] {
+        const int fd = server.accept();
+        ASSERT_GE(fd, 0);
+        // Small receive window makes partial writes on the client side more likely.
+        const int rcvbuf = 4096;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        std::vector<uint8_t> buf(data.size());
+        size_t total = 0;
+        ssize_t ret;
+        while (total < buf.size() && (ret = ::recv(fd, buf.data() + total, buf.size() - total, 0)) > 0) {
+            total += ret;
+        }
+        for (size_t sent = 0; sent < total;) {
+            const ssize_t n = ::send(fd, buf.data() + sent, total - sent, 0);
+            ASSERT_GT(n, 0);
+            sent += n;
+        }
+        close(fd);
+    });
+
+    std::vector<uint8_t> received(data.size());
+    {
+        auto output = socket->makeOutputStream();
+        auto input = socket->makeInputStream();
+
+        size_t written = 0;
+        for (size_t i = 0; written < data.size(); ++i) {
+            const size_t len = std::min(sizes[i % sizes.size()], data.size() - written);
+            written += output->Write(data.data() + written, len);
+            if (flush_each_write) {
+                output->Flush();
+            }
+        }
+        output->Flush();
+
+        size_t read = 0;
+        while (read < received.size()) {
+            const size_t n = input->Read(received.data() + read, received.size() - read);
+            ASSERT_GT(n, 0u);
+            read += n;
+        }
+    }
+    socket.reset();
+
+    echo.join();
+    EXPECT_EQ(data, received);
+}
+
+}
+
+TEST(IoUringSocketCase, RegisteredBuffers) {
+    // Growing writes, from buffered to direct ones.
+    EchoRoundTrip(IoUringParams{}, {1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144}, true);
+}
+
+TEST(IoUringSocketCase, LinkedWrites) {
+    IoUringParams params;
+    params.buffer_size = 4 * 1024;
+    // Large writes go after buffered small ones in the same linked chain,
+    // a partial write of the buffered part cancels the rest of the chain, which is resubmitted.
+    EchoRoundTrip(params, {100, 3000, 7, 70000, 1500, 2100, 300000}, false);
+}
+
+TEST(IoUringSocketCase, ReceiveTimeout) {
+    LocalTcpServer server(0);
+    server.start();
+    const NetworkAddress addr("localhost", std::to_string(server.port()));
+
+    SocketTimeoutParams timeout_params;
+    timeout_params.recv_timeout = std::chrono::milliseconds(200);
+    auto socket = Connect(addr, timeout_params, IoUringParams{});
+    if (!socket) {
+        GTEST_SKIP() << "io_uring is not available";
+    }
+
+    std::promise<void> timed_out;
+    std::thread peer([&] {
+        const int fd = server.accept();
+        ASSERT_GE(fd, 0);
+        // Silent until the client gives up waiting, then sends a few bytes.
+        timed_out.get_future().wait();
+        EXPECT_EQ(4, ::send(fd, "ping", 4, 0));
+        char buf[1];
+        ::recv(fd, buf, sizeof(buf), 0);
+        close(fd);
+    });
+
+    auto input = socket->makeInputStream();
+    char buf[4] = {};
+    const auto started = std::chrono::steady_clock::now();
+    try {
+        input->Read(buf, sizeof(buf));
+        ADD_FAILURE() << "read from silent peer must time out";
+    } catch (const std::system_error& e) {
+        EXPECT_EQ(EAGAIN, e.code().value());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(2));
+    timed_out.set_value();
+
+    // Cancelled receive neither consumes data nor leaves its completion to the next one.
+    size_t read = 0;
+    try {
+        while (read < sizeof(buf)) {
+            const size_t n = input->Read(buf + read, sizeof(buf) - read);
+            if (n == 0) {
+                break;
+            }
+            read += n;
+        }
+    } catch (const std::system_error& e) {
+        ADD_FAILURE() << e.what();
+    }
+    socket.reset();
+
+    peer.join();
+    EXPECT_EQ(std::string("ping"), std::string(buf, read));
+}
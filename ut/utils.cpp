@@ -439,6 +439,13 @@ std::ostream& operator<<(std::ostream& ostr, const ItemView& item_view) {
         case Type::UInt128:
             ostr << item_view.get<UInt128>();
             break;
+        case Type::Int256:
+        case Type::Decimal256:
+            ostr << item_view.get<Int256>();
+            break;
+        case Type::UInt256:
+            ostr << item_view.get<UInt256>();
+            break;
         case Type::Decimal: {
             if (item_view.data.size() == sizeof(int32_t)) {
                 ostr << item_view.get<int32_t>();
@@ -449,6 +456,9 @@ std::ostream& operator<<(std::ostream& ostr, const ItemView& item_view) {
             else if (item_view.data.size() == sizeof(Int128)) {
                 ostr << item_view.get<Int128>();
             }
+            else if (item_view.data.size() == sizeof(Int256)) {
+                ostr << item_view.get<Int256>();
+            }
             else {
                 throw std::runtime_error("Invalid data size of ItemView of type Decimal");
             }
@@ -130,6 +130,27 @@ std::vector<clickhouse::UInt128> MakeUInt128s() {
     };
 }
 
+std::vector<clickhouse::Int256> MakeInt256s() {
+    return {
+        Bignum::StringToInt256("-1"),
+        Bignum::StringToInt256("18446744073709551615"),  // 2^64 - 1
+        Bignum::StringToInt256("340282366920938463463374607431768211456"),  // 2^128
+        Bignum::StringToInt256("-57896044618658097711785492504343953926634992332820282019728792003956564819968"),  // min
+        Bignum::StringToInt256("57896044618658097711785492504343953926634992332820282019728792003956564819967"),  // max
+        Int256(0)
+    };
+}
+
+std::vector<clickhouse::UInt256> MakeUInt256s() {
+    return {
+        Bignum::StringToUInt256("115792089237316195423570985008687907853269984665640564039457584007913129639935"),  // 2^256 - 1
+        Bignum::StringToUInt256("18446744073709551615"),  // 2^64 - 1
+        Bignum::StringToUInt256("340282366920938463463374607431768211456"),  // 2^128
+        Bignum::StringToUInt256("57896044618658097711785492504343953926634992332820282019728792003956564819968"),  // 2^255
+        UInt256(0)
+    };
+}
+
 std::vector<int32_t> MakeTime() {
     std::vector<int32_t> values{
         1,       // 1 second
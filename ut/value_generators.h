@@ -44,6 +44,8 @@ std::vector<in6_addr> MakeIPv6s();
 std::vector<clickhouse::UUID> MakeUUIDs();
 std::vector<clickhouse::Int128> MakeInt128s();
 std::vector<clickhouse::UInt128> MakeUInt128s();
+std::vector<clickhouse::Int256> MakeInt256s();
+std::vector<clickhouse::UInt256> MakeUInt256s();
 std::vector<clickhouse::Int128> MakeDecimals(size_t precision, size_t scale);
 
 template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>